@@ -43,6 +43,7 @@
 #include "borg-light.h"
 #include "borg-magic.h"
 #include "borg-messages-react.h"
+#include "borg-perf.h"
 #include "borg-prepared.h"
 #include "borg-projection.h"
 #include "borg-store-sell.h"
@@ -796,7 +797,7 @@ static bool borg_heal(int danger)
  *     if borg is correctly positioned in a good room.
  * 5.  Stay put and rest until Morgoth returns.
  */
-bool borg_caution(void)
+static bool borg_caution_aux(void)
 {
     int  j, pos_danger;
     bool borg_surround = false;
@@ -2028,4 +2029,16 @@ bool borg_caution(void)
     return false;
 }
 
+/*
+ * L: Be cautious, timed when the borg is being profiled
+ */
+bool borg_caution(void)
+{
+    uint64_t start = borg_perf_start();
+    bool     done  = borg_caution_aux();
+
+    borg_perf_stop(BORG_PERF_CAUTION, start);
+    return done;
+}
+
 #endif
@@ -30,6 +30,7 @@
 #include "borg-flow-glyph.h"
 #include "borg-flow-kill.h"
 #include "borg-magic.h"
+#include "borg-perf.h"
 #include "borg-projection.h"
 #include "borg-trait.h"
 #include "borg.h"
@@ -49,6 +50,195 @@ uint16_t borg_fear_monsters[AUTO_MAX_Y + 1][AUTO_MAX_X + 1];
  */
 bool borg_danger_wipe = false;
 
+/*
+ * L: Cache of the danger each monster poses to a grid, so that asking about
+ * the same grid again in one turn's thinking is a lookup.
+ *
+ * An entry holds what borg_danger_one_kill() said for one monster, grid,
+ * turn multiplier and pair of flags.  It is good while the borg's own state
+ * matches the epoch it was worked out in, and while that monster hasn't
+ * changed since.  The borg's state is compared against a few remembered
+ * snapshots, so that simulations which flip a flag and flip it back find
+ * their earlier answers again.  A monster that changes invalidates its own
+ * entries, unless it moved, since where monsters stand bounds where others
+ * can step.
+ */
+#define DANGER_CACHE_BITS 14
+#define DANGER_CACHE_SIZE (1 << DANGER_CACHE_BITS)
+#define DANGER_STATE_SLOTS 4
+
+struct borg_danger_entry {
+    uint32_t key;
+    uint32_t epoch;
+    uint16_t kill_gen;
+    int16_t  danger;
+};
+
+/* L: what borg_danger_one_kill() reads of the borg and its simulations */
+struct borg_danger_state {
+    int         trait[BI_MAX];
+    struct temp temp;
+    int16_t     stat_cur[STAT_MAX];
+    int16_t     stat_ind[STAT_MAX];
+    struct loc  c;
+    int         tp_other_index[255];
+    int16_t     tp_other_n;
+    int16_t     glyphs;
+    int         fighting_unique;
+    bool        stressed;
+    bool        attacking;
+    bool        slow_spell;
+    bool        sleep_spell;
+    bool        sleep_spell_ii;
+    bool        crush_spell;
+    bool        confuse_spell;
+    bool        fear_mon_spell;
+    bool        on_glyph;
+    bool        create_door;
+    bool        morgoth_position;
+    bool        as_position;
+};
+
+/* L: what borg_danger_one_kill() reads of a monster */
+struct borg_danger_kill {
+    struct loc   pos;
+    unsigned int r_idx;
+    int16_t      power;
+    int16_t      injury;
+    int16_t      level;
+    uint8_t      speed;
+    uint8_t      ranged_attack;
+    bool         awake;
+    bool         confused;
+    bool         afraid;
+    bool         stunned;
+};
+
+static struct borg_danger_entry danger_cache[DANGER_CACHE_SIZE];
+static struct borg_danger_state danger_states[DANGER_STATE_SLOTS];
+static uint32_t danger_state_epoch[DANGER_STATE_SLOTS];
+static int danger_state_cur;
+static uint32_t danger_epoch_next = 1;
+static struct borg_danger_kill danger_kills[256];
+static uint16_t danger_kill_gen[256];
+static struct borg_danger_cache_counts danger_counts;
+
+/*
+ * L: Forget every cached danger, such as when the map has been read again
+ */
+void borg_danger_cache_wipe(void)
+{
+    int i;
+
+    for (i = 0; i < DANGER_STATE_SLOTS; i++)
+        danger_state_epoch[i] = 0;
+    danger_counts.wipes++;
+}
+
+/*
+ * L: Get the counts kept by the danger cache
+ */
+const struct borg_danger_cache_counts *borg_danger_cache_counts(void)
+{
+    return &danger_counts;
+}
+
+/*
+ * L: Find the epoch matching the borg's state now, starting a new one if
+ * none of the remembered snapshots match
+ */
+static uint32_t borg_danger_epoch(void)
+{
+    struct borg_danger_state now;
+    int i;
+
+    memset(&now, 0, sizeof(now));
+    memcpy(now.trait, borg.trait, sizeof(now.trait));
+    memcpy(&now.temp, &borg.temp, sizeof(now.temp));
+    memcpy(now.stat_cur, borg.stat_cur, sizeof(now.stat_cur));
+    memcpy(now.stat_ind, borg.stat_ind, sizeof(now.stat_ind));
+    now.c          = borg.c;
+    now.tp_other_n = borg_tp_other_n;
+    for (i = 1; i <= borg_tp_other_n && i < 255; i++)
+        now.tp_other_index[i] = borg_tp_other_index[i];
+    now.glyphs           = track_glyph.num;
+    now.fighting_unique  = borg_fighting_unique;
+    now.stressed         = borg.time_this_panel > 1200 || borg_t > 25000;
+    now.attacking        = borg_attacking;
+    now.slow_spell       = borg_slow_spell;
+    now.sleep_spell      = borg_sleep_spell;
+    now.sleep_spell_ii   = borg_sleep_spell_ii;
+    now.crush_spell      = borg_crush_spell;
+    now.confuse_spell    = borg_confuse_spell;
+    now.fear_mon_spell   = borg_fear_mon_spell;
+    now.on_glyph         = borg_on_glyph;
+    now.create_door      = borg_create_door;
+    now.morgoth_position = borg_morgoth_position;
+    now.as_position      = borg_as_position;
+
+    /* Usually nothing has changed since the last call */
+    if (danger_state_epoch[danger_state_cur]
+        && !memcmp(&now, &danger_states[danger_state_cur], sizeof(now)))
+        return danger_state_epoch[danger_state_cur];
+
+    /* A state seen a little while ago */
+    for (i = 0; i < DANGER_STATE_SLOTS; i++) {
+        if (danger_state_epoch[i]
+            && !memcmp(&now, &danger_states[i], sizeof(now))) {
+            danger_state_cur = i;
+            return danger_state_epoch[i];
+        }
+    }
+
+    /* A new state takes the next slot round */
+    danger_state_cur = (danger_state_cur + 1) % DANGER_STATE_SLOTS;
+    danger_states[danger_state_cur] = now;
+
+    /* Entries from before a wrap could look current, so drop them all */
+    if (!danger_epoch_next) {
+        memset(danger_cache, 0, sizeof(danger_cache));
+        danger_epoch_next = 1;
+    }
+    danger_state_epoch[danger_state_cur] = danger_epoch_next++;
+    return danger_state_epoch[danger_state_cur];
+}
+
+/*
+ * L: Note any change in a monster since its dangers were cached, and say if
+ * it moved, which forgets all the cached dangers
+ */
+static bool borg_danger_check_kill(int i)
+{
+    borg_kill *kill = &borg_kills[i];
+    struct borg_danger_kill now;
+    bool moved;
+
+    memset(&now, 0, sizeof(now));
+    now.pos           = kill->pos;
+    now.r_idx         = kill->r_idx;
+    now.power         = kill->power;
+    now.injury        = kill->injury;
+    now.level         = kill->level;
+    now.speed         = kill->speed;
+    now.ranged_attack = kill->ranged_attack;
+    now.awake         = kill->awake;
+    now.confused      = kill->confused;
+    now.afraid        = kill->afraid;
+    now.stunned       = kill->stunned;
+
+    if (!memcmp(&now, &danger_kills[i], sizeof(now)))
+        return false;
+
+    /* A monster that moved changes the way for the others */
+    moved = !loc_eq(now.pos, danger_kills[i].pos);
+    if (moved)
+        borg_danger_cache_wipe();
+
+    danger_kills[i] = now;
+    danger_kill_gen[i]++;
+    return moved;
+}
+
 /*
  * Calculate base danger from a monster's physical attacks
  *
@@ -2804,11 +2994,17 @@ int borg_danger_one_kill(
 int borg_danger(int y, int x, int c, bool average, bool full_damage)
 {
     int i, p = 0;
+    bool cache;
+    uint32_t epoch = 0;
+
+    uint64_t perf_start;
 
     struct loc l = loc(x, y);
     if (!square_in_bounds(cave, l))
         return 2000;
 
+    perf_start = borg_perf_start();
+
     /* Base danger (from regional fear) but not within a vault.  Cheating the
      * floor grid */
     if (!square_isvault(cave, l) && borg.trait[BI_CDEPTH] <= 80) {
@@ -2829,18 +3025,55 @@ int borg_danger(int y, int x, int c, bool average, bool full_damage)
 
     full_damage = true;
 
+    /* L: the cache keys on grids and multipliers that fit in its key */
+    cache = (c >= 0 && c < 128 && x >= 0 && x < 256 && y >= 0 && y < 128);
+    if (cache)
+        epoch = borg_danger_epoch();
+
     /* Examine all the monsters */
     for (i = 1; i < borg_kills_nxt; i++) {
         borg_kill *kill = &borg_kills[i];
+        struct borg_danger_entry *entry;
+        uint32_t key;
 
         /* Skip dead monsters */
         if (!kill->r_idx)
             continue;
 
+        if (!cache) {
+            p += borg_danger_one_kill(y, x, c, i, average, full_damage);
+            continue;
+        }
+
+        /* L: monsters too far away to matter cost nothing to ask about */
+        if (ABS(kill->pos.x - x) > 20 || ABS(kill->pos.y - y) > 20)
+            continue;
+
+        /* L: a monster that has changed has to be asked again */
+        if (borg_danger_check_kill(i))
+            epoch = borg_danger_epoch();
+
+        key = ((uint32_t)i << 24) | ((uint32_t)y << 17) | ((uint32_t)x << 9)
+              | ((uint32_t)c << 2) | (average ? 2 : 0) | (full_damage ? 1 : 0);
+        entry = &danger_cache[(key * 2654435761U) >> (32 - DANGER_CACHE_BITS)];
+        if (entry->key == key && entry->epoch == epoch
+            && entry->kill_gen == danger_kill_gen[i]) {
+            danger_counts.hits++;
+        } else {
+            danger_counts.misses++;
+            entry->key      = key;
+            entry->epoch    = epoch;
+            entry->kill_gen = danger_kill_gen[i];
+            entry->danger
+                = borg_danger_one_kill(y, x, c, i, average, full_damage);
+        }
+
         /* Collect danger from monster */
-        p += borg_danger_one_kill(y, x, c, i, average, full_damage);
+        p += entry->danger;
     }
 
+    borg_perf_stop(BORG_PERF_DANGER, perf_start);
+
     /* Return the danger */
     return (p > 2000 ? 2000 : p);
 }
@@ -76,6 +76,25 @@ extern uint16_t borg_fear_monsters[AUTO_MAX_Y + 1][AUTO_MAX_X + 1];
  */
 extern bool borg_danger_wipe;
 
+/*
+ * L: Counts kept by the danger cache
+ */
+struct borg_danger_cache_counts {
+    uint64_t hits; /* dangers found in the cache */
+    uint64_t misses; /* dangers worked out */
+    uint32_t wipes; /* times everything cached was forgotten */
+};
+
+/*
+ * L: Forget every cached danger
+ */
+extern void borg_danger_cache_wipe(void);
+
+/*
+ * L: Get the counts kept by the danger cache
+ */
+extern const struct borg_danger_cache_counts *borg_danger_cache_counts(void);
+
 /*
  * Calculate danger to a grid from a monster
  */
@@ -40,6 +40,7 @@
 #include "borg-item-use.h"
 #include "borg-item-val.h"
 #include "borg-item.h"
+#include "borg-perf.h"
 #include "borg-projection.h"
 #include "borg-trait.h"
 #include "borg-update.h"
@@ -5172,7 +5173,7 @@ int borg_calculate_attack_effectiveness(int attack_type)
  *
  * See above for the "semantics" of each "type" of attack.
  */
-bool borg_attack(bool boosted_bravery)
+static bool borg_attack_aux(bool boosted_bravery)
 {
     int i;
 
@@ -5341,4 +5342,16 @@ bool borg_attack(bool boosted_bravery)
     return true;
 }
 
+/*
+ * L: Attack, timed when the borg is being profiled
+ */
+bool borg_attack(bool boosted_bravery)
+{
+    uint64_t start = borg_perf_start();
+    bool     done  = borg_attack_aux(boosted_bravery);
+
+    borg_perf_stop(BORG_PERF_ATTACK, start);
+    return done;
+}
+
 #endif
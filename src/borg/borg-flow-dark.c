@@ -300,7 +300,7 @@ static void borg_flow_direct(int y, int x)
     }
 
     /* Save the flow cost (zero) */
-    borg_data_cost->data[y][x] = 0;
+    borg_flow_set(borg_data_cost, y, x, 0);
 
     /* Save "origin" */
     y1 = y;
@@ -419,11 +419,11 @@ static void borg_flow_direct(int y, int x)
         }
 
         /* Abort "pointless" paths if possible */
-        if (borg_data_cost->data[y][x] <= n)
+        if (borg_flow_get(borg_data_cost, y, x) <= n)
             break;
 
         /* Save the new flow cost */
-        borg_data_cost->data[y][x] = n;
+        borg_flow_set(borg_data_cost, y, x, n);
     }
 }
 
@@ -434,6 +434,9 @@ static void borg_flow_border(int y1, int x1, int y2, int x2, bool stop)
 {
     int x, y;
 
+    /* L: a cached spread may have been bounded differently */
+    borg_flow_cache_wipe();
+
     /* Scan west/east edges */
     for (y = y1; y <= y2; y++) {
         /* Avoid/Clear west edge */
@@ -831,7 +834,7 @@ static bool borg_flow_dark_4(int b_stair)
         borg_flow_spread(leash, true, true, false, -1, false);
     } else {
         /* Long Leash */
-        borg_flow_spread(250, true, true, false, -1, false);
+        borg_flow_spread(BORG_FLOW_FAR, true, true, false, -1, false);
     }
 
     /* Clear the edges */
@@ -928,7 +931,7 @@ static bool borg_flow_dark_5(int b_stair)
         borg_flow_spread(leash, true, true, false, -1, false);
     } else {
         /* Long Leash */
-        borg_flow_spread(250, true, true, false, -1, false);
+        borg_flow_spread(BORG_FLOW_FAR, true, true, false, -1, false);
     }
 
     /* Attempt to Commit the flow */
@@ -145,7 +145,7 @@ bool borg_flow_glyph(int why)
     }
 
     /* Reverse flow */
-    borg_flow_reverse(250, true, false, false, -1, false);
+    borg_flow_reverse(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Scan the entire map */
     for (y = 15; y < AUTO_MAX_Y - 15; y++) {
@@ -163,7 +163,7 @@ bool borg_flow_glyph(int why)
                 continue;
 
             /* Acquire the cost */
-            cost = borg_data_cost->data[y][x];
+            cost = borg_flow_get(borg_data_cost, y, x);
 
             /* Skip grids that are really far away.  He probably
              * won't be able to safely get there
@@ -314,7 +314,7 @@ bool borg_flow_glyph(int why)
     borg_flow_enqueue_grid(b_y, b_x);
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, false);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("Glyph", GOAL_MISC))
@@ -522,7 +522,7 @@ bool borg_flow_spastic(bool bored)
     }
 
     /* Reverse flow */
-    borg_flow_reverse(250, true, false, false, -1, false);
+    borg_flow_reverse(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Scan the entire map */
     for (y = 1; y < AUTO_MAX_Y - 1; y++) {
@@ -550,10 +550,10 @@ bool borg_flow_spastic(bool bored)
                 continue;
 
             /* Acquire the cost */
-            cost = borg_data_cost->data[y][x];
+            cost = borg_flow_get(borg_data_cost, y, x);
 
             /* Skip "unreachable" grids */
-            if (cost >= 250)
+            if (cost >= BORG_FLOW_NONE)
                 continue;
 
             /* Skip grids that are really far away.  He probably
@@ -723,7 +723,7 @@ bool borg_flow_spastic(bool bored)
     borg_flow_enqueue_grid(b_y, b_x);
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, false);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("spastic", GOAL_XTRA))
@@ -777,7 +777,7 @@ bool borg_flow_shop_entry(int i)
     borg_flow_enqueue_grid(y, x);
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, false);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit(name, GOAL_MISC))
@@ -832,7 +832,7 @@ bool borg_flow_light(int why)
     }
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, false);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("a lighted area", why))
@@ -928,7 +928,7 @@ bool borg_flow_vault(int nearness)
     }
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, false);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, false);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("vault excavation", GOAL_VAULT))
@@ -44,7 +44,7 @@ struct borg_track track_more;
  */
 int borg_flow_cost_stair(int y, int x, int b_stair)
 {
-    int cost = 255;
+    int cost;
 
     /* Clear the flow codes */
     borg_flow_clear();
@@ -57,10 +57,10 @@ int borg_flow_cost_stair(int y, int x, int b_stair)
     borg_flow_enqueue_grid(track_less.y[b_stair], track_less.x[b_stair]);
 
     /* Spread, but do NOT optimize */
-    borg_flow_spread(250, false, false, false, b_stair, false);
+    borg_flow_spread(BORG_FLOW_FAR, false, false, false, b_stair, false);
 
     /* Distance from the grid to the stair */
-    cost = borg_data_cost->data[y][x];
+    cost = borg_flow_get(borg_data_cost, y, x);
 
     return (cost);
 }
@@ -112,7 +112,7 @@ bool borg_flow_stair_both(int why, bool sneak)
     }
 
     /* Spread the flow */
-    borg_flow_spread(250, false, false, false, -1, sneak);
+    borg_flow_spread(BORG_FLOW_FAR, false, false, false, -1, sneak);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("stairs", why))
@@ -152,10 +152,11 @@ bool borg_flow_stair_less(int why, bool sneak)
 
     if (borg.trait[BI_CLEVEL] > 35 || borg.trait[BI_CURLITE] == 0) {
         /* Spread the flow */
-        borg_flow_spread(250, true, false, false, -1, sneak);
+        borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, sneak);
     } else {
         /* Spread the flow, No Optimize, Avoid */
-        borg_flow_spread(250, false, !borg_desperate, false, -1, sneak);
+        borg_flow_spread(
+            BORG_FLOW_FAR, false, !borg_desperate, false, -1, sneak);
     }
 
     /* Attempt to Commit the flow */
@@ -224,7 +225,7 @@ bool borg_flow_stair_more(int why, bool sneak, bool brave)
     }
 
     /* Spread the flow */
-    borg_flow_spread(250, true, false, false, -1, sneak);
+    borg_flow_spread(BORG_FLOW_FAR, true, false, false, -1, sneak);
 
     /* Attempt to Commit the flow */
     if (!borg_flow_commit("down-stairs", why))
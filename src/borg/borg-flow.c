@@ -34,6 +34,7 @@
 #include "borg-item-use.h"
 #include "borg-item-val.h"
 #include "borg-magic.h"
+#include "borg-perf.h"
 #include "borg-projection.h"
 #include "borg-trait.h"
 #include "borg.h"
@@ -57,11 +58,60 @@ uint8_t borg_flow_y[AUTO_FLOW_MAX];
 /*
  * Some variables
  */
-borg_data *borg_data_flow; /* Current "flow" data */
-borg_data *borg_data_cost; /* Current "cost" data */
-borg_data *borg_data_hard; /* Constant "hard" data */
-borg_data *borg_data_know; /* Current "know" flags */
-borg_data *borg_data_icky; /* Current "icky" flags */
+borg_flow_data *borg_data_flow; /* Current "flow" data */
+borg_flow_data *borg_data_cost; /* Current "cost" data */
+borg_data      *borg_data_know; /* Current "know" flags */
+borg_data      *borg_data_icky; /* Current "icky" flags */
+
+/*
+ * L: The last generation handed out to a flow table.  Generation zero is
+ * never used, so a table fresh from mem_zalloc() holds no costs.
+ */
+static uint16_t flow_gen_last = 0;
+
+/*
+ * L: Whether anything has been stamped with the cost table's generation
+ */
+static bool flow_cost_used = false;
+
+/*
+ * L: The flow cache.  Many thinks spread the same flow over and over, such
+ * as borg_flow_cost_stair() for each grid it is asked about.  The last
+ * spread is remembered by its seeds and by what the spread reads of the
+ * borg, and if the cost table is cleared and seeded again from the same
+ * grids, with nothing else done to it, the spread takes back the old
+ * generation instead of working it out again.  The map only changes when
+ * the borg reads the screen, which wipes the cache.
+ */
+struct borg_flow_key {
+    int        trait[BI_MAX];
+    struct loc c;
+    int        depth;
+    int        stair_idx;
+    int32_t    began;
+    int16_t    t;
+    int16_t    avoidance;
+    int16_t    shop;
+    bool       optimize;
+    bool       avoid;
+    bool       tunneling;
+    bool       sneak;
+    bool       desperate;
+    bool       lunal_mode;
+    bool       munchkin_mode;
+    bool       digging;
+    bool       ignoring;
+    bool       scaryguy;
+    bool       unique;
+    bool       vault;
+};
+
+static struct borg_flow_key          flow_cache_key;
+static uint16_t                      flow_cache_gen = 0; /* zero if none */
+static uint16_t                      flow_cache_next = 0;
+static int                           flow_cache_seeds = 0;
+static bool                          flow_seeds_same = false;
+static struct borg_flow_cache_counts flow_counts;
 
 /*
  * Maintain a temporary set of grids
@@ -161,13 +211,106 @@ bool borg_can_dig(bool check_fail, uint8_t feat)
     return false;
 }
 
+/*
+ * L: Get the cost of a grid in a flow table, or BORG_FLOW_NONE
+ */
+int borg_flow_get(const borg_flow_data *flow, int y, int x)
+{
+    const struct borg_flow_grid *g = &flow->grid[y][x];
+
+    return (g->stamp == flow->gen) ? g->cost : BORG_FLOW_NONE;
+}
+
+/*
+ * L: Set the cost of a grid in a flow table
+ */
+void borg_flow_set(borg_flow_data *flow, int y, int x, int cost)
+{
+    struct borg_flow_grid *g = &flow->grid[y][x];
+
+    g->stamp = flow->gen;
+    g->cost  = cost;
+
+    if (flow == borg_data_cost)
+        flow_cost_used = true;
+}
+
+/*
+ * L: Hand out a new generation.  When the numbers run out, the flow table
+ * is renumbered (the cost table is always being cleared when this is called)
+ */
+static uint16_t borg_flow_new_gen(void)
+{
+    int x, y;
+
+    if (flow_gen_last == UINT16_MAX) {
+        for (y = 0; y < AUTO_MAX_Y; y++) {
+            for (x = 0; x < AUTO_MAX_X; x++) {
+                struct borg_flow_grid *g = &borg_data_flow->grid[y][x];
+
+                g->stamp = (g->stamp == borg_data_flow->gen) ? 1 : 0;
+                borg_data_cost->grid[y][x].stamp = 0;
+            }
+        }
+        borg_data_flow->gen = 1;
+        borg_data_cost->gen = 0;
+        flow_gen_last       = 1;
+        borg_flow_cache_wipe();
+    }
+
+    return ++flow_gen_last;
+}
+
+/*
+ * L: Forget both flow tables, such as on a new level
+ */
+void borg_flow_reset(void)
+{
+    borg_data_cost->gen = borg_flow_new_gen();
+    borg_data_flow->gen = borg_flow_new_gen();
+    flow_cost_used      = false;
+    borg_flow_cache_wipe();
+
+    flow_head = 0;
+    flow_tail = 0;
+}
+
+/*
+ * L: Forget the cached spread
+ */
+void borg_flow_cache_wipe(void)
+{
+    flow_cache_gen  = 0;
+    flow_cache_next = 0;
+}
+
+/*
+ * L: Get the counts kept by the flow cache
+ */
+const struct borg_flow_cache_counts *borg_flow_cache_counts(void)
+{
+    return &flow_counts;
+}
+
 /*
  * Clear the "flow" information
  */
 void borg_flow_clear(void)
 {
-    /* Reset the "cost" fields */
-    memcpy(borg_data_cost, borg_data_hard, sizeof(borg_data));
+    /* L: Reset the "cost" fields by moving to a new generation, unless
+     * nothing has used the current one */
+    if (flow_cost_used) {
+        uint16_t gen = borg_flow_new_gen();
+
+        /* L: the cache can take back the last spread if this is the first
+         * clear since it */
+        flow_cache_next = 0;
+        if (flow_cache_gen && borg_data_cost->gen == flow_cache_gen)
+            flow_cache_next = gen;
+
+        borg_data_cost->gen = gen;
+        flow_cost_used      = false;
+    }
 
     /* Wipe costs and danger */
     if (borg_danger_wipe) {
@@ -177,6 +320,9 @@ void borg_flow_clear(void)
         /* Wipe the "icky" flags */
         memset(borg_data_icky, 0, sizeof(borg_data));
 
+        /* L: the cached spread saw the old flags */
+        borg_flow_cache_wipe();
+
         /* Wipe complete */
         borg_danger_wipe = false;
     }
@@ -184,6 +330,38 @@ void borg_flow_clear(void)
     /* Start over */
     flow_head = 0;
     flow_tail = 0;
+
+    /* L: no seeds yet, so none that differ from the cached spread's */
+    flow_seeds_same = true;
+}
+
+/*
+ * L: Note what a spread reads of the borg, for the flow cache
+ */
+static void borg_flow_key_now(struct borg_flow_key *key, int depth,
+    bool optimize, bool avoid, bool tunneling, int stair_idx, bool sneak)
+{
+    memset(key, 0, sizeof(*key));
+    memcpy(key->trait, borg.trait, sizeof(key->trait));
+    key->c             = borg.c;
+    key->depth         = depth;
+    key->stair_idx     = stair_idx;
+    key->began         = borg_began;
+    key->t             = borg_t;
+    key->avoidance     = avoidance;
+    key->shop          = borg.goal.shop;
+    key->optimize      = optimize;
+    key->avoid         = avoid;
+    key->tunneling     = tunneling;
+    key->sneak         = sneak;
+    key->desperate     = borg_desperate;
+    key->lunal_mode    = borg.lunal_mode;
+    key->munchkin_mode = borg.munchkin_mode;
+    key->digging       = borg_digging;
+    key->ignoring      = borg.goal.ignoring;
+    key->scaryguy      = scaryguy_on_level;
+    key->unique        = unique_on_level != 0;
+    key->vault         = vault_on_level;
 }
 
 /*
@@ -191,24 +369,15 @@ void borg_flow_clear(void)
  *
  * We fill in the "cost" field of every grid that the player can
  * "reach" with the number of steps needed to reach that grid,
- * if the grid is "reachable", and otherwise, with "255", which
- * is the largest possible value that can be stored in a byte.
+ * if the grid is "reachable", and otherwise, with BORG_FLOW_NONE.
  *
- * Thus, certain grids which are actually "reachable" but only by
- * a path which is at least 255 steps in length will thus appear
- * to be "unreachable", but this is not a major concern.
- *
- * We use the "flow" array as a "circular queue", and thus we must
- * be careful not to allow the "queue" to "overflow".  This could
- * only happen with a large number of distinct destination points,
- * each several units away from every other destination point, and
- * in a dungeon with no walls and no dangerous monsters.  But this
- * is technically possible, so we must check for it just in case.
- *
- * We do not need a "priority queue" because the cost from grid to
- * grid is always "one" and we process them in order.  If we did
- * use a priority queue, this function might become unusably slow,
- * unless we reactivated the "room building" code.
+ * L: This is Dijkstra with a bucket queue, one bucket per cost, and the
+ * "flow" array holds the buckets.  Since every step costs "one", a bucket
+ * is only ever added to while the one before it is taken apart, so the
+ * buckets lie one after another in the array and are done in order.  Each
+ * grid gets its cost, and so is queued, at most once, so the array (which
+ * has room for every grid) cannot "overflow".  Every destination grid is a
+ * seed in the first bucket, so one spread serves any number of goals.
  *
  * We handle both "walls" and "danger" by marking every grid which
  * is "impassible", due to either walls, or danger, as "ICKY", and
@@ -244,7 +413,7 @@ void borg_flow_clear(void)
  * was currently included in any flow.
  *
  * If a "depth" is given, then the flow will only be spread to that
- * depth, note that the maximum legal value of "depth" is 250.
+ * depth, note that the maximum legal value of "depth" is BORG_FLOW_FAR.
  *
  * "Avoid" flag means the borg will not move onto unknown grids,
  * nor to Monster grids if borg_desperate or borg.lunal_mode are
@@ -257,7 +426,7 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
     int stair_idx, bool sneak)
 {
     int  i;
-    int  n, o = 0;
+    int  n, bucket_end;
     int  x1, y1;
     int  x, y;
     int  fear = 0;
@@ -266,6 +435,29 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
     bool bad_sneak = false;
     int  origin_y, origin_x;
     bool twitchy = false;
+    int  seeds   = flow_head;
+
+    struct borg_flow_key key;
+
+    uint64_t perf_start = borg_perf_start();
+
+    /* L: Take back the last spread if this is the same one again */
+    borg_flow_key_now(
+        &key, depth, optimize, avoid, tunneling, stair_idx, sneak);
+    if (flow_cache_next && borg_data_cost->gen == flow_cache_next
+        && flow_seeds_same && seeds == flow_cache_seeds
+        && !memcmp(&key, &flow_cache_key, sizeof(key))) {
+        /* L: The seeds were stamped afresh, so stamp them back */
+        borg_data_cost->gen = flow_cache_gen;
+        for (i = 0; i < seeds; i++)
+            borg_flow_set(borg_data_cost, borg_flow_y[i], borg_flow_x[i], 0);
+
+        flow_counts.hits++;
+        flow_head = flow_tail = 0;
+        borg_perf_stop(BORG_PERF_FLOW, perf_start);
+        return;
+    }
+    flow_counts.misses++;
 
     /* Default starting points */
     origin_y = borg.c.y;
@@ -283,37 +475,33 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
         optimize = false;
     }
 
-    /* Now process the queue */
+    /* L: Process the queue a bucket at a time, the seeds being the first */
+    n          = 0;
+    bucket_end = flow_tail;
     while (flow_head != flow_tail) {
-        /* Extract the next entry */
-        x1 = borg_flow_x[flow_tail];
-        y1 = borg_flow_y[flow_tail];
-
-        /* Circular queue -- dequeue the next entry */
-        if (++flow_tail == AUTO_FLOW_MAX)
-            flow_tail = 0;
+        /* L: Start on the next bucket */
+        if (flow_tail == bucket_end) {
+            /* Cost (one per movement grid) */
+            n++;
+            bucket_end = flow_head;
 
-        /* Cost (one per movement grid) */
-        n = borg_data_cost->data[y1][x1] + 1;
-
-        /* New depth */
-        if (n > o) {
             /* Optimize (if requested) */
-            if (optimize && (n > borg_data_cost->data[origin_y][origin_x]))
+            if (optimize
+                && (n > borg_flow_get(borg_data_cost, origin_y, origin_x)))
                 break;
 
             /* Limit depth */
             if (n > depth)
                 break;
-
-            /* Save */
-            o = n;
         }
 
+        /* Extract the next entry */
+        x1 = borg_flow_x[flow_tail];
+        y1 = borg_flow_y[flow_tail];
+        flow_tail++;
+
         /* Queue the "children" */
         for (i = 0; i < 8; i++) {
-            int old_head;
-
             borg_grid *ag;
 
             /* reset bad_sneak */
@@ -328,7 +516,7 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
                 continue;
 
             /* Skip "reached" grids */
-            if (borg_data_cost->data[y][x] <= n)
+            if (borg_flow_get(borg_data_cost, y, x) <= n)
                 continue;
 
             /* Access the grid */
@@ -478,27 +666,25 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
             }
 
             /* Save the flow cost */
-            borg_data_cost->data[y][x] = n;
+            borg_flow_set(borg_data_cost, y, x, n);
 
-            /* Enqueue that entry */
+            /* Enqueue that entry (L: into the next bucket) */
             borg_flow_x[flow_head] = x;
             borg_flow_y[flow_head] = y;
-
-            /* Circular queue -- memorize head */
-            old_head = flow_head;
-
-            /* Circular queue -- insert with wrap */
-            if (++flow_head == AUTO_FLOW_MAX)
-                flow_head = 0;
-
-            /* Circular queue -- handle overflow (badly) */
-            if (flow_head == flow_tail)
-                flow_head = old_head;
+            flow_head++;
         }
     }
 
+    /* L: Remember this spread */
+    flow_cache_key   = key;
+    flow_cache_gen   = borg_data_cost->gen;
+    flow_cache_next  = 0;
+    flow_cache_seeds = seeds;
+
     /* Forget the flow info */
     flow_head = flow_tail = 0;
+
+    borg_perf_stop(BORG_PERF_FLOW, perf_start);
 }
 
 /*
@@ -506,7 +692,6 @@ void borg_flow_spread(int depth, bool optimize, bool avoid, bool tunneling,
  */
 void borg_flow_enqueue_grid(int y, int x)
 {
-    int old_head;
     int fear = 0;
     int p;
 
@@ -558,26 +743,21 @@ void borg_flow_enqueue_grid(int y, int x)
     }
 
     /* Only enqueue a grid once */
-    if (!borg_data_cost->data[y][x])
+    if (!borg_flow_get(borg_data_cost, y, x))
         return;
 
     /* Save the flow cost (zero) */
-    borg_data_cost->data[y][x] = 0;
+    borg_flow_set(borg_data_cost, y, x, 0);
+
+    /* L: Notice seeds that differ from the cached spread's */
+    if (flow_head >= flow_cache_seeds || borg_flow_y[flow_head] != y
+        || borg_flow_x[flow_head] != x)
+        flow_seeds_same = false;
 
     /* Enqueue that entry */
     borg_flow_y[flow_head] = y;
     borg_flow_x[flow_head] = x;
-
-    /* Circular queue -- memorize head */
-    old_head = flow_head;
-
-    /* Circular queue -- insert with wrap */
-    if (++flow_head == AUTO_FLOW_MAX)
-        flow_head = 0;
-
-    /* Circular queue -- handle overflow */
-    if (flow_head == flow_tail)
-        flow_head = old_head;
+    flow_head++;
 }
 
 /*
@@ -588,10 +768,10 @@ bool borg_flow_commit(const char *who, int why)
     int cost;
 
     /* Cost of current grid */
-    cost = borg_data_cost->data[borg.c.y][borg.c.x];
+    cost = borg_flow_get(borg_data_cost, borg.c.y, borg.c.x);
 
     /* Verify the total "cost" */
-    if (cost >= 250)
+    if (cost >= BORG_FLOW_NONE)
         return false;
 
     /* Message */
@@ -599,7 +779,7 @@ bool borg_flow_commit(const char *who, int why)
         borg_note(format("# Flowing toward %s at cost %d", who, cost));
 
     /* Obtain the "flow" information */
-    memcpy(borg_data_flow, borg_data_cost, sizeof(borg_data));
+    memcpy(borg_data_flow, borg_data_cost, sizeof(borg_flow_data));
 
     /* Save the goal type */
     borg.goal.type = why;
@@ -1111,7 +1291,7 @@ bool borg_flow_old(int why)
         int c, b_c;
 
         /* Flow cost of current grid */
-        b_c = borg_data_flow->data[borg.c.y][borg.c.x] * 10;
+        b_c = borg_flow_get(borg_data_flow, borg.c.y, borg.c.x) * 10;
 
         /* Prevent loops */
         b_c = b_c - 5;
@@ -1123,7 +1303,7 @@ bool borg_flow_old(int why)
             y = borg.c.y + ddy_ddd[i];
 
             /* Flow cost at that grid */
-            c = borg_data_flow->data[y][x] * 10;
+            c = borg_flow_get(borg_data_flow, y, x) * 10;
 
             /* Never backtrack */
             if (c > b_c)
@@ -1207,18 +1387,13 @@ void borg_free_track(struct borg_track *track)
 
 void borg_init_flow(void)
 {
-    int x, y;
-
     /*** Grid data ***/
 
     /* Allocate */
-    borg_data_flow = mem_zalloc(sizeof(borg_data));
-
-    /* Allocate */
-    borg_data_cost = mem_zalloc(sizeof(borg_data));
+    borg_data_flow = mem_zalloc(sizeof(borg_flow_data));
 
     /* Allocate */
-    borg_data_hard = mem_zalloc(sizeof(borg_data));
+    borg_data_cost = mem_zalloc(sizeof(borg_flow_data));
 
     /* Allocate */
     borg_data_know = mem_zalloc(sizeof(borg_data));
@@ -1226,13 +1401,8 @@ void borg_init_flow(void)
     /* Allocate */
     borg_data_icky = mem_zalloc(sizeof(borg_data));
 
-    /* Prepare "borg_data_hard" */
-    for (y = 0; y < AUTO_MAX_Y; y++) {
-        for (x = 0; x < AUTO_MAX_X; x++) {
-            /* Prepare "borg_data_hard" */
-            borg_data_hard->data[y][x] = 255;
-        }
-    }
+    /* L: Start both flow tables empty */
+    borg_flow_reset();
 
     /* Track Steps */
     borg_init_track(&track_step, 100);
@@ -1262,8 +1432,6 @@ void borg_free_flow(void)
     borg_data_icky = NULL;
     mem_free(borg_data_know);
     borg_data_know = NULL;
-    mem_free(borg_data_hard);
-    borg_data_hard = NULL;
     mem_free(borg_data_cost);
     borg_data_cost = NULL;
     mem_free(borg_data_flow);
@@ -58,9 +58,44 @@ struct borg_data {
 };
 
 /*
- * Number of grids in the "flow" array
+ * L: Flow costs are 16 bits, so that paths across a whole level fit.  A
+ * grid's cost only holds while its stamp matches the table's generation, so
+ * a table is cleared by moving it to a new generation.
  */
-#define AUTO_FLOW_MAX 1536
+struct borg_flow_grid {
+    uint16_t stamp;
+    uint16_t cost;
+};
+
+typedef struct borg_flow_data borg_flow_data;
+
+struct borg_flow_data {
+    uint16_t gen;
+    struct borg_flow_grid grid[AUTO_MAX_Y][AUTO_MAX_X];
+};
+
+/*
+ * L: The cost of a grid the flow did not reach
+ */
+#define BORG_FLOW_NONE 0xFFFF
+
+/*
+ * L: The depth to spread a flow to cover the whole level
+ */
+#define BORG_FLOW_FAR (BORG_FLOW_NONE - 1)
+
+/*
+ * L: Counts kept by the flow cache
+ */
+struct borg_flow_cache_counts {
+    uint64_t hits; /* spreads taken back from the last one */
+    uint64_t misses; /* spreads worked out */
+};
+
+/*
+ * Number of grids in the "flow" array (L: every grid is queued at most once)
+ */
+#define AUTO_FLOW_MAX (AUTO_MAX_Y * AUTO_MAX_X)
 
 /*
  * Maintain a set of grids (flow calculations)
@@ -79,9 +114,8 @@ extern int flow_tail;
 /*
  * Some variables
  */
-extern borg_data *borg_data_flow; /* Current "flow" data */
-extern borg_data *borg_data_cost; /* Current "cost" data */
-extern borg_data *borg_data_hard; /* Constant "hard" data */
+extern borg_flow_data *borg_data_flow; /* Current "flow" data */
+extern borg_flow_data *borg_data_cost; /* Current "cost" data */
 extern borg_data *borg_data_know; /* Current "know" flags */
 extern borg_data *borg_data_icky; /* Current "icky" flags */
 
@@ -141,6 +175,31 @@ extern const int16_t borg_ddy_ddd[24];
  */
 extern bool borg_can_dig(bool check_fail, uint8_t feat);
 
+/*
+ * L: Get the cost of a grid in a flow table, or BORG_FLOW_NONE
+ */
+extern int borg_flow_get(const borg_flow_data *flow, int y, int x);
+
+/*
+ * L: Set the cost of a grid in a flow table
+ */
+extern void borg_flow_set(borg_flow_data *flow, int y, int x, int cost);
+
+/*
+ * L: Forget both flow tables, such as on a new level
+ */
+extern void borg_flow_reset(void);
+
+/*
+ * L: Forget the cached spread
+ */
+extern void borg_flow_cache_wipe(void);
+
+/*
+ * L: Get the counts kept by the flow cache
+ */
+extern const struct borg_flow_cache_counts *borg_flow_cache_counts(void);
+
 /*
  * Clear the "flow" information
  */
@@ -38,6 +38,7 @@
 #include "borg-item-wear.h"
 #include "borg-magic.h"
 #include "borg-messages.h"
+#include "borg-perf.h"
 #include "borg-power.h"
 #include "borg-store.h"
 #include "borg-update.h"
@@ -87,6 +88,7 @@ struct borg_setting borg_settings[] = {
     { "borg_dump_level", 'i', 1 }, 
     { "borg_save_death", 'i', 1 },
     { "borg_stop_on_bell", 'b', false },
+    { "borg_profile", 'b', false },
     { 0, 0, 0 }};
 
 
@@ -385,6 +387,9 @@ static void borg_leave_game(
 {
     assert(ev_type == EVENT_LEAVE_GAME && ev_data == NULL && user == NULL);
     game_closed = true;
+
+    /* L: keep the timing of this game */
+    borg_perf_write();
 }
 
 /*
@@ -545,6 +550,9 @@ void borg_init(void)
     /* Reset the clock */
     borg_t = 10;
 
+    /* L: and the timing */
+    borg_perf_reset();
+
     /* note: I would check if player_id2class returns null but it */
     /* never does, even on a bad class */
     if (!streq(player_id2class(CLASS_WARRIOR)->name, "Warrior")
@@ -32,11 +32,13 @@
 #include "../ui-menu.h"
 
 #include "borg-cave.h"
+#include "borg-danger.h"
 #include "borg-flow-glyph.h"
 #include "borg-flow-kill.h"
 #include "borg-flow-take.h"
 #include "borg-home-notice.h"
 #include "borg-magic.h"
+#include "borg-perf.h"
 #include "borg-prepared.h"
 #include "borg-store.h"
 #include "borg.h"
@@ -119,6 +121,84 @@ void borg_log_death_data(void)
     file_close(borg_log_file);
 }
 
+/*
+ * L: write the time spent in each phase of thinking to borg-log.txt
+ */
+void borg_log_perf(void)
+{
+    char      buf[1024];
+    ang_file *borg_log_file;
+    time_t    now;
+    double    rate = borg_perf_ticks_per_sec();
+    int       i, b;
+
+    const struct borg_danger_cache_counts *danger = borg_danger_cache_counts();
+    const struct borg_flow_cache_counts   *flow   = borg_flow_cache_counts();
+
+    if (!borg_cfg[BORG_PROFILE])
+        return;
+
+    /* Build path to location of the definition file */
+    path_build(buf, 1024, ANGBAND_DIR_USER, "borg-log.txt");
+
+    /* Append to the file */
+    borg_log_file = file_open(buf, MODE_APPEND, FTYPE_TEXT);
+
+    /* Failure */
+    if (!borg_log_file)
+        return;
+
+    /* Get the time */
+    (void)time(&now);
+
+    /* Save the date */
+    strftime(buf, 80, "%Y/%m/%d %H:%M\n", localtime(&now));
+
+    file_put(borg_log_file, buf);
+
+    file_putf(borg_log_file,
+        "Borg timing for %s the %s %s, Level %d, Turn: %lu\n",
+        player->full_name, player->race->name, player->class->name,
+        player->lev, (unsigned long)turn);
+
+    file_putf(borg_log_file, "%-8s %10s %10s %10s %10s\n", "Phase", "Calls",
+        "Secs", "us/call", "Most us");
+
+    for (i = 0; i < BORG_PERF_MAX; i++) {
+        const struct borg_perf_counter *counter = borg_perf_counter(i);
+        double secs = rate > 0 ? counter->ticks / rate : 0;
+
+        file_putf(borg_log_file, "%-8s %10llu %10.2f %10.1f %10.0f\n",
+            borg_perf_name(i), (unsigned long long)counter->calls, secs,
+            counter->calls ? secs * 1e6 / counter->calls : 0.0,
+            rate > 0 ? counter->most * 1e6 / rate : 0.0);
+
+        /* Calls by the base 2 log of their ticks */
+        if (!counter->calls)
+            continue;
+        file_put(borg_log_file, "         log2 ticks:");
+        for (b = 0; b < BORG_PERF_BUCKETS; b++) {
+            if (counter->hist[b])
+                file_putf(borg_log_file, " %d:%lu", b,
+                    (unsigned long)counter->hist[b]);
+        }
+        file_put(borg_log_file, "\n");
+    }
+
+    file_putf(borg_log_file,
+        "Danger cache: %llu hits, %llu misses, %lu wipes\n",
+        (unsigned long long)danger->hits, (unsigned long long)danger->misses,
+        (unsigned long)danger->wipes);
+    file_putf(borg_log_file, "Flow cache: %llu hits, %llu misses\n",
+        (unsigned long long)flow->hits, (unsigned long long)flow->misses);
+
+    file_putf(borg_log_file, "Borg Compile Date: %s\n", borg_engine_date);
+
+    file_put(borg_log_file, "----------\n\n");
+
+    file_close(borg_log_file);
+}
+
 /*
  * Convert an inventory index into a one character label.
  *
@@ -35,6 +35,11 @@ extern void borg_log_death(void);
  */
 extern void borg_log_death_data(void);
 
+/*
+ * L: write the time spent in each phase of thinking to borg-log.txt
+ */
+extern void borg_log_perf(void);
+
 /*
  * Display what the borg is thinking
  */
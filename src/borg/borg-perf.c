@@ -0,0 +1,223 @@
+/**
+ * \file borg-perf.c
+ * \brief Count and time the phases of the borg's thinking
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband License":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "borg-perf.h"
+
+#ifdef ALLOW_BORG
+
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BORG_PERF_RDTSC
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BORG_PERF_RDTSC
+#endif
+
+#include "../game-world.h"
+
+#include "borg.h"
+
+static const char *perf_names[BORG_PERF_MAX] = {
+    "think",
+    "update",
+    "notice",
+    "caution",
+    "attack",
+    "danger",
+    "flow",
+    "store",
+};
+
+static struct borg_perf_counter perf_counters[BORG_PERF_MAX];
+
+/*
+ * Where the ticks and the wall clock stood when the counts were reset
+ */
+static uint64_t perf_ticks_reset;
+static double   perf_secs_reset;
+
+/*
+ * Read the wall clock in seconds, from a monotonic clock where there is one
+ */
+static double borg_perf_wall_secs(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return (double)time(NULL);
+#endif
+}
+
+/*
+ * Read the tick counter, the processor's cycle counter where there is one,
+ * else the monotonic clock in nanoseconds, else the processor clock
+ */
+static uint64_t borg_perf_ticks(void)
+{
+#if defined(BORG_PERF_RDTSC)
+    return __rdtsc();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    return (uint64_t)clock();
+#endif
+}
+
+/*
+ * Start timing a phase
+ */
+uint64_t borg_perf_start(void)
+{
+    if (!borg_cfg[BORG_PROFILE])
+        return 0;
+
+    return borg_perf_ticks();
+}
+
+/*
+ * Stop timing a phase
+ */
+void borg_perf_stop(enum borg_perf_phase phase, uint64_t start)
+{
+    struct borg_perf_counter *counter = &perf_counters[phase];
+    uint64_t                  ticks;
+    int                       b = 0;
+
+    /* Not timed, or timing was turned on partway through the phase */
+    if (!start)
+        return;
+
+    ticks = borg_perf_ticks() - start;
+
+    counter->calls++;
+    counter->ticks += ticks;
+    if (ticks > counter->most)
+        counter->most = ticks;
+
+    /* Histogram by the base 2 log of the ticks */
+    while ((ticks >>= 1) && b < BORG_PERF_BUCKETS - 1)
+        b++;
+    counter->hist[b]++;
+}
+
+/*
+ * Get the counter for a phase
+ */
+const struct borg_perf_counter *borg_perf_counter(enum borg_perf_phase phase)
+{
+    return &perf_counters[phase];
+}
+
+/*
+ * Get the name of a phase
+ */
+const char *borg_perf_name(enum borg_perf_phase phase)
+{
+    return perf_names[phase];
+}
+
+/*
+ * Estimate how many ticks make a second
+ */
+double borg_perf_ticks_per_sec(void)
+{
+#if defined(BORG_PERF_RDTSC)
+    double secs = borg_perf_wall_secs() - perf_secs_reset;
+
+    if (secs <= 0)
+        return 0;
+
+    return (double)(borg_perf_ticks() - perf_ticks_reset) / secs;
+#elif defined(CLOCK_MONOTONIC)
+    return 1e9;
+#else
+    return CLOCKS_PER_SEC;
+#endif
+}
+
+/*
+ * Forget all the counts
+ */
+void borg_perf_reset(void)
+{
+    memset(perf_counters, 0, sizeof(perf_counters));
+    perf_ticks_reset = borg_perf_ticks();
+    perf_secs_reset = borg_perf_wall_secs();
+}
+
+/*
+ * Append the counts to borg-perf.csv, one line per phase, with a header
+ * if the file is new
+ */
+void borg_perf_write(void)
+{
+    char      buf[1024];
+    ang_file *fff;
+    bool      fresh;
+    double    rate = borg_perf_ticks_per_sec();
+    time_t    now;
+    int       i, b;
+
+    if (!borg_cfg[BORG_PROFILE] || !perf_counters[BORG_PERF_THINK].calls)
+        return;
+
+    path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "borg-perf.csv");
+    fresh = !file_exists(buf);
+
+    /* Append to the file */
+    fff = file_open(buf, MODE_APPEND, FTYPE_TEXT);
+
+    /* Failure */
+    if (!fff)
+        return;
+
+    if (fresh) {
+        file_put(fff, "date,engine,race,class,clevel,max_depth,turn,"
+                      "ticks_per_sec,phase,calls,ticks,most");
+        for (b = 0; b < BORG_PERF_BUCKETS; b++)
+            file_putf(fff, ",log2_%d", b);
+        file_put(fff, "\n");
+    }
+
+    (void)time(&now);
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    for (i = 0; i < BORG_PERF_MAX; i++) {
+        const struct borg_perf_counter *counter = &perf_counters[i];
+
+        file_putf(fff, "%s,%s,%s,%s,%d,%d,%lu,%.0f,%s,%llu,%llu,%llu", buf,
+            borg_engine_date, player->race->name, player->class->name,
+            player->lev, player->max_depth, (unsigned long)turn, rate,
+            perf_names[i], (unsigned long long)counter->calls,
+            (unsigned long long)counter->ticks,
+            (unsigned long long)counter->most);
+        for (b = 0; b < BORG_PERF_BUCKETS; b++)
+            file_putf(fff, ",%lu", (unsigned long)counter->hist[b]);
+        file_put(fff, "\n");
+    }
+
+    file_close(fff);
+}
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * \file borg-perf.h
+ * \brief Count and time the phases of the borg's thinking
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband License":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_BORG_PERF_H
+#define INCLUDED_BORG_PERF_H
+
+/*
+ * must be included before ALLOW_BORG to avoid empty compilation unit
+ */
+#include "../angband.h"
+
+#ifdef ALLOW_BORG
+
+/*
+ * The phases that are timed.  Times include any phase called from within
+ * another, so borg_danger() is counted both on its own and in whatever
+ * phase asked for it.
+ */
+enum borg_perf_phase {
+    BORG_PERF_THINK, /* borg_think() */
+    BORG_PERF_UPDATE, /* borg_update() */
+    BORG_PERF_NOTICE, /* borg_notice(), the analysis of items and traits */
+    BORG_PERF_CAUTION, /* borg_caution() */
+    BORG_PERF_ATTACK, /* borg_attack() */
+    BORG_PERF_DANGER, /* borg_danger() */
+    BORG_PERF_FLOW, /* borg_flow_spread() */
+    BORG_PERF_STORE, /* borg_think_store() */
+    BORG_PERF_MAX
+};
+
+/*
+ * Calls are also counted by the base 2 log of the ticks they took
+ */
+#define BORG_PERF_BUCKETS 32
+
+struct borg_perf_counter {
+    uint64_t calls;
+    uint64_t ticks; /* total ticks spent in the phase */
+    uint64_t most; /* ticks taken by the longest call */
+    uint32_t hist[BORG_PERF_BUCKETS];
+};
+
+/*
+ * Start timing a phase, returns the tick count to pass to borg_perf_stop()
+ * (zero when the borg is not being timed)
+ */
+extern uint64_t borg_perf_start(void);
+
+/*
+ * Stop timing a phase
+ */
+extern void borg_perf_stop(enum borg_perf_phase phase, uint64_t start);
+
+/*
+ * Get the counter for a phase
+ */
+extern const struct borg_perf_counter *borg_perf_counter(
+    enum borg_perf_phase phase);
+
+/*
+ * Get the name of a phase
+ */
+extern const char *borg_perf_name(enum borg_perf_phase phase);
+
+/*
+ * Estimate how many ticks make a second, from the time since the counts
+ * were reset
+ */
+extern double borg_perf_ticks_per_sec(void);
+
+/*
+ * Forget all the counts
+ */
+extern void borg_perf_reset(void);
+
+/*
+ * Append the counts to borg-perf.csv, one line per phase
+ */
+extern void borg_perf_write(void);
+
+#endif
+#endif
@@ -27,6 +27,7 @@
 #include "borg-io.h"
 #include "borg-item-wear.h"
 #include "borg-item.h"
+#include "borg-perf.h"
 #include "borg-store-buy.h"
 #include "borg-store-sell.h"
 #include "borg-store.h"
@@ -277,7 +278,7 @@ bool borg_choose_shop(void)
 /*
  * Deal with being in a store
  */
-bool borg_think_store(void)
+static bool borg_think_store_aux(void)
 {
     /* Hack -- prevent clock wrapping */
     if (borg_t >= 20000 && borg_t <= 20010) {
@@ -347,4 +348,16 @@ bool borg_think_store(void)
     return true;
 }
 
+/*
+ * L: Deal with being in a store, timed when the borg is being profiled
+ */
+bool borg_think_store(void)
+{
+    uint64_t start = borg_perf_start();
+    bool     done  = borg_think_store_aux();
+
+    borg_perf_stop(BORG_PERF_STORE, start);
+    return done;
+}
+
 #endif
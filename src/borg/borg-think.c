@@ -30,6 +30,7 @@
 #include "borg-item-wear.h"
 #include "borg-log.h"
 #include "borg-magic.h"
+#include "borg-perf.h"
 #include "borg-power.h"
 #include "borg-reincarnate.h"
 #include "borg-store.h"
@@ -135,7 +136,7 @@ static bool borg_save_game(void)
  * especially if we attempt to do "item tracking" in the inventory
  * extraction code.
  */
-bool borg_think(void)
+static bool borg_think_aux(void)
 {
     int i;
 
@@ -347,6 +348,7 @@ bool borg_think(void)
             /* Write to log and borg.dat */
             borg_log_death();
             borg_log_death_data();
+            borg_log_perf();
 
             /* respawn */
             reincarnate_borg();
@@ -517,4 +519,16 @@ bool borg_think(void)
     return (borg_think_dungeon());
 }
 
+/*
+ * L: Think, timed when the borg is being profiled
+ */
+bool borg_think(void)
+{
+    uint64_t start = borg_perf_start();
+    bool     done  = borg_think_aux();
+
+    borg_perf_stop(BORG_PERF_THINK, start);
+    return done;
+}
+
 #endif
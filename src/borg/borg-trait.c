@@ -40,6 +40,7 @@
 #include "borg-trait-swap.h"
 #include "borg.h"
 #include "borg-home-notice.h"
+#include "borg-perf.h"
 
 /* MAJOR HACK copied in because it is static in the main code */
 /* I would just make them not static but trying not to change base code */
@@ -1770,8 +1771,12 @@ static void borg_notice_equipment(void)
         /* Extract the new "use_stat" value for the stat */
         use = modify_stat_value(borg.stat_cur[i], add);
 
+        /* L: drained below 3, use the lowest entry */
+        if (use <= 3)
+            ind = 0;
+
         /* Values: 3, ..., 17 */
-        if (use <= 18)
+        else if (use <= 18)
             ind = (use - 3);
 
         /* Ranges: 18/00-18/09, ..., 18/210-18/219 */
@@ -2809,6 +2814,8 @@ static void borg_notice_inventory(void)
  */
 void borg_notice(bool notice_swap)
 {
+    uint64_t perf_start = borg_perf_start();
+
     /* Clear out trait arrays */
     memset(borg.has, 0, z_info->k_max * sizeof(int));
     memset(borg.trait, 0, BI_MAX * sizeof(int));
@@ -2920,6 +2927,8 @@ void borg_notice(bool notice_swap)
         if (total_big_heal < 30 || (num_speed + borg.trait[BI_ASPEED]) < 15)
             borg.trait[BI_PREP_BIG_FIGHT] = true;
     }
+
+    borg_perf_stop(BORG_PERF_NOTICE, perf_start);
 }
 
 /*
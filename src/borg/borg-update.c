@@ -42,6 +42,7 @@
 #include "borg-item-wear.h"
 #include "borg-junk.h"
 #include "borg-messages.h"
+#include "borg-perf.h"
 #include "borg-prepared.h"
 #include "borg-projection.h"
 #include "borg-store-buy.h"
@@ -149,11 +150,8 @@ static void borg_forget_map(void)
         }
     }
 
-    /* Reset "borg_data_cost" */
-    memcpy(borg_data_cost, borg_data_hard, sizeof(borg_data));
-
-    /* Reset "borg_data_flow" */
-    memcpy(borg_data_flow, borg_data_hard, sizeof(borg_data));
+    /* Reset "borg_data_cost" and "borg_data_flow" */
+    borg_flow_reset();
 
     /* Clear "borg_data_know" */
     memset(borg_data_know, 0, sizeof(borg_data));
@@ -555,7 +553,7 @@ static void borg_update_map(void)
             if (old_wall != new_wall) {
                 /* Remove this grid from any flow */
                 if (new_wall)
-                    borg_data_flow->data[y][x] = 255;
+                    borg_flow_set(borg_data_flow, y, x, BORG_FLOW_NONE);
 
                 /* Remove this grid from any flow */
                 borg_data_know->data[y][x] = false;
@@ -1508,6 +1506,8 @@ void borg_update(void)
     bool monster_in_vault = false;
     bool created_traps    = false;
 
+    uint64_t perf_start = borg_perf_start();
+
     /*** Process objects/monsters ***/
 
     /* Scan monsters */
@@ -2407,6 +2407,10 @@ void borg_update(void)
     /* Update the map */
     borg_update_map();
 
+    /* L: dangers and flows worked out against the old map no longer hold */
+    borg_danger_cache_wipe();
+    borg_flow_cache_wipe();
+
     /* Mark this grid as having been stepped on */
     track_step.x[track_step.num] = borg.c.x;
     track_step.y[track_step.num] = borg.c.y;
@@ -2992,6 +2996,8 @@ void borg_update(void)
 
     /* Default "goal" location */
     borg.goal.g = borg.c;
+
+    borg_perf_stop(BORG_PERF_UPDATE, perf_start);
 }
 
 void borg_init_update(void)
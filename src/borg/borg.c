@@ -47,6 +47,7 @@
 #include "borg-magic.h"
 #include "borg-messages-react.h"
 #include "borg-messages.h"
+#include "borg-perf.h"
 #include "borg-power.h"
 #include "borg-prepared.h"
 #include "borg-projection.h"
@@ -88,6 +89,7 @@ int *borg_cfg;
  */
 bool borg_active; /* Actually active */
 bool borg_cancel; /* Being cancelled */
+bool borg_headless      = false; /* L: nobody is watching the screen */
 bool borg_flag_save     = false; /* Save savefile at each level */
 bool borg_save          = false; /* do a save next level */
 bool borg_graphics      = false; /* rr9's graphics */
@@ -232,8 +234,9 @@ static struct keypress internal_borg_inkey(int flush_first)
     /* Locate the cursor */
     (void)Term_locate(&x, &y);
 
-    /* Refresh the screen */
-    Term_fresh();
+    /* L: refresh the screen, unless nobody is watching it */
+    if (!borg_headless)
+        Term_fresh();
 
     /* Deactivate */
     if (!borg_active) {
@@ -338,6 +341,7 @@ static struct keypress internal_borg_inkey(int flush_first)
         /* Log the death */
         borg_log_death();
         borg_log_death_data();
+        borg_log_perf();
 
 #if 0
         /* Note the score */
@@ -453,6 +457,7 @@ static struct keypress internal_borg_inkey(int flush_first)
         /* Log death */
         borg_log_death();
         borg_log_death_data();
+        borg_log_perf();
 #if 0
         /* Note the score */
         borg_enter_score();
@@ -645,6 +650,75 @@ static struct keypress borg_inkey_hack(int flush_first)
 }
 
 
+/*
+ * Hack -- force initialization or reinitialize if the game was closed
+ * and restarted without exiting since the last initialization
+ */
+static bool borg_prepare(void)
+{
+    if (!borg_initialized || game_closed) {
+        if (borg_initialized) {
+            borg_free();
+        }
+        borg_init();
+
+        if (borg_init_failure) {
+            borg_initialized = false;
+            borg_free();
+            borg_note("** startup failure borg cannot run ** ");
+            Term_fresh();
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * L: Let the borg play on until it is cancelled
+ */
+static void borg_activate(void)
+{
+    /* make sure the important game options are set correctly */
+    borg_reinit_options();
+
+    /* Activate */
+    borg_active = true;
+
+    /* Reset cancel */
+    borg_cancel = false;
+
+    /* Step forever */
+    borg_step = 0;
+
+    borg_notice_player();
+
+    if (player->opts.lazymove_delay != 0) {
+        borg_note("# Turning off lazy movement controls");
+        player->opts.lazymove_delay = 0;
+    }
+
+    /* Message */
+    borg_note("# Installing keypress hook");
+
+    /* If the clock overflowed, fix that  */
+    if (borg_t > 9000)
+        borg_t = 9000;
+
+    /* Activate the key stealer */
+    inkey_hack = borg_inkey_hack;
+}
+
+/*
+ * L: Start the borg without asking, for front ends that play it unattended
+ */
+bool borg_start(void)
+{
+    if (!borg_prepare())
+        return false;
+    borg_activate();
+    return true;
+}
+
 /*
  * Hack -- interact with the "Ben Borg".
  */
@@ -734,6 +808,7 @@ void do_cmd_borg(void)
         Term_putstr(2, i++, -1, COLOUR_WHITE, "Command 'R' Respawn Borg.");
         Term_putstr(42, i, -1, COLOUR_WHITE, "Command 'o' Object Flags.");
         Term_putstr(2, i++, -1, COLOUR_WHITE, "Command 'r' Restock Stores.");
+        Term_putstr(42, i, -1, COLOUR_WHITE, "Command 'e' Log timing.");
 
         /* Prompt for key */
         msg("Commands: ");
@@ -746,24 +821,9 @@ void do_cmd_borg(void)
         return;
     }
 
-    /*
-     * Hack -- force initialization or reinitialize if the game was closed
-     * and restarted without exiting since the last initialization
-     */
-    if (!borg_initialized || game_closed) {
-        if (borg_initialized) {
-            borg_free();
-        }
-        borg_init();
-
-        if (borg_init_failure) {
-            borg_initialized = false;
-            borg_free();
-            borg_note("** startup failure borg cannot run ** ");
-            Term_fresh();
-            return;
-        }
-    }
+    /* L: make sure the borg is ready */
+    if (!borg_prepare())
+        return;
 
     switch (cmd) {
         /* Command: Nothing */
@@ -775,35 +835,7 @@ void do_cmd_borg(void)
     /* Command: Activate */
     case 'z':
     case 'Z': {
-        /* make sure the important game options are set correctly */
-        borg_reinit_options();
-
-        /* Activate */
-        borg_active = true;
-
-        /* Reset cancel */
-        borg_cancel = false;
-
-        /* Step forever */
-        borg_step = 0;
-
-        borg_notice_player();
-
-        if (player->opts.lazymove_delay != 0) {
-            borg_note("# Turning off lazy movement controls");
-            player->opts.lazymove_delay = 0;
-        }
-
-        /* Message */
-        borg_note("# Installing keypress hook");
-
-        /* If the clock overflowed, fix that  */
-        if (borg_t > 9000)
-            borg_t = 9000;
-
-        /* Activate the key stealer */
-        inkey_hack = borg_inkey_hack;
-
+        borg_activate();
         break;
     }
 
@@ -1460,7 +1492,7 @@ void do_cmd_borg(void)
             int c, b_c;
 
             /* Flow cost of current grid */
-            b_c = borg_data_flow->data[borg.c.y][borg.c.x] * 10;
+            b_c = borg_flow_get(borg_data_flow, borg.c.y, borg.c.x) * 10;
 
             /* Prevent loops */
             b_c = b_c - 5;
@@ -1472,7 +1504,7 @@ void do_cmd_borg(void)
                 y = false_y + ddy_ddd[i];
 
                 /* Flow cost at that grid */
-                c = borg_data_flow->data[y][x] * 10;
+                c = borg_flow_get(borg_data_flow, y, x) * 10;
 
                 /* Never backtrack */
                 if (c > b_c)
@@ -1657,6 +1689,17 @@ void do_cmd_borg(void)
         break;
     }
 
+    /* L: Command: log the timing of each phase */
+    case 'e': {
+        if (!borg_cfg[BORG_PROFILE]) {
+            msg("Set borg_profile in borg.txt to time the borg.");
+            break;
+        }
+        borg_log_perf();
+        msg("Timing written to borg-log.txt.");
+        break;
+    }
+
     /* Command: Show time */
     case '!': {
         int32_t time = borg_t - borg_began;
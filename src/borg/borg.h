@@ -75,6 +75,7 @@ enum {
     BORG_DUMP_LEVEL,
     BORG_SAVE_DEATH,
     BORG_STOP_ON_BELL,
+    BORG_PROFILE,
     BORG_MAX_SETTINGS
 };
 extern int *borg_cfg;
@@ -84,6 +85,7 @@ extern int *borg_cfg;
  */
 extern bool borg_active; /* Actually active */
 extern bool borg_cancel; /* Being cancelled */
+extern bool borg_headless; /* L: nobody is watching the screen */
 extern bool borg_flag_save; /* Save savefile at each level */
 extern bool borg_save; /* do a save next time we get to press a key! */
 extern bool borg_graphics; /* rr9's graphics */
@@ -122,5 +124,10 @@ extern struct keypress (*inkey_hack)(int flush_first);
  */
 extern void do_cmd_borg(void);
 
+/*
+ * L: Start the borg playing without any prompts.
+ */
+extern bool borg_start(void);
+
 #endif
 #endif
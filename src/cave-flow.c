@@ -0,0 +1,178 @@
+/**
+ * \file cave-flow.c
+ * \brief Flow fields towards monsters that other monsters are pursuing
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+
+/**
+ * How far a target may wander from where its field was filled before the
+ * field is filled again; a pursuer following a slightly old field still
+ * ends up next to the target, which it can then see and step towards
+ */
+#define FLOW_SLACK 2
+
+/**
+ * How many steps out from its target a field is filled.  Pursuers have
+ * their target in view, so a path twice the sight range covers any route
+ * round the walls between them.
+ */
+static int flow_depth(void)
+{
+	return z_info->max_sight * 2;
+}
+
+/**
+ * Fill a flow field with steps from its target's grid.
+ *
+ * The target's grid gets 1 and every grid sound can pass through within
+ * the depth limit gets one more than its nearest filled neighbour, so
+ * higher values mean further from the target and 0 means out of reach.
+ * As with the noise field, the queue is kept between fills and holds
+ * exactly the grids last given a value, so only those need clearing.
+ */
+static void flow_fill(struct chunk *c, struct mon_flow *flow,
+		const struct monster *target)
+{
+	int limit = flow_depth() + 1;
+	int head = 0, i, d;
+
+	/* Clear the grids filled last time */
+	for (i = 0; i < flow->filled; i++) {
+		flow->dist[flow->queue[i]] = 0;
+	}
+	flow->filled = 0;
+
+	flow->dist[grid_to_i(target->grid, c->width)] = 1;
+	flow->queue[flow->filled++] = grid_to_i(target->grid, c->width);
+
+	while (head < flow->filled) {
+		struct loc next;
+		int steps;
+
+		i_to_grid(flow->queue[head], c->width, &next);
+		steps = flow->dist[flow->queue[head++]] + 1;
+
+		/* The queue is in order of distance, so we're done */
+		if (steps > limit) break;
+
+		for (d = 0; d < 8; d++) {
+			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+			int i_grid;
+
+			if (!square_in_bounds(c, grid)) continue;
+			if (square_isnoflow(c, grid)) continue;
+			i_grid = grid_to_i(grid, c->width);
+			if (flow->dist[i_grid]) continue;
+
+			flow->dist[i_grid] = steps;
+			flow->queue[flow->filled++] = i_grid;
+		}
+	}
+
+	flow->midx = target->midx;
+	flow->origin = target->grid;
+	flow->stale = false;
+}
+
+/**
+ * Get the flow field towards a monster, filling it if there isn't a usable
+ * one already.
+ *
+ * Fields are kept per chunk, one for each monster being pursued, so every
+ * monster chasing the same target shares the work of one breadth first
+ * search.  A field is refilled when its target has moved more than
+ * FLOW_SLACK grids from where it was filled, or the terrain has changed;
+ * when all the fields are in use, the one used longest ago is taken over.
+ *
+ * \param c the chunk
+ * \param target the monster being pursued
+ * \return steps from the target for each grid in row order, counting the
+ * target's own grid as 1 and unreached grids as 0
+ */
+const uint16_t *cave_monster_flow(struct chunk *c,
+		const struct monster *target)
+{
+	struct mon_flow *flow = NULL;
+	int i;
+
+	if (!c->mon_flows) {
+		c->mon_flows = mem_zalloc(MON_FLOW_MAX * sizeof(struct mon_flow));
+	}
+
+	/* Look for the target's field, or else the least recently used */
+	for (i = 0; i < MON_FLOW_MAX; i++) {
+		struct mon_flow *check = &c->mon_flows[i];
+
+		if (check->dist && check->midx == target->midx) {
+			flow = check;
+			break;
+		}
+		if (!flow || (flow->dist &&
+				(!check->dist || check->used < flow->used))) {
+			flow = check;
+		}
+	}
+
+	if (!flow->dist) {
+		flow->dist = mem_zalloc(c->height * c->width * sizeof(uint16_t));
+		flow->queue = mem_zalloc(c->height * c->width * sizeof(int));
+		flow->stale = true;
+	}
+
+	if (flow->stale || flow->midx != target->midx ||
+			distance(flow->origin, target->grid) > FLOW_SLACK) {
+		flow_fill(c, flow, target);
+	}
+	flow->used = turn;
+
+	return flow->dist;
+}
+
+/**
+ * Mark every flow field of a chunk as needing a refill, after a grid has
+ * started or stopped letting sound (and so pursuers) through
+ */
+void cave_flows_stale(struct chunk *c)
+{
+	int i;
+
+	if (!c->mon_flows) return;
+	for (i = 0; i < MON_FLOW_MAX; i++) {
+		c->mon_flows[i].stale = true;
+	}
+}
+
+/**
+ * Free the flow fields of a chunk
+ */
+void cave_flows_free(struct chunk *c)
+{
+	int i;
+
+	if (!c->mon_flows) return;
+	for (i = 0; i < MON_FLOW_MAX; i++) {
+		mem_free(c->mon_flows[i].dist);
+		mem_free(c->mon_flows[i].queue);
+	}
+	mem_free(c->mon_flows);
+	c->mon_flows = NULL;
+}
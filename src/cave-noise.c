@@ -0,0 +1,167 @@
+/**
+ * \file cave-noise.c
+ * \brief Upkeep of the noise field the player makes on a level
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+#include "player-timed.h"
+
+/**
+ * Extra steps filled past the loudest noise any monster can hear, so that
+ * a monster at the edge of hearing still sees real values around it when
+ * looking for somewhere safe (see get_move_find_safety())
+ */
+#define NOISE_MARGIN 10
+
+/**
+ * The loudest noise value that matters on a level.
+ *
+ * A monster hears the player while its hearing, less a third of the
+ * player's stealth, is greater than the noise at its grid.  Sleeping
+ * monsters are also woken faster by noise below 20 (see
+ * monster_reduce_sleep()), so the field always reaches that far.
+ */
+static int noise_cap(struct chunk *c, const struct player *p)
+{
+	int stealth = p->state.skills[SKILL_STEALTH] / 3;
+	int cap = 20;
+	int i;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		const struct monster *mon = cave_monster(c, i);
+
+		if (!mon->race) continue;
+		cap = MAX(cap, mon->race->hearing - stealth);
+	}
+
+	return cap;
+}
+
+/**
+ * Fill the noise field of a chunk with distances from the player.
+ *
+ * We mark the player's grid with 0, then fill in the noise field of every
+ * grid that the player can reach with the number of steps needed to reach
+ * that grid, times the noise increment - so higher values mean further from
+ * the player.  Grids the player can't reach, and grids beyond the limit,
+ * are left at 0.
+ *
+ * The queue is kept on the chunk between calls, and after a fill it holds
+ * exactly the grids that were given a value, so the next call only has to
+ * silence those rather than the whole level.
+ */
+static void noise_fill(struct chunk *c, struct loc origin, int increment,
+		int limit)
+{
+	struct noise_field *field = &c->noise_field;
+	int head = 0, i, d;
+
+	/* Silence the grids filled last time */
+	for (i = 0; i < field->filled; i++) {
+		struct loc grid;
+
+		i_to_grid(field->queue[i], c->width, &grid);
+		c->noise.grids[grid.y][grid.x] = 0;
+	}
+	field->filled = 0;
+
+	/* Player makes noise */
+	c->noise.grids[origin.y][origin.x] = 0;
+	field->queue[field->filled++] = grid_to_i(origin, c->width);
+
+	/* Propagate noise, one step at a time */
+	while (head < field->filled) {
+		struct loc next;
+		int noise;
+
+		i_to_grid(field->queue[head++], c->width, &next);
+		noise = c->noise.grids[next.y][next.x] + increment;
+
+		/* The queue is in order of noise, so we're done */
+		if (noise > limit) break;
+
+		/* Assign noise to the children and enqueue them */
+		for (d = 0; d < 8; d++) {
+			/* Child location */
+			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+
+			if (!square_in_bounds(c, grid)) continue;
+
+			/* Ignore features that don't transmit sound */
+			if (square_isnoflow(c, grid)) continue;
+
+			/* Skip grids that already have noise */
+			if (c->noise.grids[grid.y][grid.x] != 0) continue;
+
+			/* Skip the player grid */
+			if (loc_eq(origin, grid)) continue;
+
+			/* Save the noise */
+			c->noise.grids[grid.y][grid.x] = noise;
+
+			/* Enqueue that entry */
+			field->queue[field->filled++] = grid_to_i(grid, c->width);
+		}
+	}
+
+	field->origin = origin;
+	field->increment = increment;
+	field->limit = limit;
+	field->stale = false;
+}
+
+/**
+ * Every turn, the character makes enough noise that nearby monsters can use
+ * it to home in.
+ *
+ * This function actually just computes distance from the player; this is
+ * used in combination with the player's stealth value to determine what
+ * monsters can hear.  Monsters use this information by moving to adjacent
+ * grids with lower noise values, thereby homing in on the player even
+ * though twisty tunnels and mazes.  Monsters have a hearing value, which is
+ * the largest sound value they can detect.
+ *
+ * L: Since no monster can hear past the loudest hearing on the level, the
+ * field is only filled that far (plus a margin), and it is left alone
+ * when the player hasn't moved and no grid has started or stopped carrying
+ * sound.  Any one step by the player shifts the distance to almost every
+ * grid, so a move means a fresh fill - but only over the grids in earshot.
+ */
+void cave_update_noise(struct chunk *c, struct player *p)
+{
+	struct noise_field *field = &c->noise_field;
+	int increment = p->timed[TMD_COVERTRACKS] ? 4 : 1;
+	int limit = noise_cap(c, p) + NOISE_MARGIN * increment;
+
+	/* Allocate the queue the first time it's needed */
+	if (!field->queue) {
+		field->queue = mem_zalloc(c->height * c->width * sizeof(int));
+		field->filled = 0;
+		field->stale = true;
+	}
+
+	/* The existing field reaches far enough and is still correct */
+	if (!field->stale && loc_eq(field->origin, p->grid) &&
+		(field->increment == increment) && (field->limit >= limit)) {
+		return;
+	}
+
+	noise_fill(c, p->grid, increment, limit);
+}
@@ -21,6 +21,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "monster.h"
+#include "obj-index.h"
 #include "obj-knowledge.h"
 #include "obj-pile.h"
 #include "obj-util.h"
@@ -960,7 +961,7 @@ bool square_allows_summon(struct chunk *c, struct loc grid)
  * Below are various square-specific functions which are not predicates
  */
 
-const struct square *square(struct chunk *c, struct loc grid)
+struct square *square(struct chunk *c, struct loc grid)
 {
 	assert(square_in_bounds(c, grid));
 	return &c->squares[grid.y][grid.x];
@@ -1023,6 +1024,7 @@ bool square_holds_object(struct chunk *c, struct loc grid, struct object *obj) {
 void square_excise_object(struct chunk *c, struct loc grid, struct object *obj){
 	assert(square_in_bounds(c, grid));
 	pile_excise(&c->squares[grid.y][grid.x].obj, obj);
+	obj_index_note_pile(c, grid, true, square(c, grid)->obj != NULL);
 }
 
 /**
@@ -1245,6 +1247,12 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 	if (current_feat) c->feat_count[current_feat]--;
 	if (feat) c->feat_count[feat]++;
 
+	/* Sound now travels differently */
+	if (feat_is_no_flow(current_feat) != feat_is_no_flow(feat)) {
+		c->noise_field.stale = true;
+		cave_flows_stale(c);
+	}
+
 	/* Make the change */
 	c->squares[grid.y][grid.x].feat = feat;
 
@@ -1291,9 +1299,32 @@ void square_set_mon(struct chunk *c, struct loc grid, int midx)
  */
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
 {
+	obj_index_note_pile(c, grid, c->squares[grid.y][grid.x].obj != NULL,
+		obj != NULL);
 	c->squares[grid.y][grid.x].obj = obj;
 }
 
+/**
+ * Put an object on top of the floor pile for a square.
+ */
+void square_insert_object(struct chunk *c, struct loc grid, struct object *obj)
+{
+	obj_index_note_pile(c, grid, c->squares[grid.y][grid.x].obj != NULL,
+		true);
+	pile_insert(&c->squares[grid.y][grid.x].obj, obj);
+}
+
+/**
+ * Put an object, or a list of them, at the bottom of the floor pile for a
+ * square.
+ */
+void square_append_object(struct chunk *c, struct loc grid, struct object *obj)
+{
+	obj_index_note_pile(c, grid, c->squares[grid.y][grid.x].obj != NULL,
+		true);
+	pile_insert_end(&c->squares[grid.y][grid.x].obj, obj);
+}
+
 /**
  * Set the (first) trap for a square.
  */
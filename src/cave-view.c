@@ -429,21 +429,42 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
  */
 
 
+/**
+ * L: Is a grid inside the rectangle with the given corners?
+ */
+static bool in_region(struct loc grid, struct loc top_left,
+		struct loc bottom_right)
+{
+	return grid.x >= top_left.x && grid.x <= bottom_right.x &&
+		grid.y >= top_left.y && grid.y <= bottom_right.y;
+}
+
 /**
  * Mark the currently seen grids, then wipe in preparation for recalculating
+ *
+ * L: only grids in the given region are touched; nothing outside it can
+ * have been in view
  */
-static void mark_wasseen(struct chunk *c)
+static void mark_wasseen(struct chunk *c, struct loc top_left,
+		struct loc bottom_right)
 {
-	int x, y;
+	bitflag clear[SQUARE_SIZE];
+	int y;
+
+	sqinfo_wipe(clear);
+	sqinfo_on(clear, SQUARE_VIEW);
+	sqinfo_on(clear, SQUARE_SEEN);
+	sqinfo_on(clear, SQUARE_CLOSE_PLAYER);
+
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			if (square_isseen(c, grid))
-				sqinfo_on(square(c, grid)->info, SQUARE_WASSEEN);
-			sqinfo_off(square(c, grid)->info, SQUARE_VIEW);
-			sqinfo_off(square(c, grid)->info, SQUARE_SEEN);
-			sqinfo_off(square(c, grid)->info, SQUARE_CLOSE_PLAYER);
+	for (y = top_left.y; y <= bottom_right.y; y++) {
+		struct square *sq = &c->squares[y][top_left.x];
+		struct square *end = &c->squares[y][bottom_right.x];
+
+		for (; sq <= end; sq++) {
+			if (sqinfo_has(sq->info, SQUARE_SEEN))
+				sqinfo_on(sq->info, SQUARE_WASSEEN);
+			sqinfo_diff(sq->info, clear);
 		}
 	}
 }
@@ -608,12 +629,14 @@ static bool glow_can_light_wall(struct chunk *c, struct player *p,
  * \param sgrid Is the location of the light source.
  * \param radius Is the radius, in grids, of the light source.
  * \param inten Is the intensity of the light source.
+ * \param top_left Is the upper left corner of the region being lit.
+ * \param bottom_right Is the lower right corner of the region being lit.
  * This is a brute force approach.  Some computation probably could be saved by
  * propagating the light out from the source and terminating paths when they
  * reach a wall.
  */
 static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
-		int radius, int inten)
+		int radius, int inten, struct loc top_left, struct loc bottom_right)
 {
 	int y;
 
@@ -623,7 +646,7 @@ static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
 		for (x = -radius; x <= radius; x++) {
 			struct loc grid = loc_sum(sgrid, loc(x, y));
 			int dist = distance(sgrid, grid);
-			if (!square_in_bounds(c, grid)) continue;
+			if (!in_region(grid, top_left, bottom_right)) continue;
 			if (dist > radius) continue;
 			/* Don't propagate the light through walls. */
 			if (!los(c, sgrid, grid)) continue;
@@ -649,32 +672,49 @@ static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
 
 /**
  * Calculate light level for every grid in view - stolen from Sil
+ *
+ * L: only grids in the given region, which holds every grid that could be
+ * in view, get a light level; levels elsewhere are left stale, as nothing
+ * looks at the light of a grid out of view.
  */
-static void calc_lighting(struct chunk *c, struct player *p)
+static void calc_lighting(struct chunk *c, struct player *p,
+		struct loc top_left, struct loc bottom_right)
 {
 	int dir, k, x, y;
 	int light = p->state.cur_light, radius = ABS(light) - 1;
 	int old_light = square_light(c, p->grid);
+	bool stale = !in_region(p->grid, c->view_top_left, c->view_bottom_right);
 
-	/* Starting values based on permanent light */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	/*
+	 * Starting values based on permanent light.  Bright terrain up to one
+	 * grid outside the region still lights grids inside it, so take in a
+	 * border; the raster order is kept so that later starting values
+	 * overwrite earlier brightening just as in a whole-level pass.
+	 */
+	for (y = MAX(top_left.y - 1, 0);
+			y <= MIN(bottom_right.y + 1, c->height - 1); y++) {
+		for (x = MAX(top_left.x - 1, 0);
+				x <= MIN(bottom_right.x + 1, c->width - 1); x++) {
 			struct loc grid = loc(x, y);
-
-			if (square_isglow(c, grid) &&
-					(square_allowslos(c, grid) ||
-					glow_can_light_wall(c, p, grid))) {
-				c->squares[y][x].light = 1;
-			} else {
-				c->squares[y][x].light = 0;
+			bool inside = in_region(grid, top_left, bottom_right);
+
+			if (inside) {
+				if (square_isglow(c, grid) &&
+						(square_allowslos(c, grid) ||
+						glow_can_light_wall(c, p, grid))) {
+					c->squares[y][x].light = 1;
+				} else {
+					c->squares[y][x].light = 0;
+				}
 			}
 
 			/* Squares with bright terrain have intensity 2 */
 			if (square_isbright(c, grid)) {
-				c->squares[y][x].light += 2;
+				if (inside) c->squares[y][x].light += 2;
 				for (dir = 0; dir < 8; dir++) {
 					struct loc adj_grid = loc_sum(grid, ddgrid_ddd[dir]);
-					if (!square_in_bounds(c, adj_grid)) continue;
+					if (!in_region(adj_grid, top_left, bottom_right))
+						continue;
 					/*
 					 * Only brighten a wall if the player
 					 * is in position to view the face
@@ -691,7 +731,7 @@ static void calc_lighting(struct chunk *c, struct player *p)
 	}
 
 	/* Light around the player */
-	add_light(c, p, p->grid, radius, light);
+	add_light(c, p, p->grid, radius, light, top_left, bottom_right);
 
 	/* Scan monster list and add monster light or darkness */
 	for (k = 1; k < cave_monster_max(c); k++) {
@@ -715,11 +755,11 @@ static void calc_lighting(struct chunk *c, struct player *p)
 		if (distance(p->grid, mon->grid) - radius > z_info->max_sight)
 			continue;
 
-		add_light(c, p, mon->grid, radius, light);
+		add_light(c, p, mon->grid, radius, light, top_left, bottom_right);
 	}
 
 	/* Update light level indicator */
-	if (square_light(c, p->grid) != old_light) {
+	if (stale || square_light(c, p->grid) != old_light) {
 		p->upkeep->redraw |= PR_LIGHT;
 	}
 }
@@ -825,7 +865,7 @@ static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
 	}
 
 	if (los(c, p->grid, loc(xc, yc))) {
-		const struct square *sqr = square(c, grid);
+		struct square *sqr = square(c, grid);
 		become_viewable(c, grid, p, close);
 		/* L: give exp for exploration */
 		if (!sqinfo_has(sqr->info, SQUARE_GAVE_EXP) && (c->depth > 0)) {
@@ -878,16 +918,35 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 
 /**
  * Update the player's current view
+ *
+ * L: only grids within max_sight of the player can come into view, and only
+ * grids the last update covered can still be marked as in view, so the work
+ * is confined to the rectangle holding both.
  */
 void update_view(struct chunk *c, struct player *p)
 {
+	struct loc top_left, bottom_right, old_top_left, old_bottom_right;
 	int x, y;
 
+	/* Grids which might be in view now */
+	top_left.x = MAX(p->grid.x - z_info->max_sight, 0);
+	top_left.y = MAX(p->grid.y - z_info->max_sight, 0);
+	bottom_right.x = MIN(p->grid.x + z_info->max_sight, c->width - 1);
+	bottom_right.y = MIN(p->grid.y + z_info->max_sight, c->height - 1);
+
+	/* Grids which might have been in view before */
+	old_top_left.x = MIN(top_left.x, c->view_top_left.x);
+	old_top_left.y = MIN(top_left.y, c->view_top_left.y);
+	old_bottom_right.x = MAX(bottom_right.x, c->view_bottom_right.x);
+	old_bottom_right.y = MAX(bottom_right.y, c->view_bottom_right.y);
+
 	/* Record the current view */
-	mark_wasseen(c);
+	mark_wasseen(c, old_top_left, old_bottom_right);
 
 	/* Calculate light levels */
-	calc_lighting(c, p);
+	calc_lighting(c, p, top_left, bottom_right);
+	c->view_top_left = top_left;
+	c->view_bottom_right = bottom_right;
 
 	/* Assume we can view the player grid */
 	sqinfo_on(square(c, p->grid)->info, SQUARE_VIEW);
@@ -908,13 +967,13 @@ void update_view(struct chunk *c, struct player *p)
 	}
 
 	/* Squares we have LOS to get marked as in the view, and perhaps seen */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	for (y = top_left.y; y <= bottom_right.y; y++)
+		for (x = top_left.x; x <= bottom_right.x; x++)
 			update_view_one(c, loc(x, y), p);
 
 	/* Update each grid */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	for (y = old_top_left.y; y <= old_bottom_right.y; y++)
+		for (x = old_top_left.x; x <= old_bottom_right.x; x++)
 			update_one(c, loc(x, y), p);
 }
 
@@ -24,6 +24,8 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
+#include "obj-index.h"
 #include "monster.h"
 #include "obj-ignore.h"
 #include "obj-pile.h"
@@ -32,6 +34,7 @@
 #include "object.h"
 #include "player-timed.h"
 #include "trap.h"
+#include "z-hash.h"
 
 struct feature *f_info;
 struct chunk *cave = NULL;
@@ -279,23 +282,40 @@ struct loc next_grid(struct loc grid, int dir)
 	return loc(grid.x + ddgrid[dir].x, grid.y + ddgrid[dir].y);
 }
 
+/**
+ * L: Index of f_info by name; built the first time it is needed and freed
+ * along with f_info
+ */
+static struct hash_index feat_by_name;
+
+void lookup_feat_index_free(void)
+{
+	hash_index_free(&feat_by_name);
+}
+
 /**
  * Find a terrain feature index by its printable name.
  */
 int lookup_feat(const char *name)
 {
-	int i;
+	uint32_t hash = djb2_hash(name);
+	size_t probe = 0;
+	int i, found = -1;
+
+	if (!feat_by_name.count) {
+		for (i = 0; i < FEAT_MAX; i++) {
+			if (f_info[i].name) {
+				hash_index_add(&feat_by_name, djb2_hash(f_info[i].name), i);
+			}
+		}
+	}
 
 	/* Look for it */
-	for (i = 0; i < FEAT_MAX; i++) {
-		struct feature *feat = &f_info[i];
-		if (!feat->name)
-			continue;
-
-		/* Test for equality */
-		if (streq(name, feat->name))
-			return i;
+	while ((i = hash_index_next(&feat_by_name, hash, &probe)) >= 0) {
+		if ((found < 0 || i < found) && streq(name, f_info[i].name))
+			found = i;
 	}
+	if (found >= 0) return found;
 
 	/* Fail horribly */
 	quit_fmt("Failed to find terrain feature %s", name);
@@ -342,27 +362,35 @@ const char *get_feat_code_name(int idx)
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y;
+	struct square *squares;
+	uint16_t *noise, *scent;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((FEAT_MAX + 1) * sizeof(int));
 
+	/* L: each grid array is one row-major buffer, with rows pointing in */
+	squares = mem_zalloc(c->height * c->width * sizeof(struct square));
+	noise = mem_zalloc(c->height * c->width * sizeof(uint16_t));
+	scent = mem_zalloc(c->height * c->width * sizeof(uint16_t));
 	c->squares = mem_zalloc(c->height * sizeof(struct square*));
 	c->noise.grids = mem_zalloc(c->height * sizeof(uint16_t*));
 	c->scent.grids = mem_zalloc(c->height * sizeof(uint16_t*));
 	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-		}
-		c->noise.grids[y] = mem_zalloc(c->width * sizeof(uint16_t));
-		c->scent.grids[y] = mem_zalloc(c->width * sizeof(uint16_t));
+		c->squares[y] = squares + y * c->width;
+		c->noise.grids[y] = noise + y * c->width;
+		c->scent.grids[y] = scent + y * c->width;
 	}
 
+	/* L: nothing is known about the view yet, so the first update covers all */
+	c->view_top_left = loc(0, 0);
+	c->view_bottom_right = loc(width - 1, height - 1);
+
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
+	c->obj_index = obj_index_new(height, width);
 
 	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
 	c->mon_max = 1;
@@ -370,6 +398,8 @@ struct chunk *cave_new(int height, int width) {
 
 	c->monster_groups = mem_zalloc(z_info->level_monster_max *
 								   sizeof(struct monster_group*));
+	c->mon_index = mon_index_new(height, width);
+	c->noise_field.stale = true;
 
 	c->turn = turn;
 	return c;
@@ -393,29 +423,23 @@ void cave_connectors_free(struct connector *join)
  * Free a chunk
  */
 void cave_free(struct chunk *c) {
-	struct chunk *p_c = (c == cave && player) ? player->cave : NULL;
-	int y, x, i;
+	int y, x;
 
 	cave_connectors_free(c->join);
 
-	/* Look for orphaned objects and delete them. */
-	for (i = 1; i < c->obj_max; i++) {
-		if (c->objects[i] && loc_is_zero(c->objects[i]->grid)) {
-			object_delete(c, p_c, &c->objects[i]);
-		}
-	}
+	/* L: give back the floor piles and orphaned objects all at once */
+	object_free_chunk(c);
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
 			if (c->squares[y][x].trap)
 				square_free_trap(c, loc(x, y));
-			if (c->squares[y][x].obj)
-				object_pile_free(c, p_c, c->squares[y][x].obj);
 		}
-		mem_free(c->squares[y]);
-		mem_free(c->noise.grids[y]);
-		mem_free(c->scent.grids[y]);
+	}
+	if (c->height) {
+		mem_free(c->squares[0]);
+		mem_free(c->noise.grids[0]);
+		mem_free(c->scent.grids[0]);
 	}
 	mem_free(c->squares);
 	mem_free(c->noise.grids);
@@ -423,8 +447,14 @@ void cave_free(struct chunk *c) {
 
 	mem_free(c->feat_count);
 	mem_free(c->objects);
+	obj_index_free(c->obj_index);
 	mem_free(c->monsters);
 	mem_free(c->monster_groups);
+	mon_index_free(c->mon_index);
+	mem_free(c->noise_field.queue);
+	cave_flows_free(c);
+	mem_free(c->save_data);
+	mem_free(c->stub_races);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
@@ -720,3 +750,73 @@ struct loc cave_find_decoy(struct chunk *c)
 {
 	return c->decoy;
 }
+
+/**
+ * L: Start walking the regions of a level from the given centre region
+ */
+void region_ring_init(struct region_ring *walk, int rows, int cols, int rx,
+	int ry)
+{
+	walk->rows = rows;
+	walk->cols = cols;
+	walk->rx = rx;
+	walk->ry = ry;
+	walk->max_ring = MAX(MAX(rx, cols - 1 - rx), MAX(ry, rows - 1 - ry));
+	walk->ring = 0;
+	walk->dx = 0;
+	walk->dy = 0;
+	walk->x = rx;
+	walk->y = ry;
+}
+
+/**
+ * L: Step a walk to the next region on the level, working outwards one ring
+ * at a time.  Returns false when every region has been visited.
+ */
+bool region_ring_next(struct region_ring *walk)
+{
+	while (1) {
+		int k = walk->ring;
+
+		if (k && ABS(walk->dy) == k && walk->dx < k) {
+			/* Top and bottom rows of the ring */
+			walk->dx++;
+		} else if (k && walk->dx == -k) {
+			/* Sides of the ring */
+			walk->dx = k;
+		} else if (k && walk->dy < k) {
+			/* Next row of the ring */
+			walk->dy++;
+			walk->dx = -k;
+			if (walk->ry + walk->dy >= walk->rows) {
+				/* The rest of the ring is off the level */
+				walk->dy = k;
+				walk->dx = k;
+				continue;
+			}
+		} else {
+			/* Next ring, starting at the first row on the level */
+			if (walk->ring >= walk->max_ring) return false;
+			walk->ring++;
+			walk->dy = MAX(-walk->ring, -walk->ry);
+			walk->dx = -walk->ring;
+		}
+
+		walk->x = walk->rx + walk->dx;
+		walk->y = walk->ry + walk->dy;
+		if (walk->x >= 0 && walk->x < walk->cols && walk->y >= 0
+				&& walk->y < walk->rows) {
+			return true;
+		}
+	}
+}
+
+/**
+ * L: Lower bound on the distance() from any grid of the centre region to
+ * any grid of the current ring or a later one, for regions of the given
+ * side length
+ */
+int region_ring_bound(const struct region_ring *walk, int size)
+{
+	return walk->ring ? (walk->ring - 1) * size + 1 : 0;
+}
@@ -25,6 +25,7 @@
 struct player;
 struct monster;
 struct monster_group;
+struct monster_index;
 
 extern const int16_t ddd[9];
 extern const int16_t ddx[10];
@@ -160,7 +161,7 @@ struct grid_data {
 
 struct square {
 	uint8_t feat;
-	bitflag *info;
+	bitflag info[SQUARE_SIZE];
 	int light;
 	int16_t mon;
 	struct object *obj;
@@ -171,6 +172,41 @@ struct heatmap {
 	uint16_t **grids;
 };
 
+/**
+ * L: What the last update of a chunk's noise heatmap did, so the next one
+ * can tell whether it has any work to do
+ */
+struct noise_field {
+	int *queue;			/**< Grids given noise by the last fill, in order */
+	int filled;			/**< Number of grids in the queue */
+	struct loc origin;	/**< Grid the noise came from */
+	int increment;		/**< Noise added per step */
+	int limit;			/**< Loudest noise value filled in */
+	bool stale;			/**< Terrain carrying sound has changed since */
+};
+
+/**
+ * L: Most flow fields a chunk keeps towards monsters being pursued
+ */
+#define MON_FLOW_MAX 8
+
+/**
+ * L: A flow field leading to a monster other monsters are pursuing; see
+ * cave_monster_flow().  Fields are kept per target rather than per faction
+ * (monster.h's faction glyph): members of one faction may be after
+ * different monsters, and a field filled from its own target leads exactly
+ * to it.
+ */
+struct mon_flow {
+	int midx;			/**< Monster the field leads to */
+	struct loc origin;	/**< Its grid when the field was filled */
+	uint16_t *dist;		/**< Steps from origin by grid, 0 if unreached */
+	int *queue;			/**< Grids given steps by the last fill, in order */
+	int filled;			/**< Number of grids in the queue */
+	int32_t used;		/**< Game turn the field was last asked for */
+	bool stale;			/**< Terrain carrying sound has changed since */
+};
+
 struct connector {
 	struct loc grid;
 	uint8_t feat;
@@ -195,13 +231,18 @@ struct chunk {
 	int *feat_count;
 	int squares_everseen; /* L: how many suares have been XP-checked */
 
-	struct square **squares;
+	struct square **squares;	/* L: row pointers into one buffer */
+	struct loc view_top_left;	/* L: region update_view() last covered */
+	struct loc view_bottom_right;
 	struct heatmap noise;
+	struct noise_field noise_field;
+	struct mon_flow *mon_flows;	/* L: MON_FLOW_MAX fields, made when needed */
 	struct heatmap scent;
 	struct loc decoy;
 
 	struct object **objects;
 	uint16_t obj_max;
+	struct object_index *obj_index;
 
 	struct monster *monsters;
 	uint16_t mon_max;
@@ -210,8 +251,30 @@ struct chunk {
 	int num_repro;
 
 	struct monster_group **monster_groups;
+	struct monster_index *mon_index;
 
 	struct connector *join;
+
+	uint8_t *save_data;			/* L: savefile encoding of a stored chunk */
+	uint32_t save_len;			/* L: length of save_data */
+	bool encoded;				/* L: only save_data holds the contents */
+	struct monster_race **stub_races;	/* L: races of an encoded chunk's monsters */
+	uint16_t stub_race_count;
+	uint32_t full_size;			/* L: chunk_memory() before chunk_freeze() */
+};
+
+/**
+ * L: Walks a level split into rows by cols square regions, in rings of
+ * regions around a centre one, nearest ring first; the spatial indices use
+ * it to visit their regions roughly nearest first.
+ */
+struct region_ring {
+	int rows, cols;		/**< Number of region rows and columns */
+	int rx, ry;			/**< Centre region */
+	int ring;			/**< Current ring */
+	int max_ring;		/**< Last ring holding any region of the level */
+	int dx, dy;			/**< Current region, relative to the centre one */
+	int x, y;			/**< Current region */
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -228,6 +291,15 @@ extern struct chunk *cave;
 extern struct chunk **chunk_list;
 extern uint16_t chunk_list_max;
 
+/* cave-flow.c */
+const uint16_t *cave_monster_flow(struct chunk *c,
+	const struct monster *target);
+void cave_flows_stale(struct chunk *c);
+void cave_flows_free(struct chunk *c);
+
+/* cave-noise.c */
+void cave_update_noise(struct chunk *c, struct player *p);
+
 /* cave-view.c */
 int distance(struct loc grid1, struct loc grid2);
 bool los(struct chunk *c, struct loc grid1, struct loc grid2);
@@ -364,7 +436,7 @@ bool square_suits_stairs_ok(struct chunk *c, struct loc grid);
 bool square_allows_summon(struct chunk *c, struct loc grid);
 
 
-const struct square *square(struct chunk *c, struct loc grid);
+struct square *square(struct chunk *c, struct loc grid);
 struct feature *square_feat(struct chunk *c, struct loc grid);
 int square_light(struct chunk *c, struct loc grid);
 struct monster *square_monster(struct chunk *c, struct loc grid);
@@ -388,6 +460,8 @@ int square_num_walls_diagonal(struct chunk *c, struct loc grid);
 void square_set_feat(struct chunk *c, struct loc grid, int feat);
 void square_set_mon(struct chunk *c, struct loc grid, int midx);
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj);
+void square_insert_object(struct chunk *c, struct loc grid, struct object *obj);
+void square_append_object(struct chunk *c, struct loc grid, struct object *obj);
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap);
 void square_add_trap(struct chunk *c, struct loc grid);
 void square_add_glyph(struct chunk *c, struct loc grid, int type);
@@ -428,6 +502,7 @@ void square_unmark(struct chunk *c, struct loc grid);
 /* cave.c */
 int motion_dir(struct loc source, struct loc target);
 struct loc next_grid(struct loc grid, int dir);
+void lookup_feat_index_free(void);
 int lookup_feat(const char *name);
 int lookup_feat_code(const char *code);
 const char *get_feat_code_name(int idx);
@@ -451,6 +526,10 @@ int count_feats(struct loc *grid,
 int count_neighbors(struct loc *match, struct chunk *c, struct loc grid,
 	bool (*test)(struct chunk *c, struct loc grid), bool under);
 struct loc cave_find_decoy(struct chunk *c);
+void region_ring_init(struct region_ring *walk, int rows, int cols, int rx,
+	int ry);
+bool region_ring_next(struct region_ring *walk);
+int region_ring_bound(const struct region_ring *walk, int size);
 
 void cave_known(struct player *p);
 
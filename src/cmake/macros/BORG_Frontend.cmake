@@ -0,0 +1,7 @@
+MACRO(CONFIGURE_BORG_FRONTEND _NAME_TARGET)
+
+    TARGET_COMPILE_DEFINITIONS(${_NAME_TARGET} PRIVATE -D USE_BORG)
+    TARGET_COMPILE_DEFINITIONS(${_NAME_TARGET} PRIVATE -D ALLOW_BORG)
+    MESSAGE(STATUS "Support for Borg front end - Ready")
+
+ENDMACRO()
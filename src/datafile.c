@@ -86,6 +86,177 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 	return parse_err;
 }
 
+/**
+ * L: Snapshots of parsed data files
+ *
+ * Splitting the lines of the data files into directives and values is a good
+ * part of the work of starting up.  So the first time a file is parsed, the
+ * directives are recorded (see parser_record_start()) and saved in
+ * ANGBAND_DIR_CACHE, under the user directory unless it has been moved
+ * elsewhere.  Later parses of the same text replay
+ * the recording through the same hooks instead of reading the text again.
+ *
+ * A snapshot is only used if it was made from a file with the same path and
+ * contents, so editing a data file or adding one to the user directory makes
+ * a fresh one, and by a parser with the same hooks; what the hooks do with
+ * the values is up to the code that is running, so changing that needs no
+ * new snapshot.
+ */
+#define SNAPSHOT_MAGIC		0x4e53424cU
+#define SNAPSHOT_VERSION	1
+
+/**
+ * Whether parse_file() uses and makes snapshots; front ends that are played
+ * turn this on, as do the tests with a cache directory of their own, so that
+ * tools and unattended runs leave no files in the user directory
+ */
+bool parse_snapshots = false;
+
+static struct parse_snapshot_counts snapshot_counts;
+
+struct snapshot_header {
+	uint32_t magic;			/**< SNAPSHOT_MAGIC, which also checks byte order */
+	uint32_t version;		/**< SNAPSHOT_VERSION */
+	uint32_t signature;		/**< parser_signature() of the recording parser */
+	uint32_t lines;			/**< Lines in the source file */
+	uint64_t source_hash;	/**< Hash of the source path and text */
+	uint64_t data_hash;		/**< Hash of the recording */
+	uint64_t data_len;		/**< Length of the recording */
+};
+
+/**
+ * Hash some bytes, eight at a time where possible
+ */
+static uint64_t snapshot_hash(uint64_t hash, const char *data, size_t len)
+{
+	while (len >= 8) {
+		uint64_t word;
+
+		memcpy(&word, data, sizeof(word));
+		hash = (hash ^ word) * 0x100000001b3ULL;
+		hash ^= hash >> 29;
+		data += 8;
+		len -= 8;
+	}
+	while (len--)
+		hash = (hash ^ (uint8_t)*data++) * 0x100000001b3ULL;
+
+	return hash;
+}
+
+/**
+ * Hash the path and the contents of an open data file
+ */
+static uint64_t snapshot_source_hash(const char *path, ang_file *fh)
+{
+	uint64_t hash = snapshot_hash(0xcbf29ce484222325ULL, path, strlen(path));
+	char *buf = mem_alloc(65536);
+	int n;
+
+	while ((n = file_read(fh, buf, 65536)) > 0)
+		hash = snapshot_hash(hash, buf, n);
+	mem_free(buf);
+
+	return hash;
+}
+
+/**
+ * Build the path of the snapshot for a data file
+ */
+static bool snapshot_path(char *buf, size_t len, const char *filename)
+{
+	if (!ANGBAND_DIR_CACHE) return false;
+	path_build(buf, len, ANGBAND_DIR_CACHE, format("%s.snap", filename));
+	return true;
+}
+
+/**
+ * Replay the snapshot of a data file if there is an up to date one; returns
+ * false if there is not, or true with the result of the replay in r.
+ */
+static bool snapshot_load(struct parser *p, const char *filename,
+		uint64_t source_hash, errr *r)
+{
+	char path[1024];
+	struct snapshot_header head;
+	ang_file *fh;
+	char *data;
+	bool good;
+
+	if (!snapshot_path(path, sizeof(path), filename)) return false;
+	fh = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!fh) return false;
+
+	good = file_read(fh, (char *)&head, sizeof(head)) == sizeof(head)
+		&& head.magic == SNAPSHOT_MAGIC
+		&& head.version == SNAPSHOT_VERSION
+		&& head.source_hash == source_hash
+		&& head.signature == parser_signature(p)
+		&& head.data_len < 0x10000000;
+	if (!good) {
+		file_close(fh);
+		return false;
+	}
+
+	data = mem_alloc(head.data_len + 1);
+	good = file_read(fh, data, head.data_len) == (int)head.data_len
+		&& snapshot_hash(0xcbf29ce484222325ULL, data, head.data_len)
+		== head.data_hash;
+	file_close(fh);
+
+	if (good) {
+		*r = parser_replay(p, data, head.data_len, head.lines);
+		snapshot_counts.replayed++;
+	}
+	mem_free(data);
+	return good;
+}
+
+/**
+ * Save what the parser has recorded as the snapshot of a data file
+ */
+static void snapshot_save(struct parser *p, const char *filename,
+		uint64_t source_hash)
+{
+	char path[1024], tmp[1024], dir[1024];
+	struct snapshot_header head;
+	ang_file *fh;
+	const char *data;
+	size_t len;
+	unsigned int lines;
+	bool good;
+
+	data = parser_recorded(p, &len, &lines);
+	if (!data || !snapshot_path(path, sizeof(path), filename)) return;
+	path_build(dir, sizeof(dir), ANGBAND_DIR_CACHE, "");
+	if (!dir_create(dir)) return;
+
+	memset(&head, 0, sizeof(head));
+	head.magic = SNAPSHOT_MAGIC;
+	head.version = SNAPSHOT_VERSION;
+	head.signature = parser_signature(p);
+	head.lines = lines;
+	head.source_hash = source_hash;
+	head.data_hash = snapshot_hash(0xcbf29ce484222325ULL, data, len);
+	head.data_len = len;
+
+	/* Write to the side and move into place, so no one reads half a file */
+	strnfmt(tmp, sizeof(tmp), "%s.new", path);
+	fh = file_open(tmp, MODE_WRITE, FTYPE_RAW);
+	if (!fh) return;
+	good = file_write(fh, (const char *)&head, sizeof(head))
+		&& file_write(fh, data, len);
+	good = file_close(fh) && good;
+	if (good) {
+		file_delete(path);
+		good = file_move(tmp, path);
+	}
+	if (good)
+		snapshot_counts.made++;
+	else
+		file_delete(tmp);
+}
+
 /**
  * The basic file parsing function.
  */
@@ -94,6 +265,7 @@ errr parse_file(struct parser *p, const char *filename) {
 	char buf[1024];
 	ang_file *fh;
 	errr r = 0;
+	uint64_t source_hash = 0;
 
 	/* The player can put a customised file in the user directory */
 	path_build(path, sizeof(path), ANGBAND_DIR_USER, format("%s.txt",
@@ -111,6 +283,21 @@ errr parse_file(struct parser *p, const char *filename) {
 	if (!fh)
 		return PARSE_ERROR_NO_FILE_FOUND;
 
+	/* Use the snapshot if it is up to date */
+	if (parse_snapshots) {
+		source_hash = snapshot_source_hash(path, fh);
+		file_close(fh);
+		if (snapshot_load(p, filename, source_hash, &r))
+			return r;
+
+		fh = file_open(path, MODE_READ, FTYPE_TEXT);
+		if (!fh)
+			return PARSE_ERROR_NO_FILE_FOUND;
+
+		/* Record the directives for next time */
+		parser_record_start(p);
+	}
+
 	/* Parse it */
 	while (file_getl(fh, buf, sizeof(buf))) {
 		r = parser_parse(p, buf);
@@ -118,6 +305,9 @@ errr parse_file(struct parser *p, const char *filename) {
 			break;
 	}
 	file_close(fh);
+	if (parse_snapshots && !r)
+		snapshot_save(p, filename, source_hash);
+	parser_record_stop(p);
 	return r;
 }
 
@@ -126,6 +316,14 @@ void cleanup_parser(struct file_parser *fp)
 	fp->cleanup();
 }
 
+/**
+ * L: Get the counts of snapshots made and replayed
+ */
+const struct parse_snapshot_counts *parse_snapshot_counts(void)
+{
+	return &snapshot_counts;
+}
+
 int lookup_flag(const char **flag_table, const char *flag_name) {
 	int i = FLAG_START;
 
@@ -30,12 +30,22 @@ struct file_parser {
 	void (*cleanup)(void);
 };
 
+/**
+ * L: Counts of the snapshots parse_file() has made and replayed
+ */
+struct parse_snapshot_counts {
+	uint32_t made;		/* Snapshots written */
+	uint32_t replayed;	/* Snapshots used in place of the text */
+};
+
 extern const char *parser_error_str[PARSE_ERROR_MAX];
+extern bool parse_snapshots;
 
 errr run_parser(struct file_parser *fp);
 errr parse_file_quit_not_found(struct parser *p, const char *filename);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
+const struct parse_snapshot_counts *parse_snapshot_counts(void);
 int lookup_flag(const char **flag_table, const char *flag_name);
 int code_index_in_array(const char *code_name[], const char *code);
 errr grab_rand_value(random_value *value, const char **value_type,
@@ -38,7 +38,6 @@
 #include "source.h"
 #include "target.h"
 #include "trap.h"
-#include "z-queue.h"
 
 uint16_t daycount = 0;
 uint32_t seed_randart;		/* Hack -- consistent random artifacts */
@@ -370,81 +369,6 @@ static void decrease_timeouts(void)
 }
 
 
-/**
- * Every turn, the character makes enough noise that nearby monsters can use
- * it to home in.
- *
- * This function actually just computes distance from the player; this is
- * used in combination with the player's stealth value to determine what
- * monsters can hear.  We mark the player's grid with 0, then fill in the noise
- * field of every grid that the player can reach with that "noise"
- * (actally distance) plus the number of steps needed to reach that grid
- * - so higher values mean further from the player.
- *
- * Monsters use this information by moving to adjacent grids with lower noise
- * values, thereby homing in on the player even though twisty tunnels and
- * mazes.  Monsters have a hearing value, which is the largest sound value
- * they can detect.
- */
-static void make_noise(struct player *p)
-{
-	struct loc next = p->grid;
-	int y, x, d;
-	int noise = 0;
-	int noise_increment = p->timed[TMD_COVERTRACKS] ? 4 : 1;
-    struct queue *queue = q_new(cave->height * cave->width);
-
-	/* Set all the grids to silence */
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			cave->noise.grids[y][x] = 0;
-		}
-	}
-
-	/* Player makes noise */
-	cave->noise.grids[next.y][next.x] = noise;
-	q_push_int(queue, grid_to_i(next, cave->width));
-	noise += noise_increment;
-
-	/* Propagate noise */
-	while (q_len(queue) > 0) {
-		/* Get the next grid */
-		i_to_grid(q_pop_int(queue), cave->width, &next);
-
-		/* If we've reached the current noise level, put it back and step */
-		if (cave->noise.grids[next.y][next.x] == noise) {
-			q_push_int(queue, grid_to_i(next, cave->width));
-			noise += noise_increment;
-			continue;
-		}
-
-		/* Assign noise to the children and enqueue them */
-		for (d = 0; d < 8; d++)	{
-			/* Child location */
-			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
-
-			if (!square_in_bounds(cave, grid)) continue;
-
-			/* Ignore features that don't transmit sound */
-			if (square_isnoflow(cave, grid)) continue;
-
-			/* Skip grids that already have noise */
-			if (cave->noise.grids[grid.y][grid.x] != 0) continue;
-
-			/* Skip the player grid */
-			if (loc_eq(p->grid, grid)) continue;
-
-			/* Save the noise */
-			cave->noise.grids[grid.y][grid.x] = noise;
-
-			/* Enqueue that entry */
-			q_push_int(queue, grid_to_i(grid, cave->width));
-		}
-	}
-
-	q_free(queue);
-}
-
 /**
  * Characters leave scent trails for perceptive monsters to track.
  *
@@ -738,7 +662,7 @@ void process_world(struct chunk *c)
 
 	/* Update noise and scent (not if resting) */
 	if (!player_is_resting(player) && !player->upkeep->generate_level) {
-		make_noise(player);
+		cave_update_noise(cave, player);
 		update_scent();
 	}
 
@@ -68,6 +68,7 @@
 #include "generate.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-make.h"
 #include "mon-spell.h"
 #include "mon-util.h"
@@ -4025,6 +4026,7 @@ struct chunk *arena_gen(struct player *p, int min_height, int min_width) {
 	square_set_mon(c, mon->grid, mon->midx);
 	c->mon_max = mon->midx + 1;
 	c->mon_cnt = 1;
+	mon_index_add(c, mon);
 	update_mon(mon, c, true);
 	p->upkeep->health_who = mon;
 
@@ -29,8 +29,11 @@
 #include "generate.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-make.h"
+#include "obj-pile.h"
 #include "obj-util.h"
+#include "savefile.h"
 #include "trap.h"
 
 #define CHUNK_LIST_INCR 10
@@ -61,6 +64,19 @@ struct chunk *chunk_write(struct chunk *c)
 	return new;
 }
 
+/**
+ * Note that a stored chunk has changed, so the savefile encoding kept from
+ * the last save no longer describes it
+ * \param c the chunk which has changed
+ */
+void chunk_dirty(struct chunk *c)
+{
+	assert(!c->encoded);
+	mem_free(c->save_data);
+	c->save_data = NULL;
+	c->save_len = 0;
+}
+
 /**
  * Add an entry to the chunk list - any problems with the length of this will
  * be more in the memory used by the chunks themselves rather than the list
@@ -75,6 +91,7 @@ void chunk_list_add(struct chunk *c)
 		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
 
 	/* Add the new one */
+	chunk_dirty(c);
 	chunk_list[chunk_list_max++] = c;
 }
 
@@ -92,6 +109,9 @@ bool chunk_list_remove(const char *name)
 		if (streq(name, chunk_list[i]->name)) {
 			/* Copy all the succeeding chunks back one */
 			int j;
+
+			/* It is about to change, so the saved copy is no use */
+			chunk_dirty(chunk_list[i]);
 			for (j = i + 1; j < chunk_list_max; j++) {
 				chunk_list[j - 1] = chunk_list[j];
 			}
@@ -112,6 +132,24 @@ bool chunk_list_remove(const char *name)
  * \return the pointer to the chunk
  */
 struct chunk *chunk_find_name(const char *name)
+{
+	struct chunk *c = chunk_peek_name(name);
+
+	/* L: chunks from a savefile are only read when wanted */
+	if (c && !chunk_decode(c)) {
+		quit_fmt("Couldn't read stored level %s", name);
+	}
+
+	return c;
+}
+
+/**
+ * L: Find a chunk by name, without decoding it if it is still as it was
+ * read from the savefile; only its name, depth and connectors are usable
+ * \param name the name of the chunk being sought
+ * \return the pointer to the chunk
+ */
+struct chunk *chunk_peek_name(const char *name)
 {
 	int i;
 
@@ -122,6 +160,113 @@ struct chunk *chunk_find_name(const char *name)
 	return NULL;
 }
 
+/**
+ * L: Pack a stored chunk down to its savefile encoding, as though it had just
+ * been read from a savefile; chunk_find_name() unpacks it again.  Nothing it
+ * holds leaves play: its monsters' races stay counted and its artifacts stay
+ * created.
+ * \param c the chunk, which must be on the chunk list and keeps its address
+ */
+void chunk_freeze(struct chunk *c)
+{
+	struct chunk *full;
+	size_t full_size;
+	int i, count = 0;
+
+	if (c->encoded) return;
+	assert(chunk_find(c));
+	full_size = chunk_memory(c);
+	chunk_encode(c);
+
+	/* Move the contents out, keeping what rd_chunks_2() would have read */
+	full = mem_alloc(sizeof(*full));
+	*full = *c;
+	memset(c, 0, sizeof(*c));
+	c->name = full->name;
+	full->name = NULL;
+	c->depth = full->depth;
+	c->join = full->join;
+	full->join = NULL;
+	c->save_data = full->save_data;
+	c->save_len = full->save_len;
+	full->save_data = NULL;
+	c->full_size = full_size;
+
+	for (i = 1; i < cave_monster_max(full); i++) {
+		if (cave_monster(full, i)->race) count++;
+	}
+	c->stub_races = mem_zalloc(MAX(count, 1) * sizeof(*c->stub_races));
+	for (i = 1; i < cave_monster_max(full); i++) {
+		struct monster *mon = cave_monster(full, i);
+
+		if (!mon->race) continue;
+		c->stub_races[c->stub_race_count++] = mon->original_race ?
+			mon->original_race : mon->race;
+	}
+	c->encoded = true;
+
+	/* Free the rest without the bookkeeping of monsters leaving play */
+	for (i = 1; i < cave_monster_max(full); i++) {
+		struct monster *mon = cave_monster(full, i);
+
+		if (mon->held_obj) object_pile_free(full, NULL, mon->held_obj);
+	}
+	for (i = 1; i < z_info->level_monster_max; i++) {
+		if (full->monster_groups[i]) {
+			monster_group_free(full, full->monster_groups[i]);
+		}
+	}
+	cave_free(full);
+}
+
+/**
+ * L: Approximate heap memory held by a chunk, for comparing packed ones
+ * with the rest
+ * \param c the chunk
+ * \return the number of bytes
+ */
+size_t chunk_memory(const struct chunk *c)
+{
+	size_t size = sizeof(*c) + c->save_len;
+	size_t grids = (size_t) c->height * c->width;
+	struct connector *join;
+	int i;
+
+	if (c->name) size += strlen(c->name) + 1;
+	for (join = c->join; join; join = join->next) {
+		size += sizeof(*join) + SQUARE_SIZE;
+	}
+	if (c->encoded) {
+		return size + c->stub_race_count * sizeof(*c->stub_races);
+	}
+
+	/* Grids, and the noise and scent maps */
+	size += grids * (sizeof(struct square) + 2 * sizeof(uint16_t));
+	size += c->height * (sizeof(struct square *) + 2 * sizeof(uint16_t *));
+	size += (FEAT_MAX + 1) * sizeof(int);
+
+	/* Objects and traps */
+	size += (c->obj_max + 1) * sizeof(struct object *);
+	for (i = 1; i < c->obj_max; i++) {
+		if (c->objects[i]) size += sizeof(struct object);
+	}
+	for (i = 0; i < (int) grids; i++) {
+		struct trap *trap = c->squares[0][i].trap;
+
+		for (; trap; trap = trap->next) size += sizeof(*trap);
+	}
+
+	/* Monsters, their groups and the monster index */
+	size += z_info->level_monster_max * (sizeof(struct monster)
+		+ sizeof(struct monster_group *) + 2 * sizeof(int16_t)
+		+ sizeof(int32_t));
+	for (i = 1; i < z_info->level_monster_max; i++) {
+		if (c->monster_groups[i]) size += sizeof(struct monster_group);
+	}
+
+	return size;
+}
+
 /**
  * Find a chunk by pointer
  * \param c the actual pointer to the sought chunk
@@ -143,13 +288,14 @@ bool chunk_find(struct chunk *c)
  * \param depth is the depth to use.
  * \param above if true, finds the chunk immediately above the given depth.
  * Otherwise, finds the chunk immediately below that depth.
+ * L: the chunk may still be encoded; see chunk_peek_name().
  */
 struct chunk *chunk_find_adjacent(int depth, bool above)
 {
 	struct level *lev = level_by_depth(depth + ((above) ? -1 : 1));
 
 	if (lev) {
-		return chunk_find_name(lev->name);
+		return chunk_peek_name(lev->name);
 	}
 
 	return NULL;
@@ -375,14 +521,13 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 			/* Dungeon objects */
 			if (square_object(source, grid)) {
 				struct object *obj;
-				dest->squares[dest_grid.y][dest_grid.x].obj =
-					square_object(source, grid);
+				square_set_obj(dest, dest_grid, square_object(source, grid));
 
 				for (obj = square_object(source, grid); obj; obj = obj->next) {
 					/* Adjust position */
 					obj->grid = dest_grid;
 				}
-				source->squares[grid.y][grid.x].obj = NULL;
+				square_set_obj(source, grid, NULL);
 			}
 
 			/* Traps */
@@ -469,6 +614,7 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 		}
 	}
 	monster_groups_verify(dest);
+	mon_index_rebuild(dest);
 
 	/* Copy object list */
 	dest->objects = mem_realloc(dest->objects,
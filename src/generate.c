@@ -892,7 +892,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 	/* Check level above */
 	lev = level_by_depth(p->depth - 1);
 	if (lev) {
-		struct chunk *check = chunk_find_name(lev->name);
+		struct chunk *check = chunk_peek_name(lev->name);
 		if (check) {
 			struct connector *join = check->join;
 			while (join) {
@@ -914,7 +914,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 		 * on this level won't conflict with them if the level above is
 		 * ever generated.
 		 */
-		struct chunk *check = chunk_find_name(lev->name);
+		struct chunk *check = chunk_peek_name(lev->name);
 
 		if (check) {
 			struct connector *join;
@@ -936,7 +936,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 	/* Check level below */
 	lev = level_by_depth(p->depth + 1);
 	if (lev) {
-		struct chunk *check = chunk_find_name(lev->name);
+		struct chunk *check = chunk_peek_name(lev->name);
 		if (check) {
 			struct connector *join = check->join;
 			while (join) {
@@ -953,7 +953,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 		}
 	} else if ((lev = level_by_depth(p->depth + 2))) {
 		/* Same logic as above for looking one past the next level */
-		struct chunk *check = chunk_find_name(lev->name);
+		struct chunk *check = chunk_peek_name(lev->name);
 
 		if (check) {
 			struct connector *join;
@@ -995,8 +995,9 @@ static void get_min_level_size(struct chunk *check, int *min_height,
 
 /**
  * Store a dungeon level for reloading
+ * L: returns the stored chunk
  */
-static void cave_store(struct chunk *c, bool known, bool keep_all)
+static struct chunk *cave_store(struct chunk *c, bool known, bool keep_all)
 {
 	struct chunk *stored;
 	if (keep_all) {
@@ -1013,6 +1014,7 @@ static void cave_store(struct chunk *c, bool known, bool keep_all)
 	}
 	stored->turn = turn;
 	chunk_list_add(stored);
+	return stored;
 }
 
 
@@ -1339,11 +1341,17 @@ void prepare_next_level(struct player *p)
 				/* Save level and known level */
 				cave_store(cave, false, true);
 				cave_store(p->cave, true, true);
+
+				/* L: pack them away, unless an arena needs this one */
+				if (!p->upkeep->arena_level) {
+					chunk_freeze(cave);
+					chunk_freeze(p->cave);
+				}
 			}
 		} else {
 			/* Save the town */
-			if (!cave->depth && !chunk_find_name("Town")) {
-				cave_store(cave, false, false);
+			if (!cave->depth && !chunk_peek_name("Town")) {
+				chunk_freeze(cave_store(cave, false, false));
 			}
 
 			/* Forget knowledge of old level */
@@ -1491,7 +1499,7 @@ void prepare_next_level(struct player *p)
 			/* Check level above */
 			lev = level_by_depth(p->depth - 1);
 			if (lev) {
-				struct chunk *check = chunk_find_name(lev->name);
+				struct chunk *check = chunk_peek_name(lev->name);
 				if (check) {
 					get_min_level_size(check, &min_height, &min_width, true);
 				}
@@ -1500,7 +1508,7 @@ void prepare_next_level(struct player *p)
 			/* Check level below */
 			lev = level_by_depth(p->depth + 1);
 			if (lev) {
-				struct chunk *check = chunk_find_name(lev->name);
+				struct chunk *check = chunk_peek_name(lev->name);
 				if (check) {
 					get_min_level_size(check, &min_height, &min_width, false);
 				}
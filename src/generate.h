@@ -348,9 +348,13 @@ struct chunk *arena_gen(struct player *p, int min_height, int min_width);
 
 /* gen-chunk.c */
 struct chunk *chunk_write(struct chunk *c);
+void chunk_dirty(struct chunk *c);
 void chunk_list_add(struct chunk *c);
 bool chunk_list_remove(const char *name);
 struct chunk *chunk_find_name(const char *name);
+struct chunk *chunk_peek_name(const char *name);
+void chunk_freeze(struct chunk *c);
+size_t chunk_memory(const struct chunk *c);
 bool chunk_find(struct chunk *c);
 struct chunk *chunk_find_adjacent(int depth, bool above);
 void symmetry_transform(struct loc *grid, int y0, int x0, int height, int width,
@@ -41,6 +41,7 @@
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-summon.h"
 #include "mon-util.h"
@@ -65,6 +66,7 @@
 #include "player-timed.h"
 #include "project.h"
 #include "randname.h"
+#include "savefile.h"
 #include "store.h"
 #include "trap.h"
 #include "ui-entry.h"
@@ -100,6 +102,7 @@ char *ANGBAND_DIR_SAVE;
 char *ANGBAND_DIR_PANIC;
 char *ANGBAND_DIR_SCORES;
 char *ANGBAND_DIR_ARCHIVE;
+char *ANGBAND_DIR_CACHE;
 
 static const char *slots[] = {
 	#define EQUIP(a, b, c, d, e, f) #a,
@@ -346,6 +349,7 @@ void init_file_paths(const char *configpath, const char *libpath, const char *da
 	string_free(ANGBAND_DIR_PANIC);
 	string_free(ANGBAND_DIR_SCORES);
 	string_free(ANGBAND_DIR_ARCHIVE);
+	string_free(ANGBAND_DIR_CACHE);
 
 	/*** Prepare the paths ***/
 
@@ -402,6 +406,9 @@ void init_file_paths(const char *configpath, const char *libpath, const char *da
 	/* Build the path to the archive directory. */
 	BUILD_DIRECTORY_PATH(ANGBAND_DIR_ARCHIVE, ANGBAND_DIR_USER, "archive");
 
+	/* L: Build the path to the directory for snapshots of the data files */
+	BUILD_DIRECTORY_PATH(ANGBAND_DIR_CACHE, ANGBAND_DIR_USER, "cache");
+
 #ifdef USE_PRIVATE_PATHS
 	userpath = ANGBAND_DIR_USER;
 #else /* !USE_PRIVATE_PATHS */
@@ -2311,6 +2318,7 @@ static void cleanup_feat(void) {
 		string_free(f_info[idx].name);
 	}
 	mem_free(f_info);
+	lookup_feat_index_free();
 }
 
 struct file_parser feat_parser = {
@@ -4544,6 +4552,7 @@ static struct {
 	{ "brands", &brand_parser },
 	{ "monster pain messages", &pain_parser },
 	{ "monster bases", &mon_base_parser },
+	{ "monster factions", &faction_parser },
 	{ "summons", &summon_parser },
 	{ "curses", &curse_parser },
 	{ "player shapes", &shape_parser },
@@ -4614,6 +4623,7 @@ static struct init_module arrays_module = {
 
 extern struct init_module z_quark_module;
 extern struct init_module generate_module;
+extern struct init_module project_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
 extern struct init_module ignore_module;
@@ -4630,6 +4640,7 @@ static struct init_module *modules[] = {
 	&messages_module,
 	&ui_visuals_module, /* This needs to load before monsters and objects. */
 	&arrays_module,
+	&project_module,
 	&player_module,
 	&generate_module,
 	&rune_module,
@@ -4691,9 +4702,13 @@ void cleanup_angband(void)
 {
 	int i;
 
+	/* Let any autosave finish writing */
+	(void) savefile_save_wait();
+
 	/* Free the chunk list */
 	for (i = 0; i < chunk_list_max; i++) {
-		wipe_mon_list(chunk_list[i], player);
+		if (!chunk_list[i]->encoded)
+			wipe_mon_list(chunk_list[i], player);
 		cave_free(chunk_list[i]);
 	}
 	mem_free(chunk_list);
@@ -4716,6 +4731,9 @@ void cleanup_angband(void)
 	monster_list_finalize();
 	object_list_finalize();
 
+	/* L: every object should have been freed by now */
+	object_pool_free();
+
 	cleanup_game_constants();
 
 	cmdq_release();
@@ -4739,4 +4757,5 @@ void cleanup_angband(void)
 	string_free(ANGBAND_DIR_PANIC);
 	string_free(ANGBAND_DIR_SCORES);
 	string_free(ANGBAND_DIR_ARCHIVE);
+	string_free(ANGBAND_DIR_CACHE);
 }
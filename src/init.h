@@ -239,6 +239,7 @@ extern char *ANGBAND_DIR_SAVE;
 extern char *ANGBAND_DIR_PANIC;
 extern char *ANGBAND_DIR_SCORES;
 extern char *ANGBAND_DIR_ARCHIVE;
+extern char *ANGBAND_DIR_CACHE;
 
 extern struct parser *init_parse_artifact(void);
 extern struct parser *init_parse_ego(void);
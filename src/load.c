@@ -25,6 +25,7 @@
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-spell.h"
 #include "mon-util.h"
 #include "monster.h"
@@ -394,19 +395,19 @@ int rd_randomizer(void)
 	rd_u32b(&Rand_value);
 
 	/* state index */
-	rd_u32b(&state_i);
+	rd_u32b(&rng_default.state_i);
 
 	/* for safety, make sure state_i < RAND_DEG */
-	state_i = state_i % RAND_DEG;
+	rng_default.state_i = rng_default.state_i % RAND_DEG;
     
 	/* RNG variables */
-	rd_u32b(&z0);
-	rd_u32b(&z1);
-	rd_u32b(&z2);
+	rd_u32b(&rng_default.z0);
+	rd_u32b(&rng_default.z1);
+	rd_u32b(&rng_default.z2);
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		rd_u32b(&STATE[i]);
+		rd_u32b(&rng_default.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -680,6 +681,7 @@ int rd_player(void)
 
 	/* L: current monster */
 	rd_u16b(&player->curr_monster_ridx);
+	update_player_faction(player);
 
 	/* Player shape */
 	rd_string(buf, sizeof(buf));
@@ -1418,7 +1420,7 @@ static int rd_objects_aux(rd_item_t rd_item_version, struct chunk *c)
 #else
 		if (square_in_bounds_fully(c, obj->grid)) {
 #endif
-			pile_insert_end(&c->squares[obj->grid.y][obj->grid.x].obj, obj);
+			square_append_object(c, obj->grid, obj);
 		}
 		assert(obj->oidx);
 		assert(c->objects[obj->oidx] == NULL);
@@ -1619,6 +1621,75 @@ int rd_traps(void)
 	return 0;
 }
 
+/**
+ * Read one stored chunk, in the form wr_chunks() gives each one
+ */
+static int rd_chunk_body(struct chunk **c)
+{
+	/* Read the dungeon */
+	if (rd_dungeon_aux(c))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, *c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(*c))
+		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(*c))
+		return -1;
+
+
+	/* Read other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		char buf[80];
+		int i;
+		uint8_t tmp8u;
+		uint16_t tmp16u;
+
+		rd_string(buf, sizeof(buf));
+		string_free((*c)->name);
+		(*c)->name = string_make(buf);
+		rd_s32b(&(*c)->turn);
+		rd_u16b(&tmp16u);
+		(*c)->depth = tmp16u;
+		rd_byte(&(*c)->feeling);
+		rd_u32b(&(*c)->obj_rating);
+		rd_u32b(&(*c)->mon_rating);
+		rd_byte(&tmp8u);
+		(*c)->good_item  = tmp8u ? true : false;
+		rd_u16b(&tmp16u);
+		(*c)->height = tmp16u;
+		rd_u16b(&tmp16u);
+		(*c)->width = tmp16u;
+		rd_u16b(&(*c)->feeling_squares);
+		for (i = 0; i < FEAT_MAX + 1; i++) {
+			rd_u16b(&tmp16u);
+			(*c)->feat_count[i] = tmp16u;
+		}
+	} else if ((*c)->name) {
+		char *name = (*c)->name;
+		struct level *lev = level_by_name(name);
+
+		if (lev) {
+			(*c)->depth = lev->depth;
+		} else if (suffix(name, " known")) {
+			size_t offset = strlen(name) - strlen(" known");
+			name[offset] = '\0';
+			lev = level_by_name(name);
+			if (lev) {
+				(*c)->depth = lev->depth;
+			}
+			name[offset] = ' ';
+		}
+	}
+
+	return 0;
+}
+
 /**
  * Read the chunk list
  */
@@ -1632,69 +1703,11 @@ int rd_chunks(void)
 
 	rd_u16b(&chunk_max);
 	for (j = 0; j < chunk_max; j++) {
-		struct chunk *c;
-
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
-			return -1;
-
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
+		struct chunk *c = NULL;
 
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
+		if (rd_chunk_body(&c))
 			return -1;
 
-		/* Read traps */
-		if (rd_traps_aux(c))
-			return -1;
-
-
-		/* Read other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			char buf[80];
-			int i;
-			uint8_t tmp8u;
-			uint16_t tmp16u;
-
-			rd_string(buf, sizeof(buf));
-			string_free(c->name);
-			c->name = string_make(buf);
-			rd_s32b(&c->turn);
-			rd_u16b(&tmp16u);
-			c->depth = tmp16u;
-			rd_byte(&c->feeling);
-			rd_u32b(&c->obj_rating);
-			rd_u32b(&c->mon_rating);
-			rd_byte(&tmp8u);
-			c->good_item  = tmp8u ? true : false;
-			rd_u16b(&tmp16u);
-			c->height = tmp16u;
-			rd_u16b(&tmp16u);
-			c->width = tmp16u;
-			rd_u16b(&c->feeling_squares);
-			for (i = 0; i < FEAT_MAX + 1; i++) {
-				rd_u16b(&tmp16u);
-				c->feat_count[i] = tmp16u;
-			}
-		} else if (c->name) {
-			struct level *lev = level_by_name(c->name);
-
-			if (lev) {
-				c->depth = lev->depth;
-			} else if (suffix(c->name, " known")) {
-				size_t offset = strlen(c->name) -
-					strlen(" known");
-				c->name[offset] = '\0';
-				lev = level_by_name(c->name);
-				if (lev) {
-					c->depth = lev->depth;
-				}
-				c->name[offset] = ' ';
-			}
-		}
-
 		chunk_list_add(c);
 	}
 
@@ -1713,6 +1726,157 @@ int rd_chunks(void)
 	return 0;
 }
 
+/**
+ * L: Whether stored chunks written with the sizes read earlier in this
+ * savefile can be decoded later, after those sizes have been forgotten
+ */
+static bool chunk_sizes_current(void)
+{
+	return square_size == SQUARE_SIZE && of_size == OF_SIZE
+		&& obj_mod_max == OBJ_MOD_MAX && elem_max == ELEM_MAX
+		&& brand_max == z_info->brand_max
+		&& slay_max == z_info->slay_max
+		&& curse_max == z_info->curse_max
+		&& mflag_size == MFLAG_SIZE;
+}
+
+/**
+ * L: Decode a chunk left encoded by rd_chunks_2() or chunk_freeze(), using
+ * whatever sizes are current for load.c
+ */
+static bool chunk_decode_aux(struct chunk *c)
+{
+	struct chunk *d = NULL;
+	uint8_t *save_data = c->save_data;
+	uint32_t save_len = c->save_len;
+	int i, result;
+
+	if (!c->encoded) return true;
+
+	/* Its monsters are counted again as they are placed */
+	for (i = 0; i < c->stub_race_count; i++) {
+		c->stub_races[i]->cur_num--;
+	}
+
+	rd_redirect(save_data, save_len);
+	result = rd_chunk_body(&d);
+	rd_restore();
+	if (result) {
+		note(format("Couldn't read stored level %s", c->name));
+		return false;
+	}
+
+	/* Replace the stub's contents with the real ones */
+	cave_connectors_free(c->join);
+	mem_free(c->stub_races);
+	string_free(c->name);
+	*c = *d;
+	mem_free(d);
+	c->save_data = save_data;
+	c->save_len = save_len;
+
+	return true;
+}
+
+/**
+ * L: Read the chunk list, leaving each chunk encoded
+ *
+ * Each chunk comes with a directory entry holding what is needed before
+ * it is decoded: its name and depth, the races of its monsters (which
+ * still count towards how many of each race are alive) and its stairs
+ * (for lining up the levels either side of it).  The chunk itself is kept
+ * as the bytes it was saved as until chunk_decode() is called for it.
+ */
+int rd_chunks_2(void)
+{
+	int j;
+	uint16_t chunk_max;
+	bool lazy = chunk_sizes_current();
+
+	if (player->is_dead)
+		return 0;
+
+	rd_u16b(&chunk_max);
+	for (j = 0; j < chunk_max; j++) {
+		struct chunk *c = mem_zalloc(sizeof(*c));
+		char buf[80];
+		uint16_t depth, count, i;
+		uint32_t len;
+
+		rd_string(buf, sizeof(buf));
+		c->name = string_make(buf);
+		rd_u16b(&depth);
+		c->depth = depth;
+
+		/* Monster races, counted as though the monsters were placed */
+		rd_u16b(&count);
+		c->stub_races = mem_zalloc(MAX(count, 1) * sizeof(*c->stub_races));
+		c->stub_race_count = count;
+		for (i = 0; i < count; i++) {
+			rd_string(buf, sizeof(buf));
+			c->stub_races[i] = lookup_monster(buf);
+			if (!c->stub_races[i]) {
+				note(format("Monster race %s no longer exists!", buf));
+				cave_free(c);
+				return -1;
+			}
+			c->stub_races[i]->cur_num++;
+		}
+
+		/* Connectors */
+		rd_u16b(&count);
+		for (i = 0; i < count; i++) {
+			struct connector *current = mem_zalloc(sizeof *current);
+			uint8_t tmp8u;
+
+			current->info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
+			rd_byte(&tmp8u);
+			current->grid.x = tmp8u;
+			rd_byte(&tmp8u);
+			current->grid.y = tmp8u;
+			rd_byte(&current->feat);
+			current->next = c->join;
+			c->join = current;
+		}
+
+		/* The chunk itself; adding it to the list would discard this */
+		rd_u32b(&len);
+		chunk_list_add(c);
+		c->save_data = rd_bytes(len);
+		c->save_len = len;
+		c->encoded = true;
+
+		/* Sizes from this savefile are needed to read it, so do it now */
+		if (!lazy) {
+			if (!chunk_decode_aux(c))
+				return -1;
+			chunk_dirty(c);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * L: Decode a chunk left encoded by rd_chunks_2() or chunk_freeze()
+ * \param c the chunk, which keeps its address and its savefile encoding
+ * \return whether the chunk could be read
+ */
+bool chunk_decode(struct chunk *c)
+{
+	/* Only chunks in the current format are left encoded */
+	square_size = SQUARE_SIZE;
+	of_size = OF_SIZE;
+	obj_mod_max = OBJ_MOD_MAX;
+	elem_max = ELEM_MAX;
+	brand_max = z_info->brand_max;
+	slay_max = z_info->slay_max;
+	curse_max = z_info->curse_max;
+	mflag_size = MFLAG_SIZE;
+
+	return chunk_decode_aux(c);
+}
+
 
 int rd_history(void)
 {
@@ -0,0 +1,505 @@
+/**
+ * \file main-borg.c
+ * \brief Pseudo-UI for running the borg unattended (borrows from main-stats.c)
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#if defined(USE_BORG) && defined(ALLOW_BORG)
+
+#include "borg/borg-perf.h"
+#include "borg/borg.h"
+#include "cmd-core.h"
+#include "datafile.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "generate.h"
+#include "main.h"
+#include "message.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "ui-game.h"
+#include "ui-input.h"
+#include "ui-map.h"
+#include <time.h>
+#ifdef UNIX
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define MAX_BORG_WORKERS	256
+
+static const char *race_name = NULL;
+static const char *class_name = NULL;
+static uint32_t max_turns = 0;
+static bool fixed_seed = false;
+static uint32_t seed_base;
+static uint32_t seed;
+static uint32_t num_games = 1;
+static int num_workers = 1;
+static bool batch = false;
+static const char *results_name = NULL;
+static int running_borg = 0;
+
+/**
+ * How many commands the borg may give without game time passing before
+ * it is taken to be stuck
+ */
+#define BORG_IDLE_MAX 2000
+static int idle = 0;
+
+/**
+ * Birth a character straight from the command queue, skipping the birth
+ * screens, and bring it into the town
+ */
+static bool borg_birth(void)
+{
+	Rand_quick = false;
+	Rand_state_init(seed);
+
+	if (!player_make_simple(race_name, class_name, "Borg")) return false;
+
+	event_signal(EVENT_LEAVE_INIT);
+	event_signal(EVENT_ENTER_GAME);
+	event_signal(EVENT_ENTER_WORLD);
+	player->upkeep->autosave = false;
+	prepare_next_level(player);
+	on_new_level();
+	return true;
+}
+
+/**
+ * How the game ended
+ */
+static const char *borg_result(void)
+{
+	if (player->is_dead) return "died";
+	return idle > BORG_IDLE_MAX ? "stuck" : "alive";
+}
+
+/**
+ * Report how the game went
+ */
+static void borg_report(double secs)
+{
+	printf("seed %u: %s %s, clevel %d, depth %d (max %d), %d turns "
+		"(%d player), %s, %.2fs, %.0f turns/s\n", seed,
+		player->race->name, player->class->name, player->lev,
+		player->depth, player->max_depth, (int)turn,
+		(int)player->total_energy / 100,
+		player->is_dead ? player->died_from : borg_result(), secs,
+		secs > 0 ? (double)turn / secs : 0.0);
+	fflush(stdout);
+}
+
+/**
+ * Birth a character for the game's seed and set the borg going
+ */
+static void borg_begin(void)
+{
+	if (!borg_birth()) quit("Couldn't make a character for the borg!");
+	if (!borg_start()) {
+		int i;
+
+		/* Show why, from the borg's notes */
+		for (i = messages_num() - 1; i >= 0; i--) {
+			printf("%s\n", message_str(i));
+		}
+		quit("The borg couldn't start!");
+	}
+}
+
+/**
+ * Play with the borg, to death or the turn limit, and report how it went;
+ * returns the seconds that took
+ */
+static double borg_play(void)
+{
+	struct timespec t0, t1;
+	double secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	while (!player->is_dead && player->upkeep->playing && inkey_hack
+			&& (!max_turns || (uint32_t)turn < max_turns)) {
+		int32_t last_turn = turn;
+
+		cmd_get_hook(CTX_GAME);
+		run_game_loop();
+
+		/* Give up on a borg that has stopped using game time */
+		if (turn != last_turn) {
+			idle = 0;
+		} else if (++idle > BORG_IDLE_MAX) {
+			break;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	borg_report(secs);
+
+	/* The game is never left, so keep the borg's timing here */
+	borg_perf_write();
+	return secs;
+}
+
+#ifdef UNIX
+
+/**
+ * A batch of games is played with each game in its own process, forked from
+ * the parent before any character is made, so that every game starts from
+ * the same state and depends only on its seed.  Game n of the batch is
+ * seeded with seed_base + n.  Each game keeps its logs, map and saves in
+ * borg-games/<seed> under the user directory, and sends one line of results
+ * back to the parent, which appends it to the results file.
+ */
+static const char borg_results_header[] = "seed,race,class,clevel,depth,"
+	"max_depth,turns,player_turns,result,cause,secs\n";
+
+/**
+ * A game the parent is waiting on
+ */
+struct borg_worker_info {
+	pid_t pid;
+	int fd;
+	uint32_t seed;
+};
+
+/**
+ * Find the directory a game keeps its files in
+ */
+static void borg_game_dir(char *buf, size_t len, uint32_t game_seed)
+{
+	char leaf[32];
+
+	strnfmt(leaf, sizeof(leaf), "%u", game_seed);
+	path_build(buf, len, ANGBAND_DIR_USER, "borg-games");
+	my_strcat(buf, PATH_SEP, len);
+	my_strcat(buf, leaf, len);
+}
+
+/**
+ * Append a line to the results file, with the column names first if the
+ * file is new; the file is closed again so that the results survive an
+ * interrupted batch
+ */
+static void borg_results_add(const char *line)
+{
+	char path[1024];
+	ang_file *fff;
+	bool fresh;
+
+	if (results_name) {
+		my_strcpy(path, results_name, sizeof(path));
+	} else {
+		path_build(path, sizeof(path), ANGBAND_DIR_USER, "borg-games.csv");
+	}
+	fresh = !file_exists(path);
+
+	fff = file_open(path, MODE_APPEND, FTYPE_TEXT);
+	if (!fff) quit_fmt("Couldn't write to %s!", path);
+	if (fresh) file_put(fff, borg_results_header);
+	file_put(fff, line);
+	file_close(fff);
+}
+
+/**
+ * Play one game of the batch in a child process, and send its results
+ * back down fd
+ */
+static void borg_worker(uint32_t game_seed, int fd)
+{
+	char dir[1024], cause[80], line[1024];
+	size_t i, len;
+	double secs;
+
+	seed = game_seed;
+	borg_begin();
+
+	/* The settings have been read, so keep everything else apart */
+	borg_game_dir(dir, sizeof(dir), seed);
+	if (!dir_create(dir)) quit_fmt("Couldn't make %s!", dir);
+	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = string_make(dir);
+	path_build(savefile, sizeof(savefile), dir, "Borg");
+
+	secs = borg_play();
+
+	/* Keep the cause of death to one quoted field */
+	my_strcpy(cause, player->is_dead ? player->died_from : "",
+		sizeof(cause));
+	for (i = 0; cause[i]; i++) {
+		if (cause[i] == '"') cause[i] = '\'';
+	}
+
+	strnfmt(line, sizeof(line), "%u,%s,%s,%d,%d,%d,%d,%d,%s,\"%s\",%.2f\n",
+		seed, player->race->name, player->class->name, player->lev,
+		player->depth, player->max_depth, (int)turn,
+		(int)player->total_energy / 100,
+		borg_result(), cause, secs);
+	len = strlen(line);
+	if (write(fd, line, len) != (ssize_t)len) quit("Couldn't send results!");
+	close(fd);
+
+	quit(NULL);
+}
+
+/**
+ * Play the batch, with up to num_workers games at a time
+ */
+static void borg_run_batch(void)
+{
+	struct borg_worker_info workers[MAX_BORG_WORKERS];
+	struct timespec t0, t1;
+	char path[1024];
+	int active = 0, failed = 0, i;
+	uint32_t next = 0;
+
+	/* Make the games' parent directory before they race to */
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "borg-games");
+	if (!dir_create(path)) quit_fmt("Couldn't make %s!", path);
+
+	printf("Playing %u games from seed %u...\n", num_games, seed_base);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	while (next < num_games || active) {
+		struct borg_worker_info done;
+		char line[1024];
+		size_t len = 0;
+		ssize_t n;
+		pid_t pid;
+		int status;
+
+		/* Keep every worker busy */
+		while (active < num_workers && next < num_games) {
+			int pipe_fd[2];
+
+			fflush(stdout);
+			if (pipe(pipe_fd)) quit("Couldn't make a pipe for a game!");
+			pid = fork();
+			if (pid < 0) quit("Couldn't start a game!");
+			if (pid == 0) {
+				/* Only keep our own pipe */
+				close(pipe_fd[0]);
+				for (i = 0; i < active; i++) close(workers[i].fd);
+				borg_worker(seed_base + next, pipe_fd[1]);
+			}
+			close(pipe_fd[1]);
+			workers[active].pid = pid;
+			workers[active].fd = pipe_fd[0];
+			workers[active].seed = seed_base + next++;
+			active++;
+		}
+
+		/* Wait for a game to end */
+		pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR) continue;
+			quit("Couldn't wait for a game!");
+		}
+		for (i = 0; i < active && workers[i].pid != pid; i++) ;
+		if (i == active) continue;
+		done = workers[i];
+		workers[i] = workers[--active];
+
+		/* Its line of results is already waiting in the pipe */
+		while (len < sizeof(line) - 1 && (n = read(done.fd, line + len,
+				sizeof(line) - 1 - len)) > 0) {
+			len += n;
+		}
+		line[len] = '\0';
+		close(done.fd);
+
+		/* Pass the results on, or note that the game failed */
+		if (WIFEXITED(status) && !WEXITSTATUS(status) && len) {
+			borg_results_add(line);
+		} else {
+			char reason[32];
+
+			if (WIFSIGNALED(status)) {
+				strnfmt(reason, sizeof(reason), "signal %d",
+					WTERMSIG(status));
+			} else {
+				strnfmt(reason, sizeof(reason), "exit status %d",
+					WEXITSTATUS(status));
+			}
+			printf("seed %u: failed, %s\n", done.seed, reason);
+			strnfmt(line, sizeof(line), "%u,%s,%s,,,,,,failed,\"%s\",\n",
+				done.seed, race_name ? race_name : "",
+				class_name ? class_name : "", reason);
+			borg_results_add(line);
+			failed++;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	printf("Played %u games in %.2fs, %d failed\n", num_games,
+		(t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9, failed);
+}
+
+#endif /* UNIX */
+
+/**
+ * Play one game with the borg, or a batch of them
+ */
+static errr run_borg(void)
+{
+	if (!fixed_seed) seed_base = time(NULL);
+	borg_headless = true;
+
+#ifdef UNIX
+	if (batch) {
+		borg_run_batch();
+		quit(NULL);
+	}
+#endif
+
+	seed = seed_base;
+	borg_begin();
+	borg_play();
+	quit(NULL);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_borg(int n, int v) {
+	if (n == TERM_XTRA_EVENT) {
+		if (!running_borg) {
+			running_borg = 1;
+			return run_borg();
+		}
+
+		/* Nobody is at the keyboard, so back out of anything that waits */
+		if (v) Term_keypress(ESCAPE, 0);
+	}
+	return 0;
+}
+
+static errr term_curs_borg(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_borg(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_borg(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = true;
+	t->never_frosh = true;
+
+	t->xtra_hook = term_xtra_borg;
+	t->curs_hook = term_curs_borg;
+	t->wipe_hook = term_wipe_borg;
+	t->text_hook = term_text_borg;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_borg[] = "Borg mode, subopts -r(ace) -c(lass) -t(urn limit) -S(eed) -n(# of games) -j(# of workers) -o(results file)";
+
+/**
+ * Usage:
+ *
+ * angband -mborg -- [-rRace] [-cClass] [-tNNNN] [-SNNNN] [-nNNNN] [-jNN]
+ *                    [-oFile]
+ *
+ *   -rRace   Play the named race (default: Human)
+ *   -cClass  Play the named class (default: Warrior)
+ *   -tNNNN   Stop each game after NNNN game turns (default: play to the death)
+ *   -SNNNN   Seed the game from NNNN, to repeat a game; in a batch, game n
+ *            is seeded from NNNN + n (default: time)
+ *   -nNNNN   Play a batch of NNNN games (default: 1)
+ *   -jNN     Play up to NN games of a batch at once (default: 1)
+ *   -oFile   Append the results of a batch to File (default: borg-games.csv
+ *            in the user directory)
+ */
+errr init_borg(int argc, char *argv[]) {
+	int i;
+
+	/* Leave no snapshots of the data files in the user directory */
+	parse_snapshots = false;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-r")) {
+			race_name = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-c")) {
+			class_name = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-t")) {
+			max_turns = (uint32_t)strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = (uint32_t)strtoul(&argv[i][2], NULL, 10);
+			fixed_seed = true;
+			continue;
+		}
+		if (prefix(argv[i], "-n")) {
+			num_games = (uint32_t)strtoul(&argv[i][2], NULL, 10);
+			if (num_games < 1) num_games = 1;
+			batch = true;
+			continue;
+		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = atoi(&argv[i][2]);
+			if (num_workers < 1) num_workers = 1;
+			if (num_workers > MAX_BORG_WORKERS) {
+				num_workers = MAX_BORG_WORKERS;
+			}
+			batch = true;
+			continue;
+		}
+		if (prefix(argv[i], "-o")) {
+			results_name = &argv[i][2];
+			batch = true;
+			continue;
+		}
+		printf("init-borg: bad argument '%s'\n", argv[i]);
+	}
+
+#ifndef UNIX
+	if (batch) {
+		printf("init-borg: batches are only supported on Unix\n");
+		batch = false;
+	}
+#endif
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_BORG && ALLOW_BORG */
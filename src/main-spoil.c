@@ -170,6 +170,9 @@ errr init_spoil(int argc, char *argv[]) {
 	bool have_specified_seed = false;
 	uint32_t specified_seed = 0;
 
+	/* L: Leave no snapshots of the data files in the user directory */
+	parse_snapshots = false;
+
 	/* Parse the arguments. */
 	while (1) {
 		bool badarg = false;
@@ -21,6 +21,7 @@
 #ifdef USE_STATS
 
 #include "buildid.h"
+#include "datafile.h"
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
@@ -30,6 +31,7 @@
 #include "mon-util.h"
 #include "monster.h"
 #include "obj-gear.h"
+#include "obj-pile.h"
 #include "obj-power.h"
 #include "obj-randart.h"
 #include "obj-tval.h"
@@ -44,6 +46,11 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#ifdef UNIX
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -55,6 +62,7 @@
 #define TOP_POWER		999
 #define TOP_MOD 		 25
 #define RUNS_PER_CHECKPOINT	10000
+#define MAX_STATS_WORKERS	64
 
 /* For ref, e_max is 128, a_max is 136, r_max is ~650,
 	ORIGIN_STATS is 14, OF_MAX is ~120 */
@@ -68,11 +76,17 @@
 static int randarts = 0;
 static int no_selling = 0;
 static uint32_t num_runs = 1;
+static int num_workers = 1;
+static bool fixed_seed = false;
+static uint32_t seed_base;
 static bool quiet = false;
 static int nextkey = 0;
 static int running_stats = 0;
 static char *ANGBAND_DIR_STATS;
 
+static struct artifact *a_info_save;
+static struct artifact_upkeep *aup_info_save;
+
 static int *consumables_index;
 static int *wearables_index;
 static int wearable_count = 0;
@@ -90,7 +104,7 @@ struct wearables_data {
 	uint32_t *modifiers[TOP_MOD];
 };
 
-static struct level_data {
+struct level_data {
 	uint32_t *monsters;
 	/* uint32_t *vaults;  Add these later - requires passing into generate.c
 	uint32_t *pits; */
@@ -100,7 +114,19 @@ static struct level_data {
 	uint32_t *artifacts[ORIGIN_STATS];
 	uint32_t *consumables[ORIGIN_STATS];
 	struct wearables_data *wearables[ORIGIN_STATS];
-} level_data[LEVEL_MAX];
+	long long objects_made;		/* L: objects made by the object pool */
+	long long objects_freed;	/* L: and given back to it */
+};
+
+/**
+ * L: Runs count into level_counts.  On Unix, where every run is forked,
+ * each worker counts a run into its own copy of that, and the parent adds
+ * the results up in level_totals; level_data is whichever is written to
+ * the database.
+ */
+static struct level_data level_counts[LEVEL_MAX];
+static struct level_data level_totals[LEVEL_MAX];
+static struct level_data *level_data = level_counts;
 
 static void create_indices(void)
 {
@@ -125,54 +151,62 @@ static void create_indices(void)
 	}
 }
 
-static void alloc_memory(void)
+static void alloc_memory(struct level_data *ld)
 {
 	int i, j, k, l;
 
 	for (i = 0; i < LEVEL_MAX; i++) {
-		level_data[i].monsters = mem_zalloc(z_info->r_max * sizeof(uint32_t));
-/*		level_data[i].vaults = mem_zalloc(z_info->v_max * sizeof(uint32_t));
-		level_data[i].pits = mem_zalloc(z_info->pit_max * sizeof(uint32_t)); */
+		ld[i].monsters = mem_zalloc(z_info->r_max * sizeof(uint32_t));
+/*		ld[i].vaults = mem_zalloc(z_info->v_max * sizeof(uint32_t));
+		ld[i].pits = mem_zalloc(z_info->pit_max * sizeof(uint32_t)); */
 
 		for (j = 0; j < ORIGIN_STATS; j++) {
-			level_data[i].artifacts[j] = mem_zalloc(z_info->a_max *
+			ld[i].artifacts[j] = mem_zalloc(z_info->a_max *
 				sizeof(uint32_t));
-			level_data[i].consumables[j] = mem_zalloc(
+			ld[i].consumables[j] = mem_zalloc(
 				(consumable_count + 1) * sizeof(uint32_t));
-			level_data[i].wearables[j]
+			ld[i].wearables[j]
 				= mem_zalloc((wearable_count + 1) *
 							 sizeof(struct wearables_data));
 
 			for (k = 0; k < wearable_count + 1; k++) {
-				level_data[i].wearables[j][k].egos
+				ld[i].wearables[j][k].egos
 					= mem_zalloc(z_info->e_max * sizeof(uint32_t));
 				for (l = 0; l < TOP_MOD; l++)
-					level_data[i].wearables[j][k].modifiers[l]
+					ld[i].wearables[j][k].modifiers[l]
 						= mem_zalloc((OBJ_MOD_MAX + 1) * sizeof(uint32_t));
 			}
 		}
 	}
 }
 
-static void free_stats_memory(void)
+static void free_level_data(struct level_data *ld)
 {
 	int i, j, k, l;
 	for (i = 0; i < LEVEL_MAX; i++) {
-		mem_free(level_data[i].monsters);
-/*		mem_free(level_data[i].vaults);
- 		mem_free(level_data[i].pits); */
+		mem_free(ld[i].monsters);
+/*		mem_free(ld[i].vaults);
+ 		mem_free(ld[i].pits); */
 		for (j = 0; j < ORIGIN_STATS; j++) {
-			mem_free(level_data[i].artifacts[j]);
-			mem_free(level_data[i].consumables[j]);
+			mem_free(ld[i].artifacts[j]);
+			mem_free(ld[i].consumables[j]);
 			for (k = 0; k < wearable_count + 1; k++) {
 				for (l = 0; l < TOP_MOD; l++) {
-					mem_free(level_data[i].wearables[j][k].modifiers[l]);
+					mem_free(ld[i].wearables[j][k].modifiers[l]);
 				}
-				mem_free(level_data[i].wearables[j][k].egos);
+				mem_free(ld[i].wearables[j][k].egos);
 			}
-			mem_free(level_data[i].wearables[j]);
+			mem_free(ld[i].wearables[j]);
 		}
 	}
+}
+
+static void free_stats_memory(void)
+{
+	free_level_data(level_counts);
+#ifdef UNIX
+	free_level_data(level_totals);
+#endif
 	mem_free(consumables_index);
 	mem_free(wearables_index);
 	string_free(ANGBAND_DIR_STATS);
@@ -195,17 +229,14 @@ static void generate_player_for_stats(void)
 	player->class = classes; /* Warrior */
 
 	/* Needs a body; duplicates logic from the private player_embody(). */
-	memcpy(&player->body, &bodies[player->race->body],
-		sizeof(player->body));
-	my_strcpy(buf, bodies[player->race->body].name, sizeof(buf));
+	memcpy(&player->body, player->race->body, sizeof(player->body));
+	my_strcpy(buf, player->race->body->name, sizeof(buf));
 	player->body.name = string_make(buf);
 	player->body.slots = mem_zalloc(player->body.count *
 		sizeof(*(player->body.slots)));
 	for (i = 0; i < player->body.count; ++i) {
-		player->body.slots[i].type =
-			bodies[player->race->body].slots[i].type;
-		my_strcpy(buf, bodies[player->race->body].slots[i].name,
-			sizeof(buf));
+		player->body.slots[i].type = player->race->body->slots[i].type;
+		my_strcpy(buf, player->race->body->slots[i].name, sizeof(buf));
 		player->body.slots[i].name = string_make(buf);
 	}
 
@@ -233,18 +264,19 @@ static void generate_player_for_stats(void)
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * L: Each run is seeded from its own number, so that a given seed always
+ * produces the same results when each run starts afresh in its own process
+ */
+static void initialize_character(uint32_t run)
 {
-	uint32_t seed;
-
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
 	Rand_quick = false;
-	Rand_state_init(seed);
+	Rand_state_init(seed_base + run);
 
 	player_init(player);
 	generate_player_for_stats();
@@ -399,6 +431,7 @@ static void descend_dungeon(void)
 {
 	int level;
 	uint16_t obj_f, mon_f;
+	const struct object_pool_counts *pool = object_pool_counts();
 
 	clock_t last = 0;
 
@@ -415,6 +448,10 @@ static void descend_dungeon(void)
 			}
 		}
 
+		/* L: count the objects made and freed on the way to each level */
+		level_data[level].objects_made -= pool->made;
+		level_data[level].objects_freed -= pool->freed;
+
 		dungeon_change_level(player, level);
 		prepare_next_level(player);
 
@@ -427,6 +464,9 @@ static void descend_dungeon(void)
 		log_all_objects(level);
 		/* Besides killing, also gathers counts. */
 		kill_all_monsters(level);
+
+		level_data[level].objects_made += pool->made;
+		level_data[level].objects_freed += pool->freed;
 	}
 }
 
@@ -1203,6 +1243,9 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 			uint32_t count;
 			if (streq(table, "gold"))
 				count = *((long long *)((uint8_t *)&level_data[level] + offset) + i);
+			else if (streq(table, "monsters"))
+				/* L: monsters is allocated, not held in the struct */
+				count = level_data[level].monsters[i];
 			else
 				count = *((uint32_t *)((uint8_t *)&level_data[level] + offset) + i);
 
@@ -1504,11 +1547,288 @@ static void stats_cleanup_angband_run(void)
 	player->history = NULL;
 }
 
+/**
+ * Make one run through the dungeon, adding to the level data
+ */
+static void stats_run_once(uint32_t run)
+{
+	unsigned int i;
+
+	if (randarts) {
+		for (i = 0; i < z_info->a_max; i++) {
+			memcpy(&a_info[i], &a_info_save[i],
+				sizeof(struct artifact));
+			memcpy(&aup_info[i], &aup_info_save[i],
+				sizeof(struct artifact_upkeep));
+		}
+	}
+
+	initialize_character(run);
+	unkill_uniques();
+	reset_artifacts();
+	descend_dungeon();
+	stats_cleanup_angband_run();
+}
+
+#ifdef UNIX
+
+/**
+ * L: A worker hands its counts back to the parent as a stream of
+ * (position, count) pairs for the non-zero counters, with the positions
+ * numbering every counter in the order stats_visit_counts() visits them.
+ */
+#define STATS_STREAM_END UINT64_MAX
+
+struct stats_stream {
+	FILE *fp;
+	uint64_t offset;	/* Position of the first counter being visited */
+	uint64_t next;		/* Position of the pending pair when merging */
+	uint64_t value;		/* Count of the pending pair when merging */
+	bool ok;
+};
+
+typedef void (*stats_count_visitor)(void *counts, int n, int size,
+	struct stats_stream *s);
+
+/**
+ * Visit every counter in a set of level data, in a fixed order, as arrays
+ * of n integers of the given size
+ */
+static void stats_visit_counts(struct level_data *ld,
+	stats_count_visitor visit, struct stats_stream *s)
+{
+	int level, origin, idx, l;
+
+	for (level = 1; level < LEVEL_MAX; level++) {
+		visit(ld[level].monsters, z_info->r_max, sizeof(uint32_t), s);
+		visit(ld[level].obj_feelings, OBJ_FEEL_MAX, sizeof(uint32_t), s);
+		visit(ld[level].mon_feelings, MON_FEEL_MAX, sizeof(uint32_t), s);
+		visit(ld[level].gold, ORIGIN_STATS, sizeof(long long), s);
+		visit(&ld[level].objects_made, 1, sizeof(long long), s);
+		visit(&ld[level].objects_freed, 1, sizeof(long long), s);
+
+		for (origin = 0; origin < ORIGIN_STATS; origin++) {
+			visit(ld[level].artifacts[origin], z_info->a_max,
+				sizeof(uint32_t), s);
+			visit(ld[level].consumables[origin], consumable_count + 1,
+				sizeof(uint32_t), s);
+
+			for (idx = 0; idx < wearable_count + 1; idx++) {
+				struct wearables_data *w = &ld[level].wearables[origin][idx];
+
+				visit(&w->count, 1, sizeof(uint32_t), s);
+				visit(&w->dice[0][0], TOP_DICE * TOP_SIDES,
+					sizeof(uint32_t), s);
+				visit(w->ac, TOP_AC, sizeof(uint32_t), s);
+				visit(w->hit, TOP_PLUS, sizeof(uint32_t), s);
+				visit(w->dam, TOP_PLUS, sizeof(uint32_t), s);
+				visit(w->egos, z_info->e_max, sizeof(uint32_t), s);
+				visit(w->flags, OF_MAX, sizeof(uint32_t), s);
+				for (l = 0; l < TOP_MOD; l++) {
+					visit(w->modifiers[l], OBJ_MOD_MAX + 1,
+						sizeof(uint32_t), s);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Write out the non-zero counters of an array
+ */
+static void stats_send_counts(void *counts, int n, int size,
+	struct stats_stream *s)
+{
+	int i;
+
+	for (i = 0; i < n; i++, s->offset++) {
+		uint64_t value = (size == sizeof(uint32_t)) ?
+			((uint32_t *)counts)[i] : (uint64_t)((long long *)counts)[i];
+
+		if (!value) continue;
+		if (fwrite(&s->offset, sizeof(s->offset), 1, s->fp) != 1 ||
+				fwrite(&value, sizeof(value), 1, s->fp) != 1) {
+			s->ok = false;
+		}
+	}
+}
+
+/**
+ * Read the next pair from a worker; a worker which stops before the end
+ * marker has failed
+ */
+static void stats_stream_read(struct stats_stream *s)
+{
+	if (fread(&s->next, sizeof(s->next), 1, s->fp) != 1) {
+		s->next = STATS_STREAM_END;
+		s->ok = false;
+	} else if (s->next != STATS_STREAM_END &&
+			fread(&s->value, sizeof(s->value), 1, s->fp) != 1) {
+		s->next = STATS_STREAM_END;
+		s->ok = false;
+	}
+}
+
+/**
+ * Add the pairs from a worker which fall in an array to it
+ */
+static void stats_merge_counts(void *counts, int n, int size,
+	struct stats_stream *s)
+{
+	while (s->next < s->offset + n) {
+		int i = (int)(s->next - s->offset);
+
+		if (size == sizeof(uint32_t)) {
+			((uint32_t *)counts)[i] += (uint32_t)s->value;
+		} else {
+			((long long *)counts)[i] += (long long)s->value;
+		}
+		stats_stream_read(s);
+	}
+	s->offset += n;
+}
+
+/**
+ * Make one run in a child process, and send the counts back down fd
+ */
+static void stats_worker(uint32_t run, int fd)
+{
+	struct stats_stream s = { NULL, 0, 0, 0, true };
+	uint64_t end = STATS_STREAM_END;
+
+	/* The parent owns the terminal, and the totals */
+	quiet = true;
+	level_data = level_counts;
+
+	stats_run_once(run);
+
+	s.fp = fdopen(fd, "wb");
+	if (!s.fp) _exit(1);
+	stats_visit_counts(level_counts, stats_send_counts, &s);
+	if (fwrite(&end, sizeof(end), 1, s.fp) != 1) s.ok = false;
+	if (fclose(s.fp)) s.ok = false;
+
+	/* Leave without running any of the parent's cleanup */
+	_exit(s.ok ? 0 : 1);
+}
+
+/**
+ * A worker process the parent is waiting on
+ */
+struct stats_worker_info {
+	pid_t pid;
+	int fd;
+	uint32_t run;
+};
+
+/**
+ * Make runs first to last - 1, each in a fresh child process forked from
+ * the untouched parent, with up to num_workers at a time, and add their
+ * counts to level_totals.  Every run starts from the same state and the
+ * sums don't depend on the order they're added in, so the results only
+ * depend on the seed.
+ */
+static void stats_run_workers(uint32_t first, uint32_t last, time_t start)
+{
+	struct stats_worker_info workers[MAX_STATS_WORKERS];
+	int active = 0, i;
+	uint32_t next = first;
+
+	while (next < last || active) {
+		struct stats_stream s = { NULL, 0, 0, 0, true };
+		struct stats_worker_info done;
+		fd_set ready;
+		int max_fd = -1, status;
+
+		/* Keep every worker busy */
+		while (active < num_workers && next < last) {
+			int pipe_fd[2];
+			pid_t pid;
+
+			fflush(stdout);
+			if (pipe(pipe_fd)) quit("Couldn't make a pipe for a worker!");
+			pid = fork();
+			if (pid < 0) quit("Couldn't start a worker!");
+			if (pid == 0) {
+				/* Only keep our own pipe */
+				close(pipe_fd[0]);
+				for (i = 0; i < active; i++) close(workers[i].fd);
+				stats_worker(next, pipe_fd[1]);
+			}
+			close(pipe_fd[1]);
+			workers[active].pid = pid;
+			workers[active].fd = pipe_fd[0];
+			workers[active].run = next++;
+			active++;
+		}
+
+		/* Wait for a worker to start reporting */
+		FD_ZERO(&ready);
+		for (i = 0; i < active; i++) {
+			FD_SET(workers[i].fd, &ready);
+			max_fd = MAX(max_fd, workers[i].fd);
+		}
+		if (select(max_fd + 1, &ready, NULL, NULL, NULL) < 0) {
+			if (errno == EINTR) continue;
+			quit("Couldn't wait for a worker!");
+		}
+		for (i = 0; !FD_ISSET(workers[i].fd, &ready); i++) ;
+		done = workers[i];
+		workers[i] = workers[--active];
+
+		/* Add in its counts */
+		s.fp = fdopen(done.fd, "rb");
+		if (!s.fp) quit("Couldn't read from a worker!");
+		stats_stream_read(&s);
+		stats_visit_counts(level_totals, stats_merge_counts, &s);
+		fclose(s.fp);
+		if (waitpid(done.pid, &status, 0) != done.pid ||
+				!WIFEXITED(status) || WEXITSTATUS(status) || !s.ok ||
+				s.next != STATS_STREAM_END) {
+			quit_fmt("Stats worker for run %d failed!", done.run);
+		}
+
+		if (!quiet) progress_bar(next - active - 1, start);
+	}
+}
+
+#endif /* UNIX */
+
+/**
+ * L: Report how many objects were made and freed getting to each level
+ */
+static void stats_report_churn(void)
+{
+	long long made = 0, freed = 0;
+	int level;
+
+	for (level = 1; level < LEVEL_MAX; level++) {
+		made += level_data[level].objects_made;
+		freed += level_data[level].objects_freed;
+	}
+	printf("Objects: %lld made, %lld freed, %lld made per level\n", made,
+		freed, made / ((long long)num_runs * (LEVEL_MAX - 1)));
+}
+
+/**
+ * Write out the data so far, in case a long set of runs is interrupted
+ */
+static void stats_checkpoint(uint32_t run)
+{
+	int err = stats_write_db(run);
+
+	if (err) {
+		stats_db_close();
+		quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+	}
+}
+
 static errr run_stats(void)
 {
 	uint32_t run;
-	struct artifact *a_info_save;
-	struct artifact_upkeep *aup_info_save;
+#ifdef UNIX
+	uint32_t last;
+#endif
 	unsigned int i;
 	int err;
 	bool status; 
@@ -1517,7 +1837,11 @@ static errr run_stats(void)
 
 	prep_output_dir();
 	create_indices();
-	alloc_memory();
+	alloc_memory(level_counts);
+#ifdef UNIX
+	alloc_memory(level_totals);
+	level_data = level_totals;
+#endif
 	if (randarts) {
 		a_info_save = mem_zalloc(z_info->a_max * sizeof(struct artifact));
 		aup_info_save = mem_zalloc(z_info->a_max
@@ -1531,54 +1855,56 @@ static errr run_stats(void)
 				sizeof(struct artifact_upkeep));
 		}
 	}
+	if (!fixed_seed) seed_base = time(NULL);
 
 	if (!quiet) printf("Creating the database and dumping info...\n");
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
 
 	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
+		printf("Beginning %d runs (seed %u)...\n", num_runs, seed_base);
 		fflush(stdout);
 	}
 
 	start = time(NULL);
+#ifdef UNIX
+	/*
+	 * L: share out the runs up to each checkpoint between workers; even
+	 * with one worker each run is forked, so that no run sees what an
+	 * earlier one left behind and -j doesn't change the results
+	 */
+	if (!quiet) progress_bar(0, start);
+	for (run = 1; run <= num_runs; run = last + 1) {
+		last = MIN(num_runs,
+			(run / RUNS_PER_CHECKPOINT + 1) * RUNS_PER_CHECKPOINT);
+		stats_run_workers(run, last + 1, start);
+		if (last % RUNS_PER_CHECKPOINT == 0) stats_checkpoint(last);
+		if (quiet) {
+			printf("Finished %d runs.\n", last);
+			fflush(stdout);
+		}
+	}
+#else
 	for (run = 1; run <= num_runs; run++) {
 		if (!quiet) progress_bar(run - 1, start);
 
-		if (randarts) {
-			for (i = 0; i < z_info->a_max; i++) {
-				memcpy(&a_info[i], &a_info_save[i],
-					sizeof(struct artifact));
-				memcpy(&aup_info[i], &aup_info_save[i],
-					sizeof(struct artifact_upkeep));
-			}
-		}
-
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
+		stats_run_once(run);
 
 		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0) {
-			err = stats_write_db(run);
-			if (err) {
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
-						 err);
-			}
-		}
+		if (run % RUNS_PER_CHECKPOINT == 0) stats_checkpoint(run);
 
 		if (quiet && run % 1000 == 0) {
 			printf("Finished %d runs.\n", run);
 			fflush(stdout);
 		}
 	}
+#endif
 
 	if (!quiet) {
 		progress_bar(num_runs, start);
-		printf("\nSaving the data...\n");
+		printf("\n");
+		stats_report_churn();
+		printf("Saving the data...\n");
 		fflush(stdout);
 	}
 
@@ -1719,22 +2045,27 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers) -S(eed)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-SNNNN]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1)
+ *   -SNNNN  Seed the runs from NNNN, to repeat a set of runs (default: time)
  */
 
 errr init_stats(int argc, char *argv[]) {
 	int i;
 
+	/* L: Leave no snapshots of the data files in the user directory */
+	parse_snapshots = false;
+
 	/* Skip over argv[0] */
 	for (i = 1; i < argc; i++) {
 		if (streq(argv[i], "-r")) {
@@ -1749,6 +2080,25 @@ errr init_stats(int argc, char *argv[]) {
 			num_runs = atoi(&argv[i][2]);
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = atoi(&argv[i][2]);
+			if (num_workers < 1) num_workers = 1;
+			if (num_workers > MAX_STATS_WORKERS) {
+				num_workers = MAX_STATS_WORKERS;
+			}
+#ifndef UNIX
+			if (num_workers > 1) {
+				printf("init-stats: -j is only supported on Unix\n");
+				num_workers = 1;
+			}
+#endif
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = (uint32_t)strtoul(&argv[i][2], NULL, 10);
+			fixed_seed = true;
+			continue;
+		}
 		if (prefix(argv[i], "-s")) {
 			no_selling = 1;
 			continue;
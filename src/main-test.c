@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "buildid.h"
+#include "datafile.h"
 #include "main.h"
 #include "player.h"
 #include "player-birth.h"
@@ -301,6 +302,9 @@ const char help_test[] = "Test mode, subopts -p(rompt)";
 errr init_test(int argc, char *argv[]) {
 	int i;
 
+	/* L: Leave no snapshots of the data files in the user directory */
+	parse_snapshots = false;
+
 	/* Skip over argv[0] */
 	for (i = 1; i < argc; i++) {
 		if (streq(argv[i], "-p")) {
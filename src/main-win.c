@@ -58,6 +58,7 @@
 #include "buildid.h"
 #include "cmds.h"
 #include "cave.h"
+#include "datafile.h"
 #include "game-world.h"
 #include "grafmode.h"
 #include "init.h"
@@ -5388,6 +5389,9 @@ int FAR PASCAL WinMain(HINSTANCE hInst, HINSTANCE hPrevInst,
 	reinit_hook = win_reinit;
 	win_reinit();
 
+	/* L: Keep snapshots of the data files for quicker startups */
+	parse_snapshots = true;
+
 	/* Set up the display handlers and things. */
 	init_display();
 	init_angband();
@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "datafile.h"
 #include "init.h"
 #include "savefile.h"
 #include "ui-birth.h"
@@ -91,6 +92,10 @@ static const struct module modules[] =
 	{ "spoil", help_spoil, init_spoil },
 #endif
 
+#ifdef USE_BORG
+	{ "borg", help_borg, init_borg },
+#endif /* USE_BORG */
+
 #ifdef USE_IBM
 	{ "ibm", help_ibm, init_ibm },
 #endif /* USE_IBM */
@@ -200,6 +205,7 @@ static const struct {
 	{ "save", &ANGBAND_DIR_SAVE, false },
 	{ "panic", &ANGBAND_DIR_PANIC, false },
 	{ "archive", &ANGBAND_DIR_ARCHIVE, false },
+	{ "cache", &ANGBAND_DIR_CACHE, false },
 };
 
 /**
@@ -500,6 +506,12 @@ int main(int argc, char *argv[])
 
 #endif /* UNIX */
 
+	/*
+	 * L: Keep snapshots of the data files for quicker startups; the modules
+	 * that run unattended turn this back off
+	 */
+	parse_snapshots = true;
+
 	/* Try the modules in the order specified by modules[] */
 	for (i = 0; i < (int)N_ELEMENTS(modules); i++) {
 		/* User requested a specific module? */
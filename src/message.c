@@ -34,11 +34,12 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * A message in the history.  The text lives in the queue's arena.
+ */
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	uint32_t str;
 	uint16_t type;
 	uint16_t count;
 } message_t;
@@ -50,10 +51,19 @@ typedef struct _msgcolor_t
 	struct _msgcolor_t *next;
 } msgcolor_t;
 
+/**
+ * The message history is a fixed ring of messages, newest at `head`.  Their
+ * text is laid out in the same order in a ring of bytes, so making room for
+ * a new message only means forgetting the oldest ones, and nothing is
+ * allocated or freed once the queue is set up.
+ */
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
+	message_t *ring;
+	uint32_t head;
+	char *arena;
+	uint32_t arena_size;
+	uint32_t arena_head;
 	msgcolor_t *colors;
 	uint32_t count;
 	uint32_t max;
@@ -61,6 +71,12 @@ typedef struct _msgqueue_t
 
 static msgqueue_t *messages = NULL;
 
+/**
+ * Bytes of text kept per message of history, on average; longer messages
+ * just mean fewer are kept
+ */
+#define MESSAGE_TEXT_AVG 128
+
 /**
  * ------------------------------------------------------------------------
  * Functions operating on the entire list
@@ -73,6 +89,9 @@ void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
 	messages->max = 2048;
+	messages->ring = mem_zalloc(messages->max * sizeof(message_t));
+	messages->arena_size = messages->max * MESSAGE_TEXT_AVG;
+	messages->arena = mem_zalloc(messages->arena_size);
 }
 
 /**
@@ -82,15 +101,6 @@ void messages_free(void)
 {
 	msgcolor_t *c = messages->colors;
 	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
-	}
 
 	while (c) {
 		nextc = c->next;
@@ -98,6 +108,8 @@ void messages_free(void)
 		c = nextc;
 	}
 
+	mem_free(messages->arena);
+	mem_free(messages->ring);
 	mem_free(messages);
 }
 
@@ -113,6 +125,42 @@ uint16_t messages_num(void)
  * ------------------------------------------------------------------------
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
+/**
+ * Returns the message of age `age`.
+ */
+static message_t *message_get(uint16_t age)
+{
+	if (age >= messages->count) return NULL;
+	return &messages->ring[(messages->head + messages->max - age) %
+		messages->max];
+}
+
+/**
+ * Find room for `size` bytes of text at the front of the arena, forgetting
+ * the oldest messages until there is some, and return its offset.
+ */
+static uint32_t message_make_room(uint32_t size)
+{
+	while (messages->count) {
+		uint32_t tail = message_get(messages->count - 1)->str;
+		uint32_t head = messages->arena_head;
+
+		if (head > tail) {
+			/* Free space is past the head, then before the tail */
+			if (messages->arena_size - head >= size) return head;
+			if (tail >= size) return 0;
+		} else if (head < tail) {
+			/* Free space is between the head and the tail */
+			if (tail - head >= size) return head;
+		}
+
+		/* Forget the oldest message */
+		messages->count--;
+	}
+
+	return 0;
+}
+
 /**
  * Save a new message into the memory buffer, with text `str` and type `type`.
  * The type should be one of the MSG_ constants defined in message.h.
@@ -123,55 +171,33 @@ uint16_t messages_num(void)
  */
 void message_add(const char *str, uint16_t type)
 {
-	message_t *m;
+	message_t *m = message_get(0);
+	uint32_t size = strlen(str) + 1;
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    streq(messages->head->str, str) &&
-	    messages->head->count != (uint16_t)-1) {
-		messages->head->count++;
+	/* Overlong messages are cut short to fit */
+	size = MIN(size, messages->arena_size / 4);
+
+	/* L: Repeats are matched against the stored, possibly cut, text */
+	if (m && m->type == type && m->count != (uint16_t)-1 &&
+	    strlen(messages->arena + m->str) == size - 1 &&
+	    !strncmp(messages->arena + m->str, str, size - 1)) {
+		m->count++;
 		return;
 	}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
+	/* A full ring loses its oldest message */
+	if (messages->count == messages->max)
+		messages->count--;
+
+	m = &messages->ring[(messages->head + 1) % messages->max];
+	m->str = message_make_room(size);
+	my_strcpy(messages->arena + m->str, str, size);
 	m->type = type;
 	m->count = 1;
-	m->older = messages->head;
 
-	if (messages->head)
-		messages->head->newer = m;
-
-	messages->head = m;
+	messages->arena_head = m->str + size;
+	messages->head = (messages->head + 1) % messages->max;
 	messages->count++;
-
-	if (!messages->tail)
-		messages->tail = m;
-
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
-
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
-		messages->count--;
-	}
-}
-
-/**
- * Returns the message of age `age`.
- */
-static message_t *message_get(uint16_t age)
-{
-	message_t *m = messages->head;
-
-	while (m && age) {
-		age--;
-		m = m->older;
-	}
-
-	return m;
 }
 
 
@@ -185,7 +211,7 @@ static message_t *message_get(uint16_t age)
 const char *message_str(uint16_t age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->arena + m->str : "");
 }
 
 /**
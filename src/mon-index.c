@@ -0,0 +1,347 @@
+/**
+ * \file mon-index.c
+ * \brief Spatial index of the monsters on a level
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * L: The level is split into MON_INDEX_REGION square regions, and each
+ * region keeps one list of monsters per faction.  This lets monsters looking
+ * for something to fight visit only nearby regions which actually hold a
+ * hostile faction, nearest regions first, instead of scanning the whole
+ * monster list.  The index is kept up to date by place_monster(),
+ * monster_swap(), delete_monster_idx() and friends.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "init.h"
+#include "mon-index.h"
+
+/**
+ * Region holding a grid
+ */
+static int mon_index_region(const struct monster_index *idx, struct loc grid)
+{
+	return (grid.y / MON_INDEX_REGION) * idx->cols + grid.x / MON_INDEX_REGION;
+}
+
+/**
+ * Find the slot used for a faction, allocating one if needed
+ */
+static int mon_index_slot(struct monster_index *idx, wchar_t faction)
+{
+	int i;
+
+	for (i = 0; i < idx->num_factions; i++) {
+		if (idx->faction[i] == faction) return i;
+	}
+
+	/* Out of slots, so use the shared one */
+	if (idx->num_factions == MON_INDEX_SHARED) return MON_INDEX_SHARED;
+
+	idx->faction[idx->num_factions] = faction;
+	return idx->num_factions++;
+}
+
+/**
+ * Put a monster index at the front of a bucket
+ */
+static void mon_index_link(struct monster_index *idx, int midx, int bucket)
+{
+	int16_t first = idx->head[bucket];
+
+	idx->next[midx] = first;
+	idx->prev[midx] = 0;
+	if (first) idx->prev[first] = midx;
+	idx->head[bucket] = midx;
+	idx->bucket[midx] = bucket;
+	idx->present[bucket / MON_INDEX_FACTIONS] |=
+		(1U << (bucket % MON_INDEX_FACTIONS));
+}
+
+/**
+ * Take a monster index out of its bucket
+ */
+static void mon_index_unlink(struct monster_index *idx, int midx)
+{
+	int bucket = idx->bucket[midx];
+
+	if (bucket < 0) return;
+
+	if (idx->prev[midx]) {
+		idx->next[idx->prev[midx]] = idx->next[midx];
+	} else {
+		idx->head[bucket] = idx->next[midx];
+	}
+	if (idx->next[midx]) {
+		idx->prev[idx->next[midx]] = idx->prev[midx];
+	}
+	idx->next[midx] = 0;
+	idx->prev[midx] = 0;
+	idx->bucket[midx] = -1;
+
+	/* Note empty buckets */
+	if (!idx->head[bucket]) {
+		idx->present[bucket / MON_INDEX_FACTIONS] &=
+			~(1U << (bucket % MON_INDEX_FACTIONS));
+	}
+}
+
+/**
+ * Bucket a monster belongs in
+ */
+static int mon_index_bucket(struct monster_index *idx,
+		const struct monster *mon)
+{
+	return mon_index_region(idx, mon->grid) * MON_INDEX_FACTIONS +
+		mon_index_slot(idx, mon->faction);
+}
+
+/**
+ * Allocate an empty monster index for a chunk of the given size
+ */
+struct monster_index *mon_index_new(int height, int width)
+{
+	struct monster_index *idx = mem_zalloc(sizeof(*idx));
+	int regions, i;
+
+	idx->rows = (height + MON_INDEX_REGION - 1) / MON_INDEX_REGION;
+	idx->cols = (width + MON_INDEX_REGION - 1) / MON_INDEX_REGION;
+	regions = idx->rows * idx->cols;
+	idx->present = mem_zalloc(regions * sizeof(uint32_t));
+	idx->head = mem_zalloc(regions * MON_INDEX_FACTIONS * sizeof(int16_t));
+	idx->next = mem_zalloc(z_info->level_monster_max * sizeof(int16_t));
+	idx->prev = mem_zalloc(z_info->level_monster_max * sizeof(int16_t));
+	idx->bucket = mem_alloc(z_info->level_monster_max * sizeof(int32_t));
+	for (i = 0; i < z_info->level_monster_max; i++) {
+		idx->bucket[i] = -1;
+	}
+
+	return idx;
+}
+
+/**
+ * Free a monster index
+ */
+void mon_index_free(struct monster_index *idx)
+{
+	if (!idx) return;
+	mem_free(idx->present);
+	mem_free(idx->head);
+	mem_free(idx->next);
+	mem_free(idx->prev);
+	mem_free(idx->bucket);
+	mem_free(idx);
+}
+
+/**
+ * Empty the monster index of a chunk
+ */
+void mon_index_wipe(struct chunk *c)
+{
+	struct monster_index *idx = c->mon_index;
+	int regions = idx->rows * idx->cols, i;
+
+	memset(idx->present, 0, regions * sizeof(uint32_t));
+	memset(idx->head, 0, regions * MON_INDEX_FACTIONS * sizeof(int16_t));
+	memset(idx->next, 0, z_info->level_monster_max * sizeof(int16_t));
+	memset(idx->prev, 0, z_info->level_monster_max * sizeof(int16_t));
+	for (i = 0; i < z_info->level_monster_max; i++) {
+		idx->bucket[i] = -1;
+	}
+	idx->num_factions = 0;
+}
+
+/**
+ * Add a monster which has just been placed in a chunk to its index
+ */
+void mon_index_add(struct chunk *c, const struct monster *mon)
+{
+	struct monster_index *idx = c->mon_index;
+
+	assert(mon->midx > 0 && mon->midx < z_info->level_monster_max);
+	assert(square_in_bounds(c, mon->grid));
+	mon_index_unlink(idx, mon->midx);
+	mon_index_link(idx, mon->midx, mon_index_bucket(idx, mon));
+}
+
+/**
+ * Remove a monster which is leaving a chunk from its index
+ */
+void mon_index_remove(struct chunk *c, const struct monster *mon)
+{
+	assert(mon->midx > 0 && mon->midx < z_info->level_monster_max);
+	mon_index_unlink(c->mon_index, mon->midx);
+}
+
+/**
+ * Move a monster to the right bucket after its grid or faction changed
+ */
+void mon_index_update(struct chunk *c, const struct monster *mon)
+{
+	struct monster_index *idx = c->mon_index;
+	int bucket = mon_index_bucket(idx, mon);
+
+	if (idx->bucket[mon->midx] == bucket) return;
+	mon_index_unlink(idx, mon->midx);
+	mon_index_link(idx, mon->midx, bucket);
+}
+
+/**
+ * Note that the monster at index i1 is moving to index i2
+ */
+void mon_index_change_index(struct chunk *c, int i1, int i2)
+{
+	struct monster_index *idx = c->mon_index;
+	int bucket = idx->bucket[i1];
+
+	if (bucket < 0) return;
+	mon_index_unlink(idx, i1);
+	mon_index_unlink(idx, i2);
+	mon_index_link(idx, i2, bucket);
+}
+
+/**
+ * Rebuild the monster index of a chunk from its monster list, for use after
+ * monsters have been copied in wholesale
+ */
+void mon_index_rebuild(struct chunk *c)
+{
+	int i;
+
+	mon_index_wipe(c);
+	for (i = 1; i < c->mon_max; i++) {
+		struct monster *mon = &c->monsters[i];
+		if (!mon->race) continue;
+		mon_index_link(c->mon_index, i, mon_index_bucket(c->mon_index, mon));
+	}
+}
+
+/**
+ * Number of faction slots in use in a chunk's monster index
+ */
+int mon_index_num_factions(struct chunk *c)
+{
+	return c->mon_index->num_factions;
+}
+
+/**
+ * Faction held by a slot of a chunk's monster index
+ */
+wchar_t mon_index_faction(struct chunk *c, int slot)
+{
+	assert(slot >= 0 && slot < c->mon_index->num_factions);
+	return c->mon_index->faction[slot];
+}
+
+/**
+ * Start iterating over the monsters in the given faction slots, roughly
+ * nearest to the given grid first
+ */
+void mon_index_iter_init(struct mon_index_iter *iter, struct chunk *c,
+		struct loc grid, uint32_t slots)
+{
+	struct monster_index *idx = c->mon_index;
+
+	iter->c = c;
+	iter->slots = slots;
+	region_ring_init(&iter->walk, idx->rows, idx->cols,
+		grid.x / MON_INDEX_REGION, grid.y / MON_INDEX_REGION);
+	iter->slot = -1;
+	iter->midx = 0;
+}
+
+/**
+ * Get the next monster from an iterator, or NULL if there are no more
+ */
+struct monster *mon_index_iter_next(struct mon_index_iter *iter)
+{
+	struct monster_index *idx = iter->c->mon_index;
+
+	while (!iter->midx) {
+		int region = iter->walk.y * idx->cols + iter->walk.x;
+		uint32_t left = idx->present[region] & iter->slots;
+
+		/* Drop the slots already visited in this region */
+		if (iter->slot >= 0) {
+			left &= (iter->slot + 1 < MON_INDEX_FACTIONS) ?
+				~((1U << (iter->slot + 1)) - 1) : 0;
+		}
+
+		if (left) {
+			int slot = iter->slot + 1;
+			while (!(left & (1U << slot))) slot++;
+			iter->slot = slot;
+			iter->midx = idx->head[region * MON_INDEX_FACTIONS + slot];
+		} else {
+			iter->slot = -1;
+			if (!region_ring_next(&iter->walk)) return NULL;
+		}
+	}
+
+	/* Return the current monster and step on to the next */
+	{
+		int16_t midx = iter->midx;
+		iter->midx = idx->next[midx];
+		return &iter->c->monsters[midx];
+	}
+}
+
+/**
+ * Lower bound on the distance() from the centre grid to the monster last
+ * returned by an iterator, and to every monster it has yet to return
+ */
+int mon_index_iter_bound(const struct mon_index_iter *iter)
+{
+	return region_ring_bound(&iter->walk, MON_INDEX_REGION);
+}
+
+/**
+ * Check that every monster on a chunk is in the right bucket and nothing
+ * else is
+ */
+bool mon_index_verify(struct chunk *c)
+{
+	struct monster_index *idx = c->mon_index;
+	int i, listed = 0, count = 0;
+
+	for (i = 1; i < z_info->level_monster_max; i++) {
+		struct monster *mon = &c->monsters[i];
+		int bucket = idx->bucket[i];
+
+		if (i >= c->mon_max || !mon->race) {
+			if (bucket >= 0) return false;
+			continue;
+		}
+		count++;
+		if (bucket < 0) return false;
+		if (bucket / MON_INDEX_FACTIONS != mon_index_region(idx, mon->grid)) {
+			return false;
+		}
+		if (bucket % MON_INDEX_FACTIONS != MON_INDEX_SHARED &&
+				idx->faction[bucket % MON_INDEX_FACTIONS] != mon->faction) {
+			return false;
+		}
+	}
+
+	for (i = 0; i < idx->rows * idx->cols * MON_INDEX_FACTIONS; i++) {
+		int16_t midx;
+		for (midx = idx->head[i]; midx; midx = idx->next[midx]) {
+			if (idx->bucket[midx] != i) return false;
+			listed++;
+		}
+	}
+
+	return listed == count;
+}
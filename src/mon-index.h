@@ -0,0 +1,80 @@
+/**
+ * \file mon-index.h
+ * \brief Spatial index of the monsters on a level
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef MON_INDEX_H
+#define MON_INDEX_H
+
+#include "cave.h"
+#include "monster.h"
+
+/**
+ * Side length, in grids, of the square regions the level is split into
+ */
+#define MON_INDEX_REGION 8
+
+/**
+ * Number of faction lists kept per region; factions beyond the first
+ * MON_INDEX_FACTIONS - 1 seen on a level all share the last list
+ */
+#define MON_INDEX_FACTIONS 32
+#define MON_INDEX_SHARED (MON_INDEX_FACTIONS - 1)
+
+/**
+ * The monsters of a chunk, bucketed by region and faction.  Each bucket is
+ * a doubly linked list threaded through arrays indexed by monster index.
+ */
+struct monster_index {
+	int rows;			/**< Number of region rows */
+	int cols;			/**< Number of region columns */
+	int num_factions;	/**< Number of faction slots in use */
+	wchar_t faction[MON_INDEX_FACTIONS];	/**< Faction held by each slot */
+	uint32_t *present;	/**< Per region, which faction slots are occupied */
+	int16_t *head;		/**< Per (region, slot), first monster in the bucket */
+	int16_t *next;		/**< Per monster, next monster in its bucket */
+	int16_t *prev;		/**< Per monster, previous monster in its bucket */
+	int32_t *bucket;	/**< Per monster, its bucket or -1 if unlisted */
+};
+
+/**
+ * Walks the buckets of an index in rings of regions around a grid, so
+ * monsters are visited roughly nearest first.
+ */
+struct mon_index_iter {
+	struct chunk *c;
+	uint32_t slots;		/**< Faction slots to visit */
+	struct region_ring walk;	/**< Current region */
+	int slot;			/**< Current faction slot in the current region */
+	int16_t midx;		/**< Next monster to return, or 0 */
+};
+
+struct monster_index *mon_index_new(int height, int width);
+void mon_index_free(struct monster_index *idx);
+void mon_index_wipe(struct chunk *c);
+void mon_index_add(struct chunk *c, const struct monster *mon);
+void mon_index_remove(struct chunk *c, const struct monster *mon);
+void mon_index_update(struct chunk *c, const struct monster *mon);
+void mon_index_change_index(struct chunk *c, int i1, int i2);
+void mon_index_rebuild(struct chunk *c);
+int mon_index_num_factions(struct chunk *c);
+wchar_t mon_index_faction(struct chunk *c, int slot);
+void mon_index_iter_init(struct mon_index_iter *iter, struct chunk *c,
+		struct loc grid, uint32_t slots);
+struct monster *mon_index_iter_next(struct mon_index_iter *iter);
+int mon_index_iter_bound(const struct mon_index_iter *iter);
+bool mon_index_verify(struct chunk *c);
+
+#endif /* !MON_INDEX_H */
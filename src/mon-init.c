@@ -2059,6 +2059,7 @@ static void cleanup_monster(void)
 	}
 
 	mem_free(r_info);
+	lookup_monster_index_free();
 }
 
 struct file_parser monster_parser = {
@@ -21,6 +21,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-lore.h"
 #include "mon-make.h"
 #include "mon-move.h"
@@ -354,9 +355,10 @@ void delete_monster_idx(struct chunk *c, int m_idx)
 		(void) player_clear_timed(player, TMD_COMMAND, true, true);
 	}
 
-	/* Monster is gone from square and group */
+	/* Monster is gone from square, group and index */
 	square_set_mon(c, grid, 0);
 	monster_remove_from_groups(c, mon);
+	mon_index_remove(c, mon);
 
 	/* Delete objects */
 	struct object *obj = mon->held_obj;
@@ -440,6 +442,7 @@ void monster_index_move(struct chunk *c, int i1, int i2)
 	square_set_mon(c, mon->grid, i2);
 
 	/* Update midx */
+	mon_index_change_index(c, i1, i2);
 	mon->midx = i2;
 
 	/* Update group */
@@ -623,6 +626,9 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		}
 	}
 
+	/* Empty the monster index */
+	mon_index_wipe(c);
+
 	/* Reset "cave->mon_max" */
 	c->mon_max = 1;
 
@@ -812,7 +818,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon,
 			}
 
 			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			obj = object_new();
 			object_prep(obj, kind, 100, RANDOMISE);
 			obj->artifact = art;
 			copy_artifact_data(obj, obj->artifact);
@@ -829,8 +835,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon,
 				any = true;
 			} else {
 				mark_artifact_created(obj->artifact, false);
-				object_wipe(obj);
-				mem_free(obj);
+				object_free(obj);
 			}
 		}
 	}
@@ -843,7 +848,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon,
 		/* Specified by tval or by kind */
 		if (drop->kind) {
 			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			obj = object_new();
 			object_prep(obj, drop->kind, level, RANDOMISE);
 			apply_magic(obj, level, true, (good && one_in_(10)) || great, great && one_in_(10), extra_roll);
 		} else {
@@ -867,8 +872,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon,
 		if (monster_carry(c, mon, obj)) {
 			any = true;
 		} else {
-			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
@@ -903,8 +907,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon,
 			if (obj->artifact) {
 				mark_artifact_created(obj->artifact, false);
 			}
-			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
@@ -1051,6 +1054,9 @@ int16_t place_monster(struct chunk *c, struct loc grid, struct monster *mon,
 	/* Assign monster to its monster group */
 	monster_group_assign(c, new_mon, info, loading);
 
+	/* L: file it in the spatial index */
+	mon_index_add(c, new_mon);
+
 	update_mon(new_mon, c, true);
 
 	/* Count the number of "reproducers" */
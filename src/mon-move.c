@@ -25,11 +25,13 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "monster.h"
 #include "mon-attack.h"
 #include "mon-desc.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-lore.h"
 #include "mon-make.h"
 #include "mon-move.h"
@@ -55,20 +57,109 @@
  * L: Routines to handle monsters targeting each other
  */
 
-struct opposed_monster_char opposed_chars[] =
+/**
+ * Which factions fight each other, indexed by faction glyph.  Everything
+ * but the row and column for the player's allies ('@') comes from
+ * faction.txt; those depend on the player's current monster form, and are
+ * refreshed by update_player_faction() whenever that changes.
+ */
+static bool faction_hostility[FACTION_MAX][FACTION_MAX];
+
+/**
+ * Row of the hostility table for a faction; glyphs past the end of the
+ * table share row 0 with monsters that have no faction
+ */
+static int faction_index(wchar_t faction)
 {
-	{'C', 'f'},
-	{'s', 'A'},
-	{'G', 'A'},
-	{'L', 'A'},
-	{'V', 'A'},
-	{'W', 'A'},
-	{'z', 'A'},
-	{'U', 'A'},
-	{'u', 'A'},
-	{-1, -1}
+	return (faction > 0 && faction < FACTION_MAX) ? (int) faction : 0;
+}
+
+static enum parser_error parse_faction_faction(struct parser *p) {
+	wchar_t glyph = parser_getchar(p, "glyph");
+
+	if (faction_index(glyph) == 0 || glyph == '@')
+		return PARSE_ERROR_INVALID_VALUE;
+	parser_setpriv(p, faction_hostility[glyph]);
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_faction_enemy(struct parser *p) {
+	bool *row = parser_priv(p);
+	wchar_t glyph = parser_getchar(p, "glyph");
+	int faction;
+
+	if (!row)
+		return PARSE_ERROR_MISSING_RECORD_HEADER;
+	if (faction_index(glyph) == 0 || glyph == '@')
+		return PARSE_ERROR_INVALID_VALUE;
+
+	/* Hostility always goes both ways */
+	faction = (row - faction_hostility[0]) / FACTION_MAX;
+	faction_hostility[faction][glyph] = true;
+	faction_hostility[glyph][faction] = true;
+	return PARSE_ERROR_NONE;
+}
+
+static struct parser *init_parse_faction(void) {
+	struct parser *p = parser_new();
+	parser_setpriv(p, NULL);
+
+	memset(faction_hostility, 0, sizeof(faction_hostility));
+	parser_reg(p, "faction char glyph", parse_faction_faction);
+	parser_reg(p, "enemy char glyph", parse_faction_enemy);
+	return p;
+}
+
+static errr run_parse_faction(struct parser *p) {
+	return parse_file_quit_not_found(p, "faction");
+}
+
+static errr finish_parse_faction(struct parser *p) {
+	/* Until the player takes a monster form, allies fight everything */
+	update_player_faction(NULL);
+	parser_destroy(p);
+	return 0;
+}
+
+static void cleanup_faction(void)
+{
+	memset(faction_hostility, 0, sizeof(faction_hostility));
+}
+
+struct file_parser faction_parser = {
+	"faction",
+	init_parse_faction,
+	run_parse_faction,
+	finish_parse_faction,
+	cleanup_faction
 };
 
+/**
+ * Refresh which factions the player's allies fight, after the player's
+ * monster form changes.  Allies fight everything except other allies and
+ * monsters of the player's own kind.
+ */
+void update_player_faction(const struct player *p)
+{
+	struct monster_race *form = p ? lookup_player_monster(p) : NULL;
+	int form_faction = form ? faction_index(form->d_char) : 0;
+	int i;
+
+	for (i = 0; i < FACTION_MAX; i++) {
+		bool hostile = (i != '@') && (!form_faction || i != form_faction);
+		faction_hostility['@'][i] = hostile;
+		faction_hostility[i]['@'] = hostile;
+	}
+}
+
+/**
+ * Whether monsters of two factions will fight each other
+ */
+bool factions_hostile(wchar_t faction1, wchar_t faction2)
+{
+	return faction_hostility[faction_index(faction1)][faction_index(faction2)];
+}
+
 bool mon_will_attack_player(const struct monster *mon, const struct player *p)
 {
 	if (mon->faction == '@') return false;
@@ -81,42 +172,48 @@ bool mon_will_attack_player(const struct monster *mon, const struct player *p)
 
 static bool mon_will_attack_mon(const struct monster *mon, const struct monster *other)
 {
-	int i = 0;
-
-	if (mon->faction == '@' && mon_will_attack_player(other, player)) return true;
-	if (other->faction == '@' && mon_will_attack_player(mon, player)) return true;
-
-	while (opposed_chars[i].char1 >= 0) {
-
-		if (mon->faction == opposed_chars[i].char1 &&
-		    other->faction == opposed_chars[i].char2)
-			return true;
-
-		if (other->faction == opposed_chars[i].char1 &&
-		    mon->faction == opposed_chars[i].char2)
-			return true;
-
-		i++;
-	}
-
-    return false;
+	return factions_hostile(mon->faction, other->faction);
 }
 
+/**
+ * L: Find the best monster for a monster to attack.
+ *
+ * Candidates are scored by distance plus a fifth of their level, and the
+ * lowest scoring one in line of sight wins, ties going to the lowest index.
+ * The level's monster index hands out hostile monsters a ring of regions at
+ * a time, so the search can stop once no unvisited monster could beat the
+ * best one found.
+ */
 static void mon_find_target(struct chunk *c, struct monster *mon)
 {
-    int i;
+	struct mon_index_iter iter;
+	struct monster *other;
+	uint32_t slots = (1U << MON_INDEX_SHARED);
 	bool found = false;
 	int score = 0;
+	int i;
+
+	/* Only visit the factions this monster will fight */
+	for (i = 0; i < mon_index_num_factions(c); i++) {
+		if (factions_hostile(mon->faction, mon_index_faction(c, i)))
+			slots |= (1U << i);
+	}
+
+	mon_index_iter_init(&iter, c, mon->grid, slots);
+	while ((other = mon_index_iter_next(&iter))) {
+		int currscore;
+
+		/* Nothing further away can do better */
+		if (found && mon_index_iter_bound(&iter) > score) break;
 
-	for (i = 0; i < c->mon_max; i++) {
-		struct monster *other = &c->monsters[i];
-		if (!other->race) continue;
 		if (!mon_will_attack_mon(mon, other)) continue;
-		int currscore = other->race->level / 5 + distance(mon->grid, other->grid);
-		if (found && currscore >= score) continue;
+		currscore = other->race->level / 5 + distance(mon->grid, other->grid);
+		if (found && (currscore > score ||
+				(currscore == score && other->midx > mon->target.midx)))
+			continue;
 		if (!los(c, mon->grid, other->grid)) continue;
 
-		mon->target.midx = i;
+		mon->target.midx = other->midx;
 		score = currscore;
 		found = true;
 	}
@@ -606,6 +703,53 @@ static bool get_move_advance(struct monster *mon, bool *track)
 	return false;
 }
 
+/**
+ * L: Choose the best step towards another monster being pursued, following
+ * the flow field shared by everything pursuing it.
+ *
+ * Rock-eaters go straight there, as do monsters next to their target; the
+ * rest take the neighbouring grid fewest steps from the target that they
+ * can enter.
+ */
+static bool get_move_pursue(struct monster *mon, const struct monster *other)
+{
+	const uint16_t *dist;
+	int i, best;
+	bool found = false;
+
+	if (!other->race || monster_passes_walls(mon)) return false;
+	if (distance(mon->grid, other->grid) <= 1) return false;
+
+	dist = cave_monster_flow(cave, other);
+	best = dist[grid_to_i(mon->grid, cave->width)];
+
+	/* Out of reach of the field */
+	if (!best) return false;
+
+	for (i = 0; i < 8; i++) {
+		struct loc grid = loc_sum(mon->grid, ddgrid_ddd[i]);
+		int steps;
+
+		if (!square_in_bounds(cave, grid)) continue;
+		steps = dist[grid_to_i(grid, cave->width)];
+		if (!steps || steps >= best) continue;
+
+		/* There's a monster blocking that we can't deal with */
+		if (!monster_can_kill(mon, grid) && !monster_can_move(mon, grid)) {
+			continue;
+		}
+
+		/* There's damaging terrain */
+		if (monster_hates_grid(mon, grid)) continue;
+
+		mon->target.grid = grid;
+		best = steps;
+		found = true;
+	}
+
+	return found;
+}
+
 /**
  * Choose a random passable grid adjacent to the monster since is has no better
  * strategy.
@@ -798,7 +942,7 @@ static bool get_move_flee(struct monster *mon)
 
 	/* Check nearby grids, diagonals first */
 	for (i = 7; i >= 0; i--) {
-		int dis, score;
+		int dis, score, noise;
 
 		/* Get the location */
 		struct loc grid = loc_sum(mon->grid, ddgrid_ddd[i]);
@@ -809,11 +953,22 @@ static bool get_move_flee(struct monster *mon)
 		/* Calculate distance of this grid from our target */
 		dis = distance(grid, mon->target.grid);
 
+		/*
+		 * L: The noise is only filled out to earshot, so a grid that
+		 * carries sound but was left at 0 is further from the player
+		 * than anything filled, not next to them
+		 */
+		noise = cave->noise.grids[grid.y][grid.x];
+		if (!noise && !square_isnoflow(cave, grid)
+				&& !loc_eq(grid, cave->noise_field.origin)) {
+			noise = cave->noise_field.limit + 1;
+		}
+
 		/* Score this grid
 		 * First half of calculation is inversely proportional to distance
 		 * Second half is inversely proportional to grid's distance from player
 		 */
-		score = 5000 / (dis + 3) - 500 /(cave->noise.grids[grid.y][grid.x] + 1);
+		score = 5000 / (dis + 3) - 500 / (noise + 1);
 
 		/* No negative scores */
 		if (score < 0) score = 0;
@@ -968,7 +1123,9 @@ static bool get_move(struct monster *mon, int *dir, bool *good)
 		mon->target.grid = mon->grid;
 		grid = loc_diff(mon->target.grid, mon->grid);
 	} else if (mon->target.midx != MON_TARGET_PLAYER) {
-		mon->target.grid = target;
+		/* L: find a way round anything in between */
+		if (!get_move_pursue(mon, &cave->monsters[mon->target.midx]))
+			mon->target.grid = target;
 		grid = loc_diff(mon->target.grid, mon->grid);
 	} else if (get_move_advance(mon, good)) {
 		/* We have a good move, use it */
@@ -1901,7 +2058,8 @@ static void monster_reduce_sleep(struct monster *mon)
 		int local_noise = cave->noise.grids[mon->grid.y][mon->grid.x];
 		bool woke_up = false;
 		int curr = mon->m_timed[MON_TMD_SLEEP];
-		int distfact = MAX(0, 20 - local_noise) / 2;
+		/* L: no noise at all means the player is out of earshot */
+		int distfact = local_noise ? MAX(0, 20 - local_noise) / 2 : 0;
 		int16_t sred = 1 << MIN(14, distfact) / MAX(stealth + 1, 1);
 
 		/* Note a complete wakeup */
@@ -21,10 +21,11 @@
 #define MON_TARGET_PLAYER -1
 #define MON_TARGET_NONE -2
 
-struct opposed_monster_char {
-	int char1;
-	int char2;
-};
+/**
+ * L: Monster factions are named by glyph; glyphs from here on are treated as
+ * having no faction
+ */
+#define FACTION_MAX 128
 
 enum monster_stagger {
 	 NO_STAGGER = 0,
@@ -32,6 +33,10 @@ enum monster_stagger {
 	 INNATE_STAGGER = 2
 };
 
+extern struct file_parser faction_parser;
+
+void update_player_faction(const struct player *p);
+bool factions_hostile(wchar_t faction1, wchar_t faction2);
 bool mon_will_attack_player(const struct monster *mon, const struct player *player);
 bool mon_check_target(struct chunk *c, struct monster *mon);
 bool multiply_monster(const struct monster *mon);
@@ -22,6 +22,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-make.h"
 #include "mon-summon.h"
 #include "mon-util.h"
@@ -473,8 +474,10 @@ int summon_specific(struct loc grid, int lev, int type, bool delay, bool call, w
 	/* Success, return the level of the monster */
 	mon = square_monster(cave, near);
 
-	if (faction)
-	    mon->faction = faction;
+	if (faction) {
+		mon->faction = faction;
+		mon_index_update(cave, mon);
+	}
 
 	/* If delay, try to let the player act before the summoned monsters,
 	 * including holding faster monsters for the required number of turns */
@@ -22,6 +22,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
@@ -34,6 +35,7 @@
 #include "obj-desc.h"
 #include "obj-gear.h"
 #include "obj-ignore.h"
+#include "obj-index.h"
 #include "obj-knowledge.h"
 #include "obj-pile.h"
 #include "obj-slays.h"
@@ -46,6 +48,7 @@
 #include "player-util.h"
 #include "project.h"
 #include "trap.h"
+#include "z-hash.h"
 
 /**
  * ------------------------------------------------------------------------
@@ -111,6 +114,46 @@ void create_mon_flag_mask(bitflag *f, ...)
  * ------------------------------------------------------------------------
  * Lookup utilities
  * ------------------------------------------------------------------------ */
+/**
+ * L: Index of r_info by name, ignoring case; built the first time it is
+ * needed and freed along with r_info
+ */
+static struct hash_index race_by_name;
+static int races_indexed;
+
+void lookup_monster_index_free(void)
+{
+	hash_index_free(&race_by_name);
+	races_indexed = 0;
+}
+
+/**
+ * Returns the monster with exactly the given name, ignoring case, or NULL.
+ */
+static struct monster_race *lookup_monster_exact(const char *name)
+{
+	uint32_t hash = hash_nocase(name);
+	size_t probe = 0;
+	int i, found = -1;
+
+	/* Bring the index up to date with r_info */
+	if (races_indexed > z_info->r_max) lookup_monster_index_free();
+	for (; races_indexed < z_info->r_max; races_indexed++) {
+		if (r_info[races_indexed].name) {
+			hash_index_add(&race_by_name,
+				hash_nocase(r_info[races_indexed].name), races_indexed);
+		}
+	}
+
+	/* Look for it; the first in r_info wins */
+	while ((i = hash_index_next(&race_by_name, hash, &probe)) >= 0) {
+		if ((found < 0 || i < found) && !my_stricmp(name, r_info[i].name))
+			found = i;
+	}
+
+	return found >= 0 ? &r_info[found] : NULL;
+}
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
  * given, returns the first monster with the given name as a (case-insensitive)
@@ -119,25 +162,18 @@ void create_mon_flag_mask(bitflag *f, ...)
 struct monster_race *lookup_monster(const char *name)
 {
 	int i;
-	struct monster_race *closest = NULL;
+	struct monster_race *race = lookup_monster_exact(name);
 
-	/* Look for it */
-	for (i = 0; i < z_info->r_max; i++) {
-		struct monster_race *race = &r_info[i];
-		if (!race->name)
-			continue;
+	if (race) return race;
 
-		/* Test for equality */
-		if (my_stricmp(name, race->name) == 0)
+	/* L: The slow path, only for names which are not exact */
+	for (i = 0; i < z_info->r_max; i++) {
+		race = &r_info[i];
+		if (race->name && my_stristr(race->name, name))
 			return race;
-
-		/* Test for close matches */
-		if (!closest && my_stristr(race->name, name))
-			closest = race;
 	}
 
-	/* Return our best match */
-	return closest;
+	return NULL;
 }
 
 /**
@@ -598,6 +634,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 			}
 		}
 		mon->grid = grid2;
+		mon_index_update(cave, mon);
 		update_mon(mon, cave, true);
 
 		/* Affect light? */
@@ -645,6 +682,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 			}
 		}
 		mon->grid = grid1;
+		mon_index_update(cave, mon);
 		update_mon(mon, cave, true);
 
 		/* Affect light? */
@@ -1361,21 +1399,42 @@ bool monster_taking_terrain_damage(struct chunk *c, struct monster *mon)
 }
 
 
+/**
+ * L: Find the nearest object a monster which takes items can see and would
+ * pick up, within distance 100.  Floor piles are visited region by region,
+ * outwards from the monster, until no unvisited pile could be nearer than
+ * the best one found.
+ */
 struct object *monster_nearest_takeable_item(struct chunk *c, struct monster *mon) {
-    if (!rf_has(mon->race->flags, RF_TAKE_ITEM)) return NULL;
-	int i; int dist = 100;
-	struct object *obj;
+	struct obj_index_iter iter;
 	struct object *best = NULL;
+	struct loc grid;
+	int dist = 100;
 
-	for (i = 0; i < c->obj_max; i++) {
-		obj = c->objects[i];
-        if (!obj) continue;
-		if (tval_is_money(obj)) continue;
-		if (obj->mimicking_m_idx) continue;
-		if (react_to_slay(obj, mon)) continue;
-        if (los(cave, mon->grid, obj->grid) && 
-		        distance(mon->grid, obj->grid) < dist) {
+	if (!rf_has(mon->race->flags, RF_TAKE_ITEM)) return NULL;
+
+	obj_index_iter_init(&iter, c, mon->grid);
+	while (obj_index_iter_next(&iter, &grid)) {
+		struct object *obj;
+		int d;
+
+		/* Nothing left can be nearer */
+		if (obj_index_iter_bound(&iter) >= dist) break;
+
+		d = distance(mon->grid, grid);
+		if (d >= dist) continue;
+
+		for (obj = square_object(c, grid); obj; obj = obj->next) {
+			if (tval_is_money(obj)) continue;
+			if (obj->mimicking_m_idx) continue;
+			if (react_to_slay(obj, mon)) continue;
+			break;
+		}
+
+		/* Only check line of sight for piles worth having */
+		if (obj && los(c, mon->grid, grid)) {
 			best = obj;
+			dist = d;
 		}
 	}
 	return best;
@@ -1742,9 +1801,9 @@ bool monster_revert_shape(struct monster *mon)
 }
 
 
-static void rearrange_monster(struct monster_race *mr)
+static void rearrange_monster(struct monster_race *mr, struct rng *r)
 {
-	int power = mr->level + randint0(mr->level / 5 + 1) - randint0(mr->level / 5 + 1);
+	int power = mr->level + rng_int0(r, mr->level / 5 + 1) - rng_int0(r, mr->level / 5 + 1);
 	int blows = 0;
 	bool spells = false, breaths = false;
 	int ttdam; // twice total dam
@@ -1762,11 +1821,11 @@ static void rearrange_monster(struct monster_race *mr)
 	maxtotal = power * 5 + 2;
 
 	// randomize different abilities
-	int dam = randint0(power + 2) + randint0(power);
-	int hp  = randint0(power + 2) + randint0(power);
-	int ac  = randint0(power + 2) + randint0(power);
-	int spe = randint0(power + 2) + randint0(power);
-	int mag = randint0(power + 2) + randint0(power);
+	int dam = rng_int0(r, power + 2) + rng_int0(r, power);
+	int hp  = rng_int0(r, power + 2) + rng_int0(r, power);
+	int ac  = rng_int0(r, power + 2) + rng_int0(r, power);
+	int spe = rng_int0(r, power + 2) + rng_int0(r, power);
+	int mag = rng_int0(r, power + 2) + rng_int0(r, power);
 
 	// check if it has no attacks or no spells
 	i = 0;
@@ -1838,15 +1897,15 @@ static void rearrange_monster(struct monster_race *mr)
 
 void rearrange_monsters(struct monster_race *mraces, uint32_t seed)
 {
-	Rand_quick = true;
-	Rand_value = seed;
-	
 	struct monster_base *pbase = lookup_monster_base("player");
 	struct monster_race *curr;
+	struct rng r;
+
+	/* L: A stream of its own, so the game's RNG is left alone */
+	rng_seed_quick(&r, seed);
 	for (curr = mraces; curr; curr = curr->next) {
 		if (curr->base == pbase) continue;
 		if (curr->level <= 0) continue;
-		rearrange_monster(curr);
+		rearrange_monster(curr, &r);
 	}
-	Rand_quick = false;
 }
@@ -24,6 +24,7 @@
 
 const char *describe_race_flag(int flag);
 void create_mon_flag_mask(bitflag *f, ...);
+void lookup_monster_index_free(void);
 struct monster_race *lookup_monster(const char *name);
 struct monster_base *lookup_monster_base(const char *name);
 bool match_monster_bases(const struct monster_base *base, ...);
@@ -0,0 +1,186 @@
+/**
+ * \file obj-index.c
+ * \brief Spatial index of the floor objects on a level
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * L: The level is split into OBJ_INDEX_REGION square regions, and each
+ * region counts the grids in it which hold a floor pile.  Anything looking
+ * for objects can then skip the empty parts of the level, and visit the
+ * rest nearest regions first.  Every change to the top of a floor pile goes
+ * through square_set_obj(), square_insert_object(), square_append_object()
+ * or square_excise_object(), which keep the counts up to date.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "obj-index.h"
+
+/**
+ * Region holding a grid
+ */
+static int obj_index_region(const struct object_index *idx, struct loc grid)
+{
+	return (grid.y / OBJ_INDEX_REGION) * idx->cols + grid.x / OBJ_INDEX_REGION;
+}
+
+/**
+ * Allocate an empty object index for a chunk of the given size
+ */
+struct object_index *obj_index_new(int height, int width)
+{
+	struct object_index *idx = mem_zalloc(sizeof(*idx));
+
+	idx->rows = (height + OBJ_INDEX_REGION - 1) / OBJ_INDEX_REGION;
+	idx->cols = (width + OBJ_INDEX_REGION - 1) / OBJ_INDEX_REGION;
+	idx->piles = mem_zalloc(idx->rows * idx->cols * sizeof(uint16_t));
+
+	return idx;
+}
+
+/**
+ * Free an object index
+ */
+void obj_index_free(struct object_index *idx)
+{
+	if (!idx) return;
+	mem_free(idx->piles);
+	mem_free(idx);
+}
+
+/**
+ * Note a change to the floor pile at a grid; had and has say whether the
+ * grid held any objects before and after the change
+ */
+void obj_index_note_pile(struct chunk *c, struct loc grid, bool had, bool has)
+{
+	struct object_index *idx = c->obj_index;
+	int region;
+
+	if (had == has) return;
+	region = obj_index_region(idx, grid);
+	if (has) {
+		idx->piles[region]++;
+	} else {
+		assert(idx->piles[region]);
+		idx->piles[region]--;
+	}
+}
+
+/**
+ * Find the first grid, starting from the given one and going in row order,
+ * which holds a floor pile.  Returns false if there are no more.
+ */
+bool obj_index_find_pile(struct chunk *c, struct loc *grid)
+{
+	struct object_index *idx = c->obj_index;
+	struct loc next = *grid;
+
+	while (next.y < c->height) {
+		if (next.x >= c->width) {
+			/* Next row */
+			next.x = 0;
+			next.y++;
+		} else if (!idx->piles[obj_index_region(idx, next)]) {
+			/* Skip the rest of this row of an empty region */
+			next.x = (next.x / OBJ_INDEX_REGION + 1) * OBJ_INDEX_REGION;
+		} else if (square(c, next)->obj) {
+			*grid = next;
+			return true;
+		} else {
+			next.x++;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Start iterating over the grids holding objects, roughly nearest to the
+ * given grid first
+ */
+void obj_index_iter_init(struct obj_index_iter *iter, struct chunk *c,
+		struct loc grid)
+{
+	struct object_index *idx = c->obj_index;
+
+	iter->c = c;
+	region_ring_init(&iter->walk, idx->rows, idx->cols,
+		grid.x / OBJ_INDEX_REGION, grid.y / OBJ_INDEX_REGION);
+	iter->cell = 0;
+}
+
+/**
+ * Get the next grid holding objects from an iterator.  Returns false if
+ * there are no more.
+ */
+bool obj_index_iter_next(struct obj_index_iter *iter, struct loc *grid)
+{
+	struct object_index *idx = iter->c->obj_index;
+
+	while (1) {
+		int rx = iter->walk.x, ry = iter->walk.y;
+
+		if (idx->piles[ry * idx->cols + rx]) {
+			while (iter->cell < OBJ_INDEX_REGION * OBJ_INDEX_REGION) {
+				struct loc next = loc(
+					rx * OBJ_INDEX_REGION + iter->cell % OBJ_INDEX_REGION,
+					ry * OBJ_INDEX_REGION + iter->cell / OBJ_INDEX_REGION);
+
+				iter->cell++;
+				if (!square_in_bounds(iter->c, next)) continue;
+				if (square(iter->c, next)->obj) {
+					*grid = next;
+					return true;
+				}
+			}
+		}
+
+		iter->cell = 0;
+		if (!region_ring_next(&iter->walk)) return false;
+	}
+}
+
+/**
+ * Lower bound on the distance() from the centre grid to the grid last
+ * returned by an iterator, and to every grid it has yet to return
+ */
+int obj_index_iter_bound(const struct obj_index_iter *iter)
+{
+	return region_ring_bound(&iter->walk, OBJ_INDEX_REGION);
+}
+
+/**
+ * Check that the count for every region of a chunk matches its floor piles
+ */
+bool obj_index_verify(struct chunk *c)
+{
+	struct object_index *idx = c->obj_index;
+	uint16_t *piles = mem_zalloc(idx->rows * idx->cols * sizeof(uint16_t));
+	struct loc grid;
+	bool good;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			if (square(c, grid)->obj) {
+				piles[obj_index_region(idx, grid)]++;
+			}
+		}
+	}
+
+	good = !memcmp(piles, idx->piles,
+		idx->rows * idx->cols * sizeof(uint16_t));
+	mem_free(piles);
+	return good;
+}
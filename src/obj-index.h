@@ -0,0 +1,58 @@
+/**
+ * \file obj-index.h
+ * \brief Spatial index of the floor objects on a level
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef OBJ_INDEX_H
+#define OBJ_INDEX_H
+
+#include "cave.h"
+
+/**
+ * Side length, in grids, of the square regions the level is split into
+ */
+#define OBJ_INDEX_REGION 8
+
+/**
+ * The floor piles of a chunk, counted by region.  The piles themselves stay
+ * on the squares; the counts only say which regions are worth looking in.
+ */
+struct object_index {
+	int rows;			/**< Number of region rows */
+	int cols;			/**< Number of region columns */
+	uint16_t *piles;	/**< Per region, number of grids holding objects */
+};
+
+/**
+ * Walks the grids holding objects in rings of regions around a grid, so
+ * piles are visited roughly nearest first.
+ */
+struct obj_index_iter {
+	struct chunk *c;
+	struct region_ring walk;	/**< Current region */
+	int cell;			/**< Next grid to look at in the current region */
+};
+
+struct object_index *obj_index_new(int height, int width);
+void obj_index_free(struct object_index *idx);
+void obj_index_note_pile(struct chunk *c, struct loc grid, bool had, bool has);
+bool obj_index_find_pile(struct chunk *c, struct loc *grid);
+void obj_index_iter_init(struct obj_index_iter *iter, struct chunk *c,
+		struct loc grid);
+bool obj_index_iter_next(struct obj_index_iter *iter, struct loc *grid);
+int obj_index_iter_bound(const struct obj_index_iter *iter);
+bool obj_index_verify(struct chunk *c);
+
+#endif /* !OBJ_INDEX_H */
@@ -2230,6 +2230,7 @@ static void cleanup_object(void)
 		free_effect(kind->effect);
 	}
 	mem_free(k_info);
+	lookup_kind_index_free();
 }
 
 struct file_parser object_parser = {
@@ -2675,6 +2676,7 @@ static void cleanup_ego(void)
 		}
 	}
 	mem_free(e_info);
+	lookup_ego_index_free();
 }
 
 struct file_parser ego_parser = {
@@ -889,7 +889,7 @@ void object_sense(struct player *p, struct object *obj)
 
 		/* Attach it to the current floor pile */
 		new_obj->grid = grid;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+		square_append_object(p->cave, grid, new_obj);
 	}
 }
 
@@ -920,7 +920,7 @@ void object_see(struct player *p, struct object *obj)
 
 		/* Attach it to the current floor pile */
 		new_obj->grid = grid;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+		square_append_object(p->cave, grid, new_obj);
 	} else {
 		struct loc old = known_obj->grid;
 
@@ -945,7 +945,7 @@ void object_see(struct player *p, struct object *obj)
 			}
 
 			known_obj->grid = grid;
-			pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, known_obj);
+			square_append_object(p->cave, grid, known_obj);
 		}
 	}
 }
@@ -1302,7 +1302,7 @@ struct object *make_gold(int lev, const char *coin_type)
 	int avg = (16 * lev)/10 + 16;
 	int spread = lev + 10;
 	int value = rand_spread(avg, spread);
-	struct object *new_gold = mem_zalloc(sizeof(*new_gold)); 
+	struct object *new_gold = object_new();
 
 	/* Increase the range to infinite, moving the average to 110% */
 	while (one_in_(100) && value * 10 <= SHRT_MAX)
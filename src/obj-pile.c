@@ -278,12 +278,50 @@ bool pile_contains(const struct object *top, const struct object *obj)
 	return false;
 }
 
+/**
+ * L: Objects are handed out from slabs of OBJECT_SLAB_SIZE, and freed
+ * objects go on a free list threaded through their next pointers, so the
+ * churn of making and discarding objects doesn't reach the system allocator.
+ */
+#define OBJECT_SLAB_SIZE 256
+
+struct object_slab {
+	struct object_slab *next;
+	struct object objects[OBJECT_SLAB_SIZE];
+};
+
+static struct object_slab *object_slabs;
+static struct object *object_free_list;
+static struct object_pool_counts pool_counts;
+
 /**
  * Create a new object and return it
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	struct object *obj;
+
+	if (!object_free_list) {
+		struct object_slab *slab = mem_alloc(sizeof(*slab));
+		int i;
+
+		for (i = OBJECT_SLAB_SIZE - 1; i >= 0; i--) {
+			slab->objects[i].next = object_free_list;
+			object_free_list = &slab->objects[i];
+		}
+		slab->next = object_slabs;
+		object_slabs = slab;
+		pool_counts.slabs++;
+	}
+
+	obj = object_free_list;
+	object_free_list = obj->next;
+	memset(obj, 0, sizeof(*obj));
+
+	pool_counts.made++;
+	pool_counts.live++;
+	pool_counts.peak = MAX(pool_counts.peak, pool_counts.live);
+	return obj;
 }
 
 /**
@@ -296,7 +334,105 @@ void object_free(struct object *obj)
 	mem_free(obj->slays);
 	mem_free(obj->brands);
 	mem_free(obj->curses);
-	mem_free(obj);
+
+	obj->next = object_free_list;
+	object_free_list = obj;
+	pool_counts.freed++;
+	pool_counts.live--;
+}
+
+/**
+ * L: Stop tracking an object that is going away
+ */
+static void object_untrack(const struct object *obj)
+{
+	if (player && player->upkeep && obj == player->upkeep->object)
+		player->upkeep->object = NULL;
+}
+
+/**
+ * L: Let an object go from a chunk that is being freed.  As in
+ * object_delete(), the player's memory of an object on the current level
+ * becomes imaginary, but the object itself is freed rather than orphaned,
+ * since nothing could reach it once the chunk has gone.
+ */
+static void object_free_from(struct chunk *c, struct object *obj)
+{
+	if (c == cave && player && player->cave && obj->known &&
+			obj->oidx > 0 && obj->oidx <= player->cave->obj_max &&
+			player->cave->objects[obj->oidx]) {
+		obj->known->notice |= OBJ_NOTICE_IMAGINED;
+	}
+	object_untrack(obj);
+	object_free(obj);
+}
+
+/**
+ * L: Free every object held by a chunk which is itself about to be freed.
+ *
+ * This frees the same objects cave_free() used to delete one at a time -
+ * the floor piles and the listed objects with no location, such as those
+ * held by monsters - without unlinking piles or tidying object lists that
+ * are going away anyway.
+ */
+void object_free_chunk(struct chunk *c)
+{
+	struct loc grid;
+	int i;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			struct object *obj = c->squares[grid.y][grid.x].obj;
+
+			while (obj) {
+				struct object *next = obj->next;
+
+				/* Don't meet it again in the object list */
+				if (obj->oidx > 0 && obj->oidx <= c->obj_max &&
+						c->objects[obj->oidx] == obj) {
+					c->objects[obj->oidx] = NULL;
+				}
+				object_free_from(c, obj);
+				obj = next;
+			}
+			c->squares[grid.y][grid.x].obj = NULL;
+		}
+	}
+
+	/* L: as elsewhere, the last slot isn't used (chunk_copy() leaves it unset) */
+	for (i = 1; i < c->obj_max; i++) {
+		struct object *obj = c->objects[i];
+
+		if (!obj || !loc_is_zero(obj->grid)) continue;
+		c->objects[i] = NULL;
+		object_free_from(c, obj);
+	}
+}
+
+/**
+ * L: Get the counts kept by the object pool
+ */
+const struct object_pool_counts *object_pool_counts(void)
+{
+	return &pool_counts;
+}
+
+/**
+ * L: Free the object pool's slabs.  Every object should have been freed
+ * first; any still out are lost with their slabs.
+ */
+void object_pool_free(void)
+{
+	assert(!pool_counts.live);
+	while (object_slabs) {
+		struct object_slab *slab = object_slabs;
+
+		object_slabs = slab->next;
+		mem_free(slab);
+	}
+	object_free_list = NULL;
+	pool_counts.live = 0;
+	pool_counts.slabs = 0;
 }
 
 /**
@@ -367,6 +503,17 @@ void object_pile_free(struct chunk *c, struct chunk *p_c, struct object *obj)
 {
 	struct object *current = obj, *next;
 
+	/* L: a pile outside any chunk has no lists to tidy, so just free it */
+	if (!c && !p_c) {
+		while (current) {
+			next = current->next;
+			object_untrack(current);
+			object_free(current);
+			current = next;
+		}
+		return;
+	}
+
 	while (current) {
 		next = current->next;
 		object_delete(c, p_c, &current);
@@ -427,6 +574,9 @@ bool object_similar(const struct object *obj1, const struct object *obj2,
 	/* Artifacts never stack */
 	if (obj1->artifact || obj2->artifact) return false;
 
+	/* L: a mimic's object must stay its own, or absorbing it frees it */
+	if (obj1->mimicking_m_idx || obj2->mimicking_m_idx) return false;
+
 	/* Analyze the items */
 	if (tval_is_chest(obj1)) {
 		/* Chests never stack */
@@ -950,7 +1100,7 @@ bool floor_carry(struct chunk *c, struct loc grid, struct object *drop,
 	drop->held_m_idx = 0;
 
 	/* Link to the first object in the pile */
-	pile_insert(&c->squares[grid.y][grid.x].obj, drop);
+	square_insert_object(c, grid, drop);
 
 	/* Record in the level list */
 	list_object(c, drop);
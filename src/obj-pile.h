@@ -48,8 +48,22 @@ typedef enum
 	OFLOOR_VISIBLE = 0x08, /* Visible items only */
 } object_floor_t;
 
+/**
+ * L: Counts kept by the object pool behind object_new() and object_free()
+ */
+struct object_pool_counts {
+	uint64_t made;		/* Objects handed out */
+	uint64_t freed;		/* Objects given back */
+	uint32_t live;		/* Objects out now */
+	uint32_t peak;		/* Most objects out at once */
+	uint32_t slabs;		/* Slabs allocated */
+};
+
 struct object *object_new(void);
 void object_free(struct object *obj);
+void object_free_chunk(struct chunk *c);
+const struct object_pool_counts *object_pool_counts(void);
+void object_pool_free(void);
 void object_delete(struct chunk *c, struct chunk *p_c,
 				   struct object **obj_address);
 void object_pile_free(struct chunk *c, struct chunk *p_c, struct object *obj);
@@ -41,6 +41,7 @@
 #include "player-spell.h"
 #include "player-util.h"
 #include "randname.h"
+#include "z-hash.h"
 #include "z-queue.h"
 
 struct object_base *kb_info;
@@ -484,19 +485,92 @@ unsigned check_for_inscrip_with_int(const struct object *obj, const char *inscri
 
 /*** Object kind lookup functions ***/
 
+/**
+ * L: Indices of k_info by (tval, sval) and by (tval, sval name), and of
+ * e_info by name.  They are built the first time they are needed, extended
+ * when k_info grows, and freed along with the arrays they index.
+ */
+static struct hash_index kind_by_sval;
+static struct hash_index kind_by_name;
+static int kinds_indexed;
+static struct hash_index ego_by_name;
+static int egos_indexed;
+
+static uint32_t kind_sval_hash(int tval, int sval)
+{
+	return hash_u32(((uint32_t) tval << 16) ^ (uint32_t) sval);
+}
+
+static uint32_t kind_name_hash(int tval, const char *name)
+{
+	return hash_u32(hash_nocase(name) + (uint32_t) tval);
+}
+
+/**
+ * The name of a kind as lookup_sval() matches it, without the plural and
+ * article markers
+ */
+static void kind_sval_name(char *buf, size_t len,
+		const struct object_kind *kind)
+{
+	obj_desc_name_format(buf, len, 0, kind->name, 0, false);
+}
+
+/**
+ * Bring the kind indices up to date with k_info
+ */
+static void kind_index_update(void)
+{
+	char name[1024];
+
+	if (kinds_indexed > z_info->k_max) lookup_kind_index_free();
+	for (; kinds_indexed < z_info->k_max; kinds_indexed++) {
+		struct object_kind *kind = &k_info[kinds_indexed];
+
+		hash_index_add(&kind_by_sval,
+			kind_sval_hash(kind->tval, kind->sval), kinds_indexed);
+		if (kind->name) {
+			kind_sval_name(name, sizeof(name), kind);
+			hash_index_add(&kind_by_name,
+				kind_name_hash(kind->tval, name), kinds_indexed);
+		}
+	}
+}
+
+/**
+ * Free the kind and ego indices, when k_info or e_info go away
+ */
+void lookup_kind_index_free(void)
+{
+	hash_index_free(&kind_by_sval);
+	hash_index_free(&kind_by_name);
+	kinds_indexed = 0;
+}
+
+void lookup_ego_index_free(void)
+{
+	hash_index_free(&ego_by_name);
+	egos_indexed = 0;
+}
+
 /**
  * Return the object kind with the given `tval` and `sval`, or NULL.
  */
 struct object_kind *lookup_kind(int tval, int sval)
 {
-	int k;
+	uint32_t hash = kind_sval_hash(tval, sval);
+	size_t probe = 0;
+	int k, found = -1;
 
-	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
+	/* Look for it; the first in k_info wins */
+	kind_index_update();
+	while ((k = hash_index_next(&kind_by_sval, hash, &probe)) >= 0) {
 		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+		if (kind->tval == tval && kind->sval == sval &&
+				(found < 0 || k < found))
+			found = k;
 	}
+	if (found >= 0) return &k_info[found];
 
 	/* Failure */
 	msg("No object: %d:%d (%s)", tval, sval, tval_find_name(tval));
@@ -546,28 +620,41 @@ const struct artifact *lookup_artifact_name(const char *name)
  */
 struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
 {
-	int i;
+	uint32_t hash = djb2_hash(name);
+	size_t probe = 0;
+	struct object_kind *kind;
+	int i, found = -1;
+
+	/* Bring the index up to date with e_info */
+	if (egos_indexed > z_info->e_max) lookup_ego_index_free();
+	for (; egos_indexed < z_info->e_max; egos_indexed++) {
+		if (e_info[egos_indexed].name) {
+			hash_index_add(&ego_by_name,
+				djb2_hash(e_info[egos_indexed].name), egos_indexed);
+		}
+	}
 
-	/* Look for it */
-	for (i = 0; i < z_info->e_max; i++) {
+	/* Look for it among the egos with that name */
+	while ((i = hash_index_next(&ego_by_name, hash, &probe)) >= 0) {
 		struct ego_item *ego = &e_info[i];
-		struct poss_item *poss_item = ego->poss_items;
+		struct poss_item *poss_item;
 
-		/* Reject nameless and wrong names */
-		if (!ego->name) continue;
 		if (!streq(name, ego->name)) continue;
+		if (found >= 0 && found < i) continue;
 
 		/* Check tval and sval */
-		while (poss_item) {
-			struct object_kind *kind = lookup_kind(tval, sval);
+		kind = lookup_kind(tval, sval);
+		if (!kind) return NULL;
+		for (poss_item = ego->poss_items; poss_item;
+				poss_item = poss_item->next) {
 			if (kind->kidx == poss_item->kidx) {
-				return ego;
+				found = i;
+				break;
 			}
-			poss_item = poss_item->next;
 		}
 	}
 
-	return NULL;
+	return found >= 0 ? &e_info[found] : NULL;
 }
 
 /**
@@ -576,7 +663,9 @@ struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
  */
 int lookup_sval(int tval, const char *name)
 {
-	int k;
+	uint32_t hash;
+	size_t probe = 0;
+	int k, found = -1;
 	char *pe;
 	unsigned long r = strtoul(name, &pe, 10);
 
@@ -585,20 +674,20 @@ int lookup_sval(int tval, const char *name)
 	}
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
+	kind_index_update();
+	hash = kind_name_hash(tval, name);
+	while ((k = hash_index_next(&kind_by_name, hash, &probe)) >= 0) {
 		struct object_kind *kind = &k_info[k];
 		char cmp_name[1024];
 
-		if (!kind || !kind->name || kind->tval != tval) continue;
-
-		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
-							 false);
+		if (kind->tval != tval || (found >= 0 && found < k)) continue;
+		kind_sval_name(cmp_name, sizeof cmp_name, kind);
 
 		/* Found a match */
-		if (!my_stricmp(cmp_name, name)) return kind->sval;
+		if (!my_stricmp(cmp_name, name)) found = k;
 	}
 
-	return -1;
+	return found >= 0 ? k_info[found].sval : -1;
 }
 
 void object_short_name(char *buf, size_t max, const char *name)
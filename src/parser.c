@@ -23,6 +23,7 @@
 #include "parser.h"
 #include "z-file.h"
 #include "z-form.h"
+#include "z-hash.h"
 #include "z-util.h"
 #include "z-virt.h"
 
@@ -47,13 +48,13 @@ enum {
 };
 
 struct parser_spec {
-	struct parser_spec *next;
 	int type;
 	const char *name;
+	uint32_t hash;				/**< djb2_hash() of the name */
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	int type;
 	union {
 		wchar_t cval;
 		int ival;
@@ -67,8 +68,11 @@ struct parser_hook {
 	struct parser_hook *next;
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
-	struct parser_spec *fhead;
-	struct parser_spec *ftail;
+	uint32_t hash;				/**< djb2_hash() of the directive */
+	int index;					/**< Position in the parser's hookv */
+	struct parser_spec *specs;	/**< Field specs, in slot order */
+	int nspecs;
+	struct hash_index slots;	/**< Slots of the specs by name hash */
 };
 
 struct parser {
@@ -77,9 +81,42 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **hookv;
+	int nhooks;
+	struct hash_index index;
+	struct parser_hook *cur;
+	struct parser_value *vals;
+	int nvals;
+	int max_vals;
+	char *scratch;
+	size_t scratch_size;
 	void *priv;
+	struct parser_record *rec;
+};
+
+/**
+ * L: The hooks are kept in hookv in the order they were registered, and found
+ * through a hash_index on the hash of the directive; of the hooks with the
+ * same directive, the latest registered is the one used.  The values of the
+ * current line live in an array with one slot per field spec of its hook; the
+ * hook maps the names of its specs to their slots when it is registered, so
+ * the getters go straight to a value.  Strings point into a scratch copy of
+ * the line which the parser keeps from line to line, so parsing a line
+ * allocates nothing once the buffers are big enough.
+ *
+ * While recording, each directive parser_parse() runs successfully is
+ * appended to a buffer, already split into its hook and values, so that
+ * parser_replay() can later run the same hooks without the text.  A record
+ * is the hook's position in the hook list, the number of values, the line
+ * number counted from the start of recording, and then the values in spec
+ * order: 32 bits for numbers and characters, four lots of 32 bits for random
+ * values, and a 32 bit length, the bytes and a terminating zero for strings.
+ */
+struct parser_record {
+	unsigned int first_line;
+	char *buf;
+	size_t len;
+	size_t size;
 };
 
 /**
@@ -90,26 +127,74 @@ struct parser *parser_new(void) {
 	return p;
 }
 
+/**
+ * Find the latest hook registered for a directive
+ */
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (streq(h->dir, dir))
-			break;
-		h = h->next;
+	uint32_t hash = djb2_hash(dir);
+	struct parser_hook *found = NULL;
+	size_t probe = 0;
+	int i;
+
+	while ((i = hash_index_next(&p->index, hash, &probe)) >= 0) {
+		struct parser_hook *h = p->hookv[i];
+		if (streq(h->dir, dir) && (!found || h->index > found->index))
+			found = h;
 	}
-	return h;
+	return found;
+}
+
+/**
+ * Add a hook to hookv and the index, superseding any other with the same
+ * directive
+ */
+static void addhook(struct parser *p, struct parser_hook *h) {
+	h->index = p->nhooks++;
+	p->hookv = mem_realloc(p->hookv, p->nhooks * sizeof(*p->hookv));
+	p->hookv[h->index] = h;
+	hash_index_add(&p->index, h->hash, h->index);
 }
 
 static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+	p->nvals = 0;
+	p->cur = NULL;
+}
+
+/**
+ * Split off the next field of a line at pos, skipping any empty ones; returns
+ * NULL if there are no more.  This and nextrest() split lines just as
+ * strtok() with ":" and "" for delimiters used to.
+ */
+static char *nextfield(char **pos) {
+	char *tok = *pos, *end;
+
+	while (*tok == ':')
+		tok++;
+	if (!*tok) {
+		*pos = tok;
+		return NULL;
 	}
+
+	end = strchr(tok, ':');
+	if (end) {
+		*end = '\0';
+		*pos = end + 1;
+	} else {
+		*pos = tok + strlen(tok);
+	}
+	return tok;
+}
+
+/**
+ * Take the rest of the line at pos, if there is any
+ */
+static char *nextrest(char **pos) {
+	char *tok = *pos;
+
+	if (!*tok)
+		return NULL;
+	*pos = tok + strlen(tok);
+	return tok;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -202,18 +287,73 @@ static bool parse_random(const char *str, random_value *bonus) {
 	return true;
 }
 
+/**
+ * Append some bytes to the recording
+ */
+static void parser_record_bytes(struct parser_record *rec, const void *data,
+		size_t len)
+{
+	if (rec->len + len > rec->size) {
+		rec->size = MAX(rec->size * 2, rec->len + len + 4096);
+		rec->buf = mem_realloc(rec->buf, rec->size);
+	}
+	memcpy(rec->buf + rec->len, data, len);
+	rec->len += len;
+}
+
+static void parser_record_u32(struct parser_record *rec, uint32_t v)
+{
+	parser_record_bytes(rec, &v, sizeof(v));
+}
+
+/**
+ * Append the directive just run by hook h to the recording
+ */
+static void parser_record_line(struct parser *p, struct parser_hook *h)
+{
+	struct parser_record *rec = p->rec;
+	uint16_t head[2];
+	int i;
+
+	/* The hook list runs from the latest hook back to the first */
+	head[0] = p->nhooks - 1 - h->index;
+	head[1] = p->nvals;
+	parser_record_bytes(rec, head, sizeof(head));
+	parser_record_u32(rec, p->lineno - rec->first_line);
+
+	for (i = 0; i < p->nvals; i++) {
+		struct parser_value *v = &p->vals[i];
+		int t = v->type & ~PARSE_T_OPT;
+
+		if (t == PARSE_T_INT) {
+			parser_record_u32(rec, (uint32_t)v->u.ival);
+		} else if (t == PARSE_T_UINT) {
+			parser_record_u32(rec, v->u.uval);
+		} else if (t == PARSE_T_CHAR) {
+			parser_record_u32(rec, (uint32_t)v->u.cval);
+		} else if (t == PARSE_T_RAND) {
+			parser_record_u32(rec, (uint32_t)v->u.rval.base);
+			parser_record_u32(rec, (uint32_t)v->u.rval.dice);
+			parser_record_u32(rec, (uint32_t)v->u.rval.sides);
+			parser_record_u32(rec, (uint32_t)v->u.rval.m_bonus);
+		} else {
+			uint32_t len = strlen(v->u.sval);
+			parser_record_u32(rec, len);
+			parser_record_bytes(rec, v->u.sval, len + 1);
+		}
+	}
+}
+
 /**
  * Parses the provided line.
  *
  * This runs the first parser hook registered with `p` that matches `line`.
  */
 enum parser_error parser_parse(struct parser *p, const char *line) {
-	char *cline;
-	char *tok;
+	char *sp, *tok;
 	struct parser_hook *h;
-	struct parser_spec *s;
-	struct parser_value *v;
-	char *sp = NULL;
+	size_t len;
+	int i;
 
 	assert(p);
 	assert(line);
@@ -222,8 +362,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -231,11 +369,17 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Work on a copy of the line, which the string values point into */
+	len = strlen(line) + 1;
+	if (len > p->scratch_size) {
+		p->scratch_size = MAX(len, 1024);
+		p->scratch = mem_realloc(p->scratch, p->scratch_size);
+	}
+	memcpy(p->scratch, line, len);
+	sp = p->scratch;
 
-	tok = strtok(cline, ":");
+	tok = nextfield(&sp);
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -244,7 +388,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -252,7 +395,9 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	 * types. The optional flag has a bit assigned to it in the spec's type
 	 * tag; we compute a temporary type for the spec with that flag removed
 	 * and use that instead. */
-	for (s = h->fhead; s; s = s->next) {
+	for (i = 0; i < h->nspecs; i++) {
+		struct parser_spec *s = &h->specs[i];
+		struct parser_value *v = &p->vals[i];
 		int t = s->type & ~PARSE_T_OPT;
 		p->colno++;
 
@@ -260,78 +405,65 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		 * at all (i.e., they consume the remainder of the line) */
 		if (t == PARSE_T_INT || t == PARSE_T_SYM || t == PARSE_T_RAND ||
 			t == PARSE_T_UINT) {
-			tok = strtok(sp, ":");
-			sp = NULL;
+			tok = nextfield(&sp);
 		} else if (t == PARSE_T_CHAR) {
-			tok = strtok(sp, "");
+			tok = nextrest(&sp);
 			if (tok)
-				sp = tok + 2;
+				sp = tok[1] ? tok + 2 : tok + 1;
 		} else {
-			tok = strtok(sp, "");
-			sp = NULL;
+			tok = nextrest(&sp);
 		}
 		if (!tok) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
+				p->nvals = 0;
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		v->type = s->type;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
+				p->nvals = 0;
 				return PARSE_ERROR_NOT_NUMBER;
 			}
 		} else if (t == PARSE_T_UINT) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
+				p->nvals = 0;
 				return PARSE_ERROR_NOT_NUMBER;
 			}
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
+				p->nvals = 0;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->nvals = i + 1;
 	}
 
-	mem_free(cline);
-
+	p->cur = h;
 	p->error = h->func(p);
+	if (p->rec && p->error == PARSE_ERROR_NONE)
+		parser_record_line(p, h);
 	return p->error;
 }
 
@@ -373,14 +505,14 @@ static int parse_type(const char *s) {
 }
 
 static void clean_specs(struct parser_hook *h) {
-	struct parser_spec *s;
+	int i;
 	mem_free(h->dir);
-	while (h->fhead) {
-		s = h->fhead;
-		h->fhead = h->fhead->next;
-		mem_free((void*)s->name);
-		mem_free(s);
-	}
+	for (i = 0; i < h->nspecs; i++)
+		mem_free((void*)h->specs[i].name);
+	mem_free(h->specs);
+	h->specs = NULL;
+	h->nspecs = 0;
+	hash_index_free(&h->slots);
 }
 
 /**
@@ -389,12 +521,17 @@ static void clean_specs(struct parser_hook *h) {
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
 	parser_freeold(p);
+	parser_record_stop(p);
 	while (p->hooks) {
 		h = p->hooks->next;
 		clean_specs(p->hooks);
 		mem_free(p->hooks);
 		p->hooks = h;
 	}
+	mem_free(p->hookv);
+	hash_index_free(&p->index);
+	mem_free(p->vals);
+	mem_free(p->scratch);
 	mem_free(p);
 }
 
@@ -411,9 +548,12 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
-	h->fhead = NULL;
-	h->ftail = NULL;
+	h->hash = djb2_hash(h->dir);
+	h->specs = NULL;
+	h->nspecs = 0;
 	while (name) {
+		struct parser_spec *last = h->nspecs ? &h->specs[h->nspecs - 1] : NULL;
+
 		/* Lack of a type is legal; that means we're at the end of the line. */
 		stype = strtok(NULL, " ");
 		if (!stype)
@@ -433,26 +573,23 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 			clean_specs(h);
 			return -EINVAL;
 		}
-		if (!(type & PARSE_T_OPT) && h->ftail &&
-			(h->ftail->type & PARSE_T_OPT)) {
+		if (!(type & PARSE_T_OPT) && last &&
+			(last->type & PARSE_T_OPT)) {
 			clean_specs(h);
 			return -EINVAL;
 		}
-		if (h->ftail && ((h->ftail->type & ~PARSE_T_OPT) == PARSE_T_STR)) {
+		if (last && ((last->type & ~PARSE_T_OPT) == PARSE_T_STR)) {
 			clean_specs(h);
 			return -EINVAL;
 		}
 
-		/* Save this spec. */
-		s = mem_alloc(sizeof *s);
+		/* Save this spec in the next slot. */
+		h->specs = mem_realloc(h->specs, (h->nspecs + 1) * sizeof(*s));
+		s = &h->specs[h->nspecs++];
 		s->type = type;
 		s->name = string_make(name);
-		s->next = NULL;
-		if (h->fhead)
-			h->ftail->next = s;
-		else
-			h->fhead = s;
-		h->ftail = s;
+		s->hash = djb2_hash(s->name);
+		hash_index_add(&h->slots, s->hash, h->nspecs - 1);
 	}
 
 	return 0;
@@ -480,7 +617,7 @@ errr parser_reg(struct parser *p, const char *fmt,
 	assert(fmt);
 	assert(func);
 
-	h = mem_alloc(sizeof *h);
+	h = mem_zalloc(sizeof *h);
 	cfmt = string_make(fmt);
 	h->next = p->hooks;
 	h->func = func;
@@ -493,6 +630,11 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	addhook(p, h);
+	if (h->nspecs > p->max_vals) {
+		p->max_vals = h->nspecs;
+		p->vals = mem_realloc(p->vals, p->max_vals * sizeof(*p->vals));
+	}
 	mem_free(cfmt);
 	return 0;
 }
@@ -504,29 +646,38 @@ enum parser_error ignored(struct parser *p) {
 	return PARSE_ERROR_NONE;
 }
 
+/**
+ * Find the slot holding the value named `name` on the current line, or -1
+ */
+static int parser_slot(struct parser *p, const char *name) {
+	uint32_t hash = djb2_hash(name);
+	size_t probe = 0;
+	int i;
+
+	if (!p->cur)
+		return -1;
+
+	while ((i = hash_index_next(&p->cur->slots, hash, &probe)) >= 0) {
+		if (streq(p->cur->specs[i].name, name))
+			return i < p->nvals ? i : -1;
+	}
+	return -1;
+}
+
 /**
  * Returns whether the parser has a value named `name`.
  *
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (streq(v->spec.name, name))
-			return true;
-	}
-	return false;
+	return parser_slot(p, name) >= 0;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (streq(v->spec.name, name)) {
-			return v;
-		}
-	}
-	quit_fmt("parser_getval error: name is %s\n", name);
-	return 0; /* Needed to avoid Windows compiler warning */
+	int i = parser_slot(p, name);
+	if (i < 0)
+		quit_fmt("parser_getval error: name is %s\n", name);
+	return &p->vals[i];
 }
 
 /**
@@ -534,7 +685,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -543,7 +694,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -552,7 +703,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -561,7 +712,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -570,7 +721,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -579,7 +730,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
@@ -603,3 +754,147 @@ void parser_setstate(struct parser *p, unsigned int col, const char *msg) {
 	my_strcpy(p->errmsg, msg, sizeof(p->errmsg));
 }
 
+/**
+ * Start recording the directives run by the parser, throwing away anything
+ * recorded before.
+ */
+void parser_record_start(struct parser *p) {
+	parser_record_stop(p);
+	p->rec = mem_zalloc(sizeof(*p->rec));
+	p->rec->first_line = p->lineno;
+}
+
+/**
+ * Get the directives recorded so far, and the number of lines they span.
+ */
+const char *parser_recorded(struct parser *p, size_t *len,
+		unsigned int *lines) {
+	if (!p->rec) {
+		*len = 0;
+		*lines = 0;
+		return NULL;
+	}
+	*len = p->rec->len;
+	*lines = p->lineno - p->rec->first_line;
+	return p->rec->buf;
+}
+
+/**
+ * Stop recording and throw the recording away.
+ */
+void parser_record_stop(struct parser *p) {
+	if (!p->rec) return;
+	mem_free(p->rec->buf);
+	mem_free(p->rec);
+	p->rec = NULL;
+}
+
+/**
+ * A hash of the parser's hooks and their specs.  A recording can only be
+ * replayed by a parser with the same signature as the one that made it.
+ */
+uint32_t parser_signature(struct parser *p) {
+	struct parser_hook *h;
+	uint32_t sig = 5381;
+	int i;
+
+	for (h = p->hooks; h; h = h->next) {
+		sig = sig * 33 + h->hash;
+		for (i = 0; i < h->nspecs; i++) {
+			sig = sig * 33 + (uint32_t)h->specs[i].type;
+			sig = sig * 33 + h->specs[i].hash;
+		}
+		sig = sig * 33 + '\n';
+	}
+
+	return sig;
+}
+
+static bool parser_replay_u32(const char **pos, const char *end, uint32_t *v)
+{
+	if (end - *pos < (ptrdiff_t)sizeof(*v)) return false;
+	memcpy(v, *pos, sizeof(*v));
+	*pos += sizeof(*v);
+	return true;
+}
+
+/**
+ * Run the directives from a recording, spanning the given number of lines,
+ * through the parser's hooks just as parser_parse() would have.  The strings
+ * handed to the hooks point into the recording, which must stay put until
+ * this returns.
+ */
+enum parser_error parser_replay(struct parser *p, const char *data, size_t len,
+		unsigned int lines) {
+	const char *pos = data, *end = data + len;
+	unsigned int first_line = p->lineno;
+	struct parser_hook *h;
+
+	parser_freeold(p);
+
+	p->error = PARSE_ERROR_NONE;
+	while (pos < end) {
+		uint16_t head[2];
+		uint32_t line;
+		int i;
+
+		if (end - pos < (ptrdiff_t)sizeof(head)) break;
+		memcpy(head, pos, sizeof(head));
+		pos += sizeof(head);
+		if (!parser_replay_u32(&pos, end, &line) || head[0] >= p->nhooks) {
+			break;
+		}
+		h = p->hookv[p->nhooks - 1 - head[0]];
+		if (head[1] > h->nspecs) break;
+		p->lineno = first_line + line;
+		p->colno = 1;
+
+		/* Rebuild the values in their slots */
+		for (i = 0; i < head[1]; i++) {
+			struct parser_value *v = &p->vals[i];
+			int t = h->specs[i].type & ~PARSE_T_OPT;
+			uint32_t u[4];
+
+			v->type = h->specs[i].type;
+			if (!parser_replay_u32(&pos, end, &u[0])) break;
+			if (t == PARSE_T_INT) {
+				v->u.ival = (int32_t)u[0];
+			} else if (t == PARSE_T_UINT) {
+				v->u.uval = u[0];
+			} else if (t == PARSE_T_CHAR) {
+				v->u.cval = (wchar_t)u[0];
+			} else if (t == PARSE_T_RAND) {
+				if (!parser_replay_u32(&pos, end, &u[1])
+						|| !parser_replay_u32(&pos, end, &u[2])
+						|| !parser_replay_u32(&pos, end, &u[3])) {
+					break;
+				}
+				v->u.rval.base = (int32_t)u[0];
+				v->u.rval.dice = (int32_t)u[1];
+				v->u.rval.sides = (int32_t)u[2];
+				v->u.rval.m_bonus = (int32_t)u[3];
+			} else {
+				if ((size_t)(end - pos) <= u[0] || pos[u[0]]) break;
+				v->u.sval = (char *)pos;
+				pos += u[0] + 1;
+			}
+		}
+		if (i < head[1]) break;
+
+		/* Run the hook on the borrowed values, then let go of them */
+		p->nvals = head[1];
+		p->cur = h;
+		p->error = h->func(p);
+		parser_freeold(p);
+		if (p->error) break;
+	}
+
+	if (p->error) return p->error;
+	if (pos < end) {
+		my_strcpy(p->errmsg, "snapshot", sizeof(p->errmsg));
+		p->error = PARSE_ERROR_GENERIC;
+		return p->error;
+	}
+	p->lineno = first_line + lines;
+	return PARSE_ERROR_NONE;
+}
@@ -64,5 +64,12 @@ extern struct random parser_getrand(struct parser *p, const char *name);
 extern wchar_t parser_getchar(struct parser *p, const char *name);
 extern int parser_getstate(struct parser *p, struct parser_state *s);
 extern void parser_setstate(struct parser *p, unsigned int col, const char *msg);
+extern void parser_record_start(struct parser *p);
+extern const char *parser_recorded(struct parser *p, size_t *len,
+		unsigned int *lines);
+extern void parser_record_stop(struct parser *p);
+extern uint32_t parser_signature(struct parser *p);
+extern enum parser_error parser_replay(struct parser *p, const char *data,
+		size_t len, unsigned int lines);
 
 #endif /* !PARSER_H */
@@ -23,6 +23,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-lore.h"
+#include "mon-move.h"
 #include "mon-util.h"
 #include "monster.h"
 #include "obj-curse.h"
@@ -335,6 +336,7 @@ static void get_bonuses(void)
 
 	/* L: check monster */
 	player->curr_monster_ridx = 0;
+	update_player_faction(player);
 	check_player_monster(player, true);
 
 	/* Calculate the bonuses and hitpoints */
@@ -461,7 +463,7 @@ void player_init(struct player *p)
 	p->upkeep->quiver = mem_zalloc(z_info->quiver_size *
 								   sizeof(struct object *));
 	p->timed = mem_zalloc(TMD_MAX * sizeof(int16_t));
-	p->obj_k = mem_zalloc(sizeof(struct object));
+	p->obj_k = object_new();
 	p->obj_k->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
 	p->obj_k->slays = mem_zalloc(z_info->slay_max * sizeof(bool));
 	p->obj_k->curses = mem_zalloc(z_info->curse_max *
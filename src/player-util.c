@@ -24,6 +24,7 @@
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
+#include "mon-move.h"
 #include "mon-util.h"
 #include "obj-chest.h"
 #include "obj-gear.h"
@@ -64,6 +65,7 @@ static void change_player_monster(struct player *p, struct monster_race *mon, bo
 		msg("You transform into a %s.", mon->name);
 
 	p->curr_monster_ridx = mon->ridx;
+	update_player_faction(p);
 	player->upkeep->redraw |= (PR_MAP | PR_MISC);
 	player->upkeep->update |= (PU_BONUS | PU_HP);
 }
@@ -49,9 +49,13 @@ int adjust_dam(struct player *p, int type, int dam, aspect dam_aspect,
 {
 	int i, denom = 0, sav;
 
-	/* L: saving throw reduces damage */
+	/* L: saving throw reduces damage, or adds to it if it is negative */
 	sav = p->state.skills[SKILL_SAVE];
-	dam = dam * (100 - sav / 3 - randint0(sav / 3)) / 100;
+	if (sav >= 0) {
+		dam = dam * (100 - sav / 3 - randint0(sav / 3)) / 100;
+	} else {
+		dam = dam * (100 - sav / 3 + randint0(-sav / 3)) / 100;
+	}
 	dam = MAX(dam, 0);
 
 	/* If an actual player exists, get their actual resist */
@@ -393,6 +393,307 @@ bool projectable(struct chunk *c, struct loc grid1, struct loc grid2, int flg)
 
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Blast stencils and scratch space
+ * ------------------------------------------------------------------------ */
+
+/**
+ * L: Offsets from an explosion's centre, nearest first.  Since the order does
+ * not depend on how far out the stencil goes, the stencil for any radius is
+ * a prefix of the largest one built, and stencil_count[r] is its length.
+ */
+static struct loc *stencil;
+static int *stencil_dist;
+static int *stencil_count;
+static int stencil_radius = -1;
+
+/**
+ * L: Grids collected by one call to project().  These are kept on a free list
+ * and reused, since project() can be reentered through the effects it has
+ * on monsters and the player.
+ */
+struct blast {
+	struct loc *grid;		/* Affected grids, nearest the centre first */
+	int *dist;				/* Distance of each grid from the centre */
+	bool *seen;				/* Whether the player sees each grid */
+	int num;
+	int alloc;
+
+	int *dam_at_dist;		/* Damage at each distance from the centre */
+	int dam_alloc;
+
+	struct loc *path;		/* The projection path */
+	int path_alloc;
+
+	struct blast *next;
+};
+
+static struct blast *blast_free_list;
+
+static int cmp_stencil(const void *a, const void *b)
+{
+	const struct loc *la = a;
+	const struct loc *lb = b;
+	int da = distance(loc(0, 0), *la);
+	int db = distance(loc(0, 0), *lb);
+
+	if (da != db) return da - db;
+	if (la->y != lb->y) return la->y - lb->y;
+	return la->x - lb->x;
+}
+
+/**
+ * Make sure the stencil reaches out to at least the given radius
+ */
+static void stencil_reach(int rad)
+{
+	int n = 0, r, i;
+	struct loc grid;
+
+	if (rad <= stencil_radius) return;
+
+	mem_free(stencil);
+	mem_free(stencil_dist);
+	mem_free(stencil_count);
+	stencil = mem_zalloc((2 * rad + 1) * (2 * rad + 1) * sizeof(*stencil));
+	stencil_dist = mem_zalloc((2 * rad + 1) * (2 * rad + 1) *
+		sizeof(*stencil_dist));
+	stencil_count = mem_zalloc((rad + 1) * sizeof(*stencil_count));
+
+	/* Every grid within the radius except the centre */
+	for (grid.y = -rad; grid.y <= rad; grid.y++) {
+		for (grid.x = -rad; grid.x <= rad; grid.x++) {
+			if (loc_is_zero(grid)) continue;
+			if (distance(loc(0, 0), grid) > rad) continue;
+			stencil[n++] = grid;
+		}
+	}
+	sort(stencil, n, sizeof(*stencil), cmp_stencil);
+
+	for (i = 0, r = 0; i < n; i++) {
+		stencil_dist[i] = distance(loc(0, 0), stencil[i]);
+		while (r < stencil_dist[i]) stencil_count[r++] = i;
+	}
+	while (r <= rad) stencil_count[r++] = n;
+	stencil_radius = rad;
+}
+
+static struct blast *blast_get(void)
+{
+	struct blast *b = blast_free_list;
+
+	if (b) {
+		blast_free_list = b->next;
+	} else {
+		b = mem_zalloc(sizeof(*b));
+	}
+	b->num = 0;
+	b->next = NULL;
+
+	/* Room for the longest path project_path() will make */
+	if (b->path_alloc < z_info->max_range + 1) {
+		b->path_alloc = z_info->max_range + 1;
+		b->path = mem_realloc(b->path, b->path_alloc * sizeof(*b->path));
+	}
+	return b;
+}
+
+static void blast_put(struct blast *b)
+{
+	b->next = blast_free_list;
+	blast_free_list = b;
+}
+
+/**
+ * Add a grid to a blast and mark it for processing
+ */
+static void blast_add(struct blast *b, struct loc grid, int dist)
+{
+	if (b->num == b->alloc) {
+		b->alloc = b->alloc ? b->alloc * 2 : 256;
+		b->grid = mem_realloc(b->grid, b->alloc * sizeof(*b->grid));
+		b->dist = mem_realloc(b->dist, b->alloc * sizeof(*b->dist));
+		b->seen = mem_realloc(b->seen, b->alloc * sizeof(*b->seen));
+	}
+	b->grid[b->num] = grid;
+	b->dist[b->num] = dist;
+	b->num++;
+	sqinfo_on(square(cave, grid)->info, SQUARE_PROJECT);
+}
+
+static bool loc_in_path(struct loc grid, const struct loc *path, int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (loc_eq(grid, path[i])) return true;
+	}
+	return false;
+}
+
+static void init_project(void)
+{
+	stencil_reach(z_info->max_range);
+}
+
+static void cleanup_project(void)
+{
+	while (blast_free_list) {
+		struct blast *b = blast_free_list;
+
+		blast_free_list = b->next;
+		mem_free(b->grid);
+		mem_free(b->dist);
+		mem_free(b->seen);
+		mem_free(b->dam_at_dist);
+		mem_free(b->path);
+		mem_free(b);
+	}
+	mem_free(stencil);
+	mem_free(stencil_dist);
+	mem_free(stencil_count);
+	stencil = NULL;
+	stencil_dist = NULL;
+	stencil_count = NULL;
+	stencil_radius = -1;
+}
+
+struct init_module project_module = {
+	.name = "project",
+	.init = init_project,
+	.cleanup = cleanup_project
+};
+
+/**
+ * ------------------------------------------------------------------------
+ * Applying a blast
+ * ------------------------------------------------------------------------ */
+
+/**
+ * L: Affect objects on every grid of a blast
+ */
+static bool blast_objects(struct source origin, const struct blast *b,
+		int typ, const struct object *obj)
+{
+	bool notice = false;
+	int i;
+
+	for (i = 0; i < b->num; i++) {
+		if (project_o(origin, b->dist[i], b->grid[i],
+				b->dam_at_dist[b->dist[i]], typ, obj)) {
+			notice = true;
+		}
+	}
+	return notice;
+}
+
+/**
+ * Affect monsters on every grid of a blast, each monster at most once
+ */
+static bool blast_monsters(struct source origin, const struct blast *b,
+		int typ, int flg)
+{
+	bool notice = false;
+	bool was_obvious = false;
+	bool did_hit = false;
+	int num_hit = 0;
+	struct loc last_hit_grid = loc(0, 0);
+	int i;
+
+	/* Scan for monsters */
+	for (i = 0; i < b->num; i++) {
+		struct monster *mon = NULL;
+
+		/* Check this monster hasn't been processed already */
+		if (!square_isproject(cave, b->grid[i]))
+			continue;
+
+		/* Check there is actually a monster here */
+		mon = square_monster(cave, b->grid[i]);
+		if (mon == NULL)
+			continue;
+
+		/* Affect the monster in the grid */
+		project_m(origin, b->dist[i], b->grid[i],
+		          b->dam_at_dist[b->dist[i]], typ, flg,
+		          &did_hit, &was_obvious);
+		if (was_obvious) {
+			notice = true;
+		}
+		if (did_hit) {
+			num_hit++;
+
+			/* Monster location may have been updated by project_m() */
+			last_hit_grid = mon->grid;
+		}
+	}
+
+	/* Player affected one monster (without "jumping") */
+	if (origin.what == SRC_PLAYER &&
+			num_hit == 1 &&
+			!(flg & PROJECT_JUMP)) {
+		/* Track if possible */
+		if (square(cave, last_hit_grid)->mon > 0) {
+			struct monster *mon = square_monster(cave, last_hit_grid);
+
+			/* Recall and track */
+			if (monster_is_visible(mon)) {
+				monster_race_track(player->upkeep, mon->race);
+				health_track(player->upkeep, mon);
+			}
+		}
+	}
+
+	return notice;
+}
+
+/**
+ * Look for the player in a blast, and affect them when found
+ */
+static bool blast_player(struct source origin, const struct blast *b,
+		int typ, int flg)
+{
+	/* Set power */
+	int power = 0;
+	int i;
+
+	if (origin.what == SRC_MONSTER) {
+		struct monster *mon = cave_monster(cave, origin.which.monster);
+		power = mon->race->spell_power;
+
+		/* Breaths from powerful monsters get power effects as well */
+		if (monster_is_powerful(mon))
+			power = MAX(power, 80);
+	}
+	for (i = 0; i < b->num; i++) {
+		if (project_p(origin, b->dist[i], b->grid[i],
+				b->dam_at_dist[b->dist[i]], typ, power,
+				flg & PROJECT_SELF)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Affect features on every grid of a blast
+ */
+static bool blast_features(struct source origin, const struct blast *b,
+		int typ)
+{
+	bool notice = false;
+	int i;
+
+	for (i = 0; i < b->num; i++) {
+		if (project_f(origin, b->dist[i], b->grid[i],
+				b->dam_at_dist[b->dist[i]], typ)) {
+			notice = true;
+		}
+	}
+	return notice;
+}
+
 /**
  * ------------------------------------------------------------------------
  * The main project() function and its helpers
@@ -542,8 +843,9 @@ struct loc origin_get_loc(struct source origin)
  *   to a grid in LOS) within their radius.  Arcs do the same, but only within 
  *   their cone of projection.
  * Because affected grids are only scanned once, and it is really helpful to 
- *   have explosions that travel outwards from the source, they are sorted by 
- *   distance.  For each distance, an adjusted damage is calculated.
+ *   have explosions that travel outwards from the source, they are scanned 
+ *   in order of distance.  For each distance, an adjusted damage is 
+ *   calculated.
  * In successive passes, the code then displays explosion graphics, erases 
  *   these graphics, marks terrain for possible later changes, affects 
  *   objects, monsters, the character, and finally changes features and 
@@ -552,10 +854,10 @@ struct loc origin_get_loc(struct source origin)
  *
  * Usage and graphics notes:
  *
- * Only 256 grids can be affected per projection, limiting the effective 
- * radius of standard ball attacks to nine units (diameter nineteen).  Arcs 
- * can have larger radii; an arc capable of going out to range 20 should not 
- * be wider than 70 degrees.
+ * L: There is no limit on the number of grids a projection can affect.  The
+ * grids within the radius are visited through a stencil of offsets sorted
+ * by distance, and collected into scratch space that is kept between calls.
+ * Arcs cannot have a radius of more than 20.
  *
  * Balls must explode BEFORE hitting walls, or they would affect monsters on 
  * both sides of a wall. 
@@ -579,7 +881,7 @@ bool project(struct source origin, int rad, struct loc finish,
 			 int degrees_of_arc, uint8_t diameter_of_source,
 			 const struct object *obj)
 {
-	int i, j, k, dist_from_centre;
+	int i;
 
 	uint32_t dam_temp;
 
@@ -601,23 +903,8 @@ bool project(struct source origin, int rad, struct loc finish,
 	/* Number of grids in the "path" */
 	int num_path_grids = 0;
 
-	/* Actual grids in the "path" */
-	struct loc path_grid[512];
-
-	/* Number of grids in the "blast area" (including the "beam" path) */
-	int num_grids = 0;
-
-	/* Coordinates of the affected grids */
-	struct loc blast_grid[256];
-
-	/* Distance to each of the affected grids. */
-	int distance_to_grid[256];
-
-	/* Player visibility of each of the affected grids. */
-	bool player_sees_grid[256];
-
-	/* Precalculated damage values for each distance. */
-	int *dam_at_dist = malloc((z_info->max_range + 1) * sizeof(*dam_at_dist));
+	/* L: the affected grids, their distances and damages, and the path */
+	struct blast *blast = blast_get();
 
 	/* Flush any pending output */
 	handle_stuff(player);
@@ -659,18 +946,15 @@ bool project(struct source origin, int rad, struct loc finish,
 	 * projection path.
 	 */
 	if (loc_eq(start, finish)) {
-		blast_grid[num_grids] =  finish;
+		blast_add(blast, finish, 0);
 		centre = finish;
-		distance_to_grid[num_grids] = 0;
-		sqinfo_on(square(cave, finish)->info, SQUARE_PROJECT);
-		num_grids++;
 	} else {
 		/* Start from caster */
 		int y = start.y;
 		int x = start.x;
 
 		/* Calculate the projection path */
-		num_path_grids = project_path(cave, path_grid,
+		num_path_grids = project_path(cave, blast->path,
 			z_info->max_range, start, finish, flg);
 
 		/* Some beams have limited length. */
@@ -688,11 +972,11 @@ bool project(struct source origin, int rad, struct loc finish,
 				int oy = y;
 				int ox = x;
 
-				int ny = path_grid[i].y;
-				int nx = path_grid[i].x;
+				int ny = blast->path[i].y;
+				int nx = blast->path[i].x;
 
 				/* Hack -- Balls explode before reaching walls. */
-				if (!square_ispassable(cave, path_grid[i]) && (rad > 0) &&
+				if (!square_ispassable(cave, blast->path[i]) && (rad > 0) &&
 					!(flg & (PROJECT_BEAM)))
 					break;
 
@@ -702,18 +986,8 @@ bool project(struct source origin, int rad, struct loc finish,
 
 				/* Beams collect all grids in the path, all other methods
 				 * collect only the final grid in the path. */
-				if (flg & (PROJECT_BEAM)) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y))->info, SQUARE_PROJECT);
-					num_grids++;
-				} else if (i == num_path_grids - 1) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y))->info, SQUARE_PROJECT);
-					num_grids++;
+				if ((flg & (PROJECT_BEAM)) || (i == num_path_grids - 1)) {
+					blast_add(blast, loc(x, y), 0);
 				}
 
 				/* Only do visuals if requested and within range limit. */
@@ -737,8 +1011,6 @@ bool project(struct source origin, int rad, struct loc finish,
 	 * will affect; all non-beam projections with positive radius explode in
 	 * some way */
 	if ((rad > 0) && (!(flg & (PROJECT_BEAM)))) {
-		int y, x;
-
 		/* Pre-calculate some things for arcs. */
 		if ((flg & (PROJECT_ARC)) && (num_path_grids != 0)) {
 			/* Explosion centers on the caster. */
@@ -755,114 +1027,92 @@ bool project(struct source origin, int rad, struct loc finish,
 				i = 20;
 
 			/* Reorient the grid forming the end of the arc's centerline. */
-			n1y = path_grid[i].y - centre.y + 20;
-			n1x = path_grid[i].x - centre.x + 20;
+			n1y = blast->path[i].y - centre.y + 20;
+			n1x = blast->path[i].x - centre.x + 20;
 		}
 
 		/* If the explosion centre hasn't been saved already, save it now. */
-		if (num_grids == 0) {
-			blast_grid[num_grids] = centre;
-			distance_to_grid[num_grids] = 0;
-			sqinfo_on(square(cave, centre)->info, SQUARE_PROJECT);
-			num_grids++;
+		if (blast->num == 0) {
+			blast_add(blast, centre, 0);
 		}
 
-		/* Scan every grid that might possibly be in the blast radius. */
-		for (y = centre.y - rad; y <= centre.y + rad; y++) {
-			for (x = centre.x - rad; x <= centre.x + rad; x++) {
-				struct loc grid = loc(x, y);
-				bool on_path = false;
-
-				/* Center grid has already been stored. */
-				if (loc_eq(grid, centre))
-					continue;
-
-				/* Precaution: Stay within area limit. */
-				if (num_grids >= 255)
-					break;
+		/* L: scan the grids within the radius, nearest first, so the blast
+		 * comes out already sorted by distance */
+		stencil_reach(rad);
+		for (i = 0; i < stencil_count[rad]; i++) {
+			struct loc grid = loc_sum(centre, stencil[i]);
 
-				/* Ignore "illegal" locations */
-				if (!square_in_bounds(cave, grid))
-					continue;
+			/* Ignore "illegal" locations */
+			if (!square_in_bounds(cave, grid))
+				continue;
 
-				/* Most explosions are immediately stopped by walls. If
-				 * PROJECT_THRU is set, walls can be affected if adjacent to
-				 * a grid visible from the explosion centre - note that as of
-				 * Angband 3.5.0 there are no such explosions - NRM.
-				 * All explosions can affect one layer of terrain which is
-				 * passable but not projectable */
-				if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
-					/* If this is a wall grid, ... */
-					if (!square_isprojectable(cave, grid)) {
-						bool can_see_one = false;
-						/* Check neighbors */
-						for (i = 0; i < 8; i++) {
-							struct loc adj_grid = loc_sum(grid, ddgrid_ddd[i]);
-							if (los(cave, centre, adj_grid)) {
-								can_see_one = true;
-								break;
-							}
+			/* Most explosions are immediately stopped by walls. If
+			 * PROJECT_THRU is set, walls can be affected if adjacent to
+			 * a grid visible from the explosion centre - note that as of
+			 * Angband 3.5.0 there are no such explosions - NRM.
+			 * All explosions can affect one layer of terrain which is
+			 * passable but not projectable */
+			if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
+				/* If this is a wall grid, ... */
+				if (!square_isprojectable(cave, grid)) {
+					bool can_see_one = false;
+					int d;
+
+					/* Check neighbors */
+					for (d = 0; d < 8; d++) {
+						struct loc adj_grid = loc_sum(grid, ddgrid_ddd[d]);
+						if (los(cave, centre, adj_grid)) {
+							can_see_one = true;
+							break;
 						}
-
-						/* Require at least one adjacent grid in LOS. */
-						if (!can_see_one)
-							continue;
 					}
-				} else if (!square_isprojectable(cave, grid))
-					continue;
 
-				/* Must be within maximum distance. */
-				dist_from_centre  = (distance(centre, grid));
-				if (dist_from_centre > rad)
-					continue;
-
-				/* Mark grids which are on the projection path */
-				for (i = 0; i < num_path_grids; i++) {
-					if (loc_eq(grid, path_grid[i])) {
-						on_path = true;
-					}
-				}
-
-				/* Do we need to consider a restricted angle? */
-				if (flg & (PROJECT_ARC)) {
-					/* Use angle comparison to delineate an arc. */
-					int n2y, n2x, tmp, rotate, diff;
-
-					/* Reorient current grid for table access. */
-					n2y = y - start.y + 20;
-					n2x = x - start.x + 20;
-
-					/* Find the angular difference (/2) between the lines to
-					 * the end of the arc's center-line and to the current grid.
-					 */
-					rotate = 90 - get_angle_to_grid[n1y][n1x];
-					tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
-					diff = ABS(90 - tmp);
-
-					/* If difference is greater then that allowed, skip it,
-					 * unless it's on the target path */
-					if ((diff >= (degrees_of_arc + 6) / 4) && !on_path)
+					/* Require at least one adjacent grid in LOS. */
+					if (!can_see_one)
 						continue;
 				}
+			} else if (!square_isprojectable(cave, grid))
+				continue;
 
-				/* Accept remaining grids if in LOS or on the projection path */
-				if (los(cave, centre, grid) || on_path) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = dist_from_centre;
-					sqinfo_on(square(cave, grid)->info, SQUARE_PROJECT);
-					num_grids++;
-				}
+			/* Do we need to consider a restricted angle? */
+			if (flg & (PROJECT_ARC)) {
+				/* Use angle comparison to delineate an arc. */
+				int n2y, n2x, tmp, rotate, diff;
+
+				/* Reorient current grid for table access. */
+				n2y = grid.y - start.y + 20;
+				n2x = grid.x - start.x + 20;
+
+				/* Find the angular difference (/2) between the lines to
+				 * the end of the arc's center-line and to the current grid.
+				 */
+				rotate = 90 - get_angle_to_grid[n1y][n1x];
+				tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
+				diff = ABS(90 - tmp);
+
+				/* If difference is greater then that allowed, skip it,
+				 * unless it's on the target path */
+				if ((diff >= (degrees_of_arc + 6) / 4) &&
+					!loc_in_path(grid, blast->path, num_path_grids))
+					continue;
+			}
+
+			/* Accept remaining grids if in LOS or on the projection path */
+			if (los(cave, centre, grid) ||
+				loc_in_path(grid, blast->path, num_path_grids)) {
+				blast_add(blast, grid, stencil_dist[i]);
 			}
 		}
 	}
 
 	/* Calculate and store the actual damage at each distance. */
-	for (i = 0; i <= z_info->max_range; i++) {
-		if (i > rad) {
-			/* No damage outside the radius. */
-			dam_temp = 0;
-		} else if ((!diameter_of_source) || (i == 0)) {
+	if (blast->dam_alloc < rad + 1) {
+		blast->dam_alloc = rad + 1;
+		blast->dam_at_dist = mem_realloc(blast->dam_at_dist,
+			blast->dam_alloc * sizeof(*blast->dam_at_dist));
+	}
+	for (i = 0; i <= rad; i++) {
+		if ((!diameter_of_source) || (i == 0)) {
 			/* Standard damage calc. for 10' source diameters, or at origin. */
 			dam_temp = (dam + i) / (i + 1);
 		} else {
@@ -876,158 +1126,54 @@ bool project(struct source origin, int rad, struct loc finish,
 		}
 
 		/* Store it. */
-		dam_at_dist[i] = dam_temp;
-	}
-
-
-	/* Sort the blast grids by distance from the centre. */
-	for (i = 0, k = 0; i <= rad; i++) {
-		/* Collect all the grids of a given distance together. */
-		for (j = k; j < num_grids; j++) {
-			if (distance_to_grid[j] == i) {
-				struct loc tmp;
-				int tmp_d = distance_to_grid[k];
-				tmp = blast_grid[k];
-
-				blast_grid[k] = blast_grid[j];
-				distance_to_grid[k] = distance_to_grid[j];
-
-				blast_grid[j] = tmp;
-				distance_to_grid[j] = tmp_d;
-
-				/* Write to next slot */
-				k++;
-			}
-		}
+		blast->dam_at_dist[i] = dam_temp;
 	}
 
 	/* Establish which grids are visible - no blast visuals with PROJECT_HIDE */
-	for (i = 0; i < num_grids; i++) {
-		if (panel_contains(blast_grid[i].y, blast_grid[i].x) &&
-			square_isview(cave, blast_grid[i]) &&
+	for (i = 0; i < blast->num; i++) {
+		if (panel_contains(blast->grid[i].y, blast->grid[i].x) &&
+			square_isview(cave, blast->grid[i]) &&
 			!blind && !(flg & (PROJECT_HIDE))) {
-			player_sees_grid[i] = true;
+			blast->seen[i] = true;
 		} else {
-			player_sees_grid[i] = false;
+			blast->seen[i] = false;
 		}
 	}
 
 	/* Tell the UI to display the blast */
-	event_signal_blast(EVENT_EXPLOSION, typ, num_grids, distance_to_grid,
-					   drawing, player_sees_grid, blast_grid, centre);
+	event_signal_blast(EVENT_EXPLOSION, typ, blast->num, blast->dist,
+					   drawing, blast->seen, blast->grid, centre);
 
 	/* Affect objects on every relevant grid */
-	if (flg & (PROJECT_ITEM)) {
-		for (i = 0; i < num_grids; i++) {
-			if (project_o(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, obj)) {
-				notice = true;
-			}
-		}
+	if ((flg & (PROJECT_ITEM)) && blast_objects(origin, blast, typ, obj)) {
+		notice = true;
 	}
 
 	/* Check monsters */
-	if (flg & (PROJECT_KILL)) {
-		bool was_obvious = false;
-		bool did_hit = false;
-		int num_hit = 0;
-		struct loc last_hit_grid = loc(0, 0);
-
-		/* Scan for monsters */
-		for (i = 0; i < num_grids; i++) {
-			struct monster *mon = NULL;
-
-			/* Check this monster hasn't been processed already */
-			if (!square_isproject(cave, blast_grid[i]))
-				continue;
-
-			/* Check there is actually a monster here */
-			mon = square_monster(cave, blast_grid[i]);
-			if (mon == NULL)
-				continue;
-
-			/* Affect the monster in the grid */
-			project_m(origin, distance_to_grid[i], blast_grid[i],
-			          dam_at_dist[distance_to_grid[i]], typ, flg,
-			          &did_hit, &was_obvious);
-			if (was_obvious) {
-				notice = true;
-			}
-			if (did_hit) {
-				num_hit++;
-
-				/* Monster location may have been updated by project_m() */
-				last_hit_grid = mon->grid;
-			}
-		}
-
-		/* Player affected one monster (without "jumping") */
-		if (origin.what == SRC_PLAYER &&
-				num_hit == 1 &&
-				!(flg & PROJECT_JUMP)) {
-			/* Location */
-			int x = last_hit_grid.x;
-			int y = last_hit_grid.y;
-
-			/* Track if possible */
-			if (square(cave, loc(x, y))->mon > 0) {
-				struct monster *mon = square_monster(cave, loc(x, y));
-
-				/* Recall and track */
-				if (monster_is_visible(mon)) {
-					monster_race_track(player->upkeep, mon->race);
-					health_track(player->upkeep, mon);
-				}
-			}
-		}
+	if ((flg & (PROJECT_KILL)) && blast_monsters(origin, blast, typ, flg)) {
+		notice = true;
 	}
 
 	/* Look for the player, affect them when found */
-	if (flg & (PROJECT_PLAY)) {
-		/* Set power */
-		int power = 0;
-		if (origin.what == SRC_MONSTER) {
-			struct monster *mon = cave_monster(cave, origin.which.monster);
-			power = mon->race->spell_power;
-
-			/* Breaths from powerful monsters get power effects as well */
-			if (monster_is_powerful(mon))
-				power = MAX(power, 80);
-		}
-		for (i = 0; i < num_grids; i++) {
-			if (project_p(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, power,
-						  flg & PROJECT_SELF)) {
-				notice = true;
-				if (player->is_dead) {
-					free(dam_at_dist);
-					return notice;
-				}
-				break;
-			}
-		}
+	if ((flg & (PROJECT_PLAY)) && blast_player(origin, blast, typ, flg)) {
+		notice = true;
 	}
 
-	/* Affect features in every relevant grid */
-	if (flg & (PROJECT_GRID)) {
-		for (i = 0; i < num_grids; i++) {
-			if (project_f(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ)) {
-				notice = true;
-			}
-		}
+	/* Affect features in every relevant grid, unless the player has died */
+	if ((flg & (PROJECT_GRID)) && !player->is_dead &&
+			blast_features(origin, blast, typ)) {
+		notice = true;
 	}
 
 	/* Clear all the processing marks. */
-	for (i = 0; i < num_grids; i++) {
+	for (i = 0; i < blast->num; i++) {
 		/* Clear the mark */
-		sqinfo_off(square(cave, blast_grid[i])->info, SQUARE_PROJECT);
+		sqinfo_off(square(cave, blast->grid[i])->info, SQUARE_PROJECT);
 	}
+	blast_put(blast);
 
 	/* Update stuff if needed */
-	if (player->upkeep->update) update_stuff(player);
-
-	free(dam_at_dist);
+	if (!player->is_dead && player->upkeep->update) update_stuff(player);
 
 	/* Return "something was noticed" */
 	return (notice);
@@ -291,16 +291,16 @@ void wr_randomizer(void)
 	wr_u32b(Rand_value);
 
 	/* state index */
-	wr_u32b(state_i);
+	wr_u32b(rng_default.state_i);
 
 	/* RNG variables */
-	wr_u32b(z0);
-	wr_u32b(z1);
-	wr_u32b(z2);
+	wr_u32b(rng_default.z0);
+	wr_u32b(rng_default.z1);
+	wr_u32b(rng_default.z2);
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		wr_u32b(rng_default.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -771,6 +771,43 @@ void wr_stores(void)
 
 
 
+/**
+ * Run length encode one byte of every grid of a chunk, in row order, as
+ * (count, value) pairs.  L: The byte is picked out by its offset in struct
+ * square, and the runs are gathered locally and written out in batches.
+ */
+static void wr_square_runs(struct chunk *c, size_t offset)
+{
+	uint8_t runs[512];
+	size_t n = 0;
+	int count = 0, total = c->height * c->width, k;
+	uint8_t prev_char = 0;
+	const uint8_t *grid = c->height ?
+		(const uint8_t *) c->squares[0] + offset : NULL;
+
+	for (k = 0; k < total; k++, grid += sizeof(struct square)) {
+		/* If the run is broken, or too full, flush it */
+		if ((*grid != prev_char) || (count == UCHAR_MAX)) {
+			runs[n++] = count;
+			runs[n++] = prev_char;
+			if (n == sizeof(runs)) {
+				wr_bytes(runs, n);
+				n = 0;
+			}
+			prev_char = *grid;
+			count = 1;
+		} else /* Continue the run */
+			count++;
+	}
+
+	/* Flush the data (if any) */
+	if (count) {
+		runs[n++] = count;
+		runs[n++] = prev_char;
+	}
+	wr_bytes(runs, n);
+}
+
 /**
  * Write the current dungeon terrain features and info flags
  *
@@ -778,14 +815,8 @@ void wr_stores(void)
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
-	int y, x;
 	size_t i;
 
-	uint8_t tmp8u;
-
-	uint8_t count;
-	uint8_t prev_char;
-
 	/* Dungeon specific info follows */
 	wr_string(c->name ? c->name : "Blank");
 	wr_u16b(c->height);
@@ -793,59 +824,11 @@ static void wr_dungeon_aux(struct chunk *c)
 
 	/* Run length encoding of c->squares[y][x].info */
 	for (i = 0; i < SQUARE_SIZE; i++) {
-		count = 0;
-		prev_char = 0;
-
-		/* Dump for each grid */
-		for (y = 0; y < c->height; y++) {
-			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = square(c, loc(x, y))->info[i];
-
-				/* If the run is broken, or too full, flush it */
-				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-					wr_byte(count);
-					wr_byte(prev_char);
-					prev_char = tmp8u;
-					count = 1;
-				} else /* Continue the run */
-					count++;
-			}
-		}
-
-		/* Flush the data (if any) */
-		if (count) {
-			wr_byte(count);
-			wr_byte(prev_char);
-		}
+		wr_square_runs(c, offsetof(struct square, info) + i);
 	}
 
 	/* Now the terrain */
-	count = 0;
-	prev_char = 0;
-
-	/* Dump for each grid */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Extract a byte */
-			tmp8u = square(c, loc(x, y))->feat;
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-				wr_byte(count);
-				wr_byte(prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			} else /* Continue the run */
-				count++;
-		}
-	}
-
-	/* Flush the data (if any) */
-	if (count) {
-		wr_byte(count);
-		wr_byte(prev_char);
-	}
+	wr_square_runs(c, offsetof(struct square, feat));
 
 	/* Write feeling */
 	wr_byte(c->feeling);
@@ -1000,8 +983,91 @@ void wr_traps(void)
 	wr_traps_aux(player->cave);
 }
 
+/**
+ * L: Write what rd_chunks_2() needs to know about a chunk before decoding it
+ */
+static void wr_chunk_directory(struct chunk *c)
+{
+	struct connector *join;
+	uint16_t count = 0;
+	int i;
+
+	wr_string(c->name);
+	wr_u16b(c->depth);
+
+	/* Monster races, as counted by place_monster() */
+	if (c->encoded) {
+		wr_u16b(c->stub_race_count);
+		for (i = 0; i < c->stub_race_count; i++) {
+			wr_string(c->stub_races[i]->name);
+		}
+	} else {
+		for (i = 1; i < cave_monster_max(c); i++) {
+			if (cave_monster(c, i)->race) count++;
+		}
+		wr_u16b(count);
+		for (i = 1; i < cave_monster_max(c); i++) {
+			struct monster *mon = cave_monster(c, i);
+
+			if (!mon->race) continue;
+			wr_string(mon->original_race ?
+				mon->original_race->name : mon->race->name);
+		}
+	}
+
+	/* Connectors */
+	for (count = 0, join = c->join; join; join = join->next) count++;
+	wr_u16b(count);
+	for (join = c->join; join; join = join->next) {
+		wr_byte(join->grid.x);
+		wr_byte(join->grid.y);
+		wr_byte(join->feat);
+	}
+}
+
+/**
+ * Write one stored chunk
+ */
+static void wr_chunk_body(struct chunk *c)
+{
+	/* Write the terrain and info */
+	wr_dungeon_aux(c);
+
+	/* Write the objects */
+	wr_objects_aux(c);
+
+	/* Write the monsters */
+	wr_monsters_aux(c);
+
+	/* Write the traps */
+	wr_traps_aux(c);
+
+	/* Write other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		int i;
+
+		wr_string(c->name);
+		wr_s32b(c->turn);
+		wr_u16b(c->depth);
+		wr_byte(c->feeling);
+		wr_u32b(c->obj_rating);
+		wr_u32b(c->mon_rating);
+		wr_byte(c->good_item ? 1 : 0);
+		wr_u16b(c->height);
+		wr_u16b(c->width);
+		wr_u16b(c->feeling_squares);
+		for (i = 0; i < FEAT_MAX + 1; i++) {
+			wr_u16b(c->feat_count[i]);
+		}
+	}
+}
+
 /*
  * Write the chunk list
+ *
+ * L: Stored chunks don't change until they are taken off the list, so each
+ * one keeps the bytes it was last written as, and later saves copy those
+ * forward rather than encoding the chunk again.  chunk_dirty() drops them.
  */
 void wr_chunks(void)
 {
@@ -1015,40 +1081,43 @@ void wr_chunks(void)
 	/* Now write each chunk */
 	for (j = 0; j < chunk_list_max; j++) {
 		struct chunk *c = chunk_list[j];
+		uint32_t len_pos, start;
 
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
-
-		/* Write the objects */
-		wr_objects_aux(c);
-
-		/* Write the monsters */
-		wr_monsters_aux(c);
-
-		/* Write the traps */
-		wr_traps_aux(c);
-
-		/* Write other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			int i;
-
-			wr_string(c->name);
-			wr_s32b(c->turn);
-			wr_u16b(c->depth);
-			wr_byte(c->feeling);
-			wr_u32b(c->obj_rating);
-			wr_u32b(c->mon_rating);
-			wr_byte(c->good_item ? 1 : 0);
-			wr_u16b(c->height);
-			wr_u16b(c->width);
-			wr_u16b(c->feeling_squares);
-			for (i = 0; i < FEAT_MAX + 1; i++) {
-				wr_u16b(c->feat_count[i]);
-			}
+		wr_chunk_directory(c);
+
+		/* The length is filled in once the chunk is written */
+		len_pos = wr_tell();
+		wr_u32b(0);
+		start = wr_tell();
+
+		/* Unchanged since the last save */
+		if (c->save_data) {
+			wr_bytes(c->save_data, c->save_len);
+			wr_u32b_at(len_pos, c->save_len);
+			continue;
 		}
+
+		wr_chunk_body(c);
+
+		/* Keep the encoding for next time */
+		c->save_data = wr_copy_from(start, &c->save_len);
+		wr_u32b_at(len_pos, c->save_len);
 	}
 }
 
+/**
+ * L: Give a stored chunk the encoding wr_chunks() would write for it,
+ * outside of any save
+ * \param c the chunk, which keeps an encoding it already has
+ */
+void chunk_encode(struct chunk *c)
+{
+	if (c->save_data) return;
+	wr_redirect();
+	wr_chunk_body(c);
+	c->save_data = wr_restore(&c->save_len);
+}
+
 
 void wr_history(void)
 {
@@ -23,6 +23,15 @@
 #include "save-charoutput.h"
 #include "z-file.h"
 
+/**
+ * L: Autosaves are written by a worker thread where there are threads, and
+ * when not juggling privileges, which are shared by the whole process
+ */
+#if defined(HAVE_PTHREAD_H) && !defined(SETGID)
+# define SAVE_IN_BACKGROUND
+# include <pthread.h>
+#endif
+
 /**
  * The savefile code.
  *
@@ -54,6 +63,11 @@
  * memory, which is accessed using the wr_* and rd_* functions.  This is
  * then written out, whole, to disk, with the appropriate header.
  *
+ * L: When saving, every block goes into one image of the whole file, which
+ * starts out the size of the last one.  An autosave can then hand the image
+ * to a worker thread to write out and move into place while play carries
+ * on; other saves, panic saves included, write it out straight away.
+ *
  *
  * So, if you want to make a savefile compat-breaking change, then there are
  * a few things you should do:
@@ -123,7 +137,7 @@ static const struct {
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
 	{ "traps", wr_traps, 1 },
-	{ "chunks", wr_chunks, 1 },
+	{ "chunks", wr_chunks, 2 },
 	{ "history", wr_history, 1 },
 };
 
@@ -151,6 +165,7 @@ static const struct blockinfo loaders[] = {
 	{ "monsters", rd_monsters, 1 },
 	{ "traps", rd_traps, 1 },
 	{ "chunks", rd_chunks, 1 },
+	{ "chunks", rd_chunks_2, 2 },
 	{ "history", rd_history, 1 },
 };
 
@@ -161,8 +176,22 @@ static uint32_t buffer_size;
 static uint32_t buffer_pos;
 static uint32_t buffer_check;
 
+/* L: Size of the last savefile image, to size the next one */
+static uint32_t last_image_size;
+
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
+
+#ifdef SAVE_IN_BACKGROUND
+/* L: The autosave being written by a worker thread */
+static struct {
+	pthread_t thread;
+	bool running;
+	char *path;
+	uint8_t *image;
+	uint32_t len;
+	bool result;
+} save_job;
+#endif
 
 #define SAVEFILE_HEAD_SIZE		28
 
@@ -187,17 +216,26 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(uint8_t v)
+/**
+ * Make room in the buffer for another n bytes; L: doubling, so big blocks
+ * like the chunk list are not copied over and over as they grow
+ */
+static void sf_reserve(uint32_t n)
 {
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
+	if (buffer_size - buffer_pos < n) {
+		while (buffer_size - buffer_pos < n) {
+			buffer_size *= 2;
+		}
 		buffer = mem_realloc(buffer, buffer_size);
 	}
+}
 
+static void sf_put(uint8_t v)
+{
+	if (buffer_pos == buffer_size) sf_reserve(1);
 	assert(buffer_pos < buffer_size);
 
 	buffer[buffer_pos++] = v;
@@ -227,8 +265,11 @@ void wr_byte(uint8_t v)
 
 void wr_u16b(uint16_t v)
 {
-	sf_put((uint8_t)(v & 0xFF));
-	sf_put((uint8_t)((v >> 8) & 0xFF));
+	uint8_t bytes[2];
+
+	bytes[0] = (uint8_t)(v & 0xFF);
+	bytes[1] = (uint8_t)((v >> 8) & 0xFF);
+	wr_bytes(bytes, 2);
 }
 
 void wr_s16b(int16_t v)
@@ -238,10 +279,13 @@ void wr_s16b(int16_t v)
 
 void wr_u32b(uint32_t v)
 {
-	sf_put((uint8_t)(v & 0xFF));
-	sf_put((uint8_t)((v >> 8) & 0xFF));
-	sf_put((uint8_t)((v >> 16) & 0xFF));
-	sf_put((uint8_t)((v >> 24) & 0xFF));
+	uint8_t bytes[4];
+
+	bytes[0] = (uint8_t)(v & 0xFF);
+	bytes[1] = (uint8_t)((v >> 8) & 0xFF);
+	bytes[2] = (uint8_t)((v >> 16) & 0xFF);
+	bytes[3] = (uint8_t)((v >> 24) & 0xFF);
+	wr_bytes(bytes, 4);
 }
 
 void wr_s32b(int32_t v)
@@ -251,12 +295,8 @@ void wr_s32b(int32_t v)
 
 void wr_string(const char *str)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
-	}
-	wr_byte(*str);
+	/* Including the terminator */
+	wr_bytes((const uint8_t *) str, strlen(str) + 1);
 }
 
 
@@ -310,11 +350,149 @@ void strip_bytes(int n)
 	while (n--) rd_byte(&tmp8u);
 }
 
+/**
+ * L: Read a run of bytes, to be decoded later; the caller frees them
+ */
+uint8_t *rd_bytes(uint32_t len)
+{
+	uint8_t *data = mem_alloc(MAX(len, 1));
+	uint32_t i;
+
+	if (len > buffer_size - buffer_pos)
+		quit("Broken savefile - probably from a development version");
+	memcpy(data, buffer + buffer_pos, len);
+	for (i = 0; i < len; i++) {
+		buffer_check += data[i];
+	}
+	buffer_pos += len;
+	return data;
+}
+
+/**
+ * L: Read from a run of bytes kept in memory rather than from the current
+ * block, until rd_restore(); these don't nest
+ */
+static uint8_t *held_buffer;
+static uint32_t held_size, held_pos, held_check;
+static bool redirected;
+
+void rd_redirect(const uint8_t *data, uint32_t len)
+{
+	assert(!redirected);
+	held_buffer = buffer;
+	held_size = buffer_size;
+	held_pos = buffer_pos;
+	held_check = buffer_check;
+	redirected = true;
+
+	buffer = (uint8_t *) data;
+	buffer_size = len;
+	buffer_pos = 0;
+	buffer_check = 0;
+}
+
+void rd_restore(void)
+{
+	assert(redirected);
+	buffer = held_buffer;
+	buffer_size = held_size;
+	buffer_pos = held_pos;
+	buffer_check = held_check;
+	redirected = false;
+}
+
+/**
+ * L: Write to a fresh run of bytes rather than to the current block, until
+ * wr_restore() hands them over; as with rd_redirect(), these don't nest
+ */
+void wr_redirect(void)
+{
+	assert(!redirected);
+	held_buffer = buffer;
+	held_size = buffer_size;
+	held_pos = buffer_pos;
+	held_check = buffer_check;
+	redirected = true;
+
+	buffer_size = BUFFER_INITIAL_SIZE;
+	buffer = mem_alloc(buffer_size);
+	buffer_pos = 0;
+	buffer_check = 0;
+}
+
+uint8_t *wr_restore(uint32_t *len)
+{
+	uint8_t *data = mem_realloc(buffer, MAX(buffer_pos, 1));
+
+	assert(redirected);
+	*len = buffer_pos;
+	buffer = held_buffer;
+	buffer_size = held_size;
+	buffer_pos = held_pos;
+	buffer_check = held_check;
+	redirected = false;
+	return data;
+}
+
 void pad_bytes(int n)
 {
 	while (n--) wr_byte(0);
 }
 
+/**
+ * L: Current write position in the block being saved
+ */
+uint32_t wr_tell(void)
+{
+	return buffer_pos;
+}
+
+/**
+ * L: Copy of everything written to the current block since position pos,
+ * to be written again later by wr_bytes(); the caller frees it
+ */
+uint8_t *wr_copy_from(uint32_t pos, uint32_t *len)
+{
+	uint8_t *data;
+
+	assert(pos <= buffer_pos);
+	*len = buffer_pos - pos;
+	data = mem_alloc(MAX(*len, 1));
+	memcpy(data, buffer + pos, *len);
+	return data;
+}
+
+/**
+ * L: Overwrite a value written earlier in the current block, such as a
+ * length which was not known until after what it measures
+ */
+void wr_u32b_at(uint32_t pos, uint32_t v)
+{
+	uint32_t i;
+
+	assert(pos + 4 <= buffer_pos);
+	for (i = 0; i < 4; i++, v >>= 8) {
+		buffer_check -= buffer[pos + i];
+		buffer[pos + i] = (uint8_t)(v & 0xFF);
+		buffer_check += buffer[pos + i];
+	}
+}
+
+/**
+ * L: Write a run of bytes, usually already encoded by an earlier save
+ */
+void wr_bytes(const uint8_t *data, uint32_t len)
+{
+	uint32_t i;
+
+	sf_reserve(len);
+	memcpy(buffer + buffer_pos, data, len);
+	buffer_pos += len;
+	for (i = 0; i < len; i++) {
+		buffer_check += data[i];
+	}
+}
+
 
 /**
  * ------------------------------------------------------------------------
@@ -322,26 +500,42 @@ void pad_bytes(int n)
  * ------------------------------------------------------------------------ */
 
 
-static bool try_save(ang_file *file)
+/**
+ * Put the whole savefile into the buffer, leaving buffer_pos at its length
+ */
+static void save_image(void)
 {
-	uint8_t savefile_head[SAVEFILE_HEAD_SIZE];
-	size_t i, pos;
-	bool success = true;
+	size_t i;
 
-	/* Start off the buffer */
-	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
+	/* Start off the buffer, big enough for the last savefile */
 	buffer_size = BUFFER_INITIAL_SIZE;
+	while (buffer_size < last_image_size + last_image_size / 8) {
+		buffer_size *= 2;
+	}
+	buffer = mem_alloc(buffer_size);
+	buffer_pos = 0;
+	wr_bytes(savefile_magic, 4);
+	wr_bytes(savefile_name, 4);
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
-		buffer_pos = 0;
+		uint32_t head = buffer_pos, start, len;
+		uint8_t *savefile_head;
+		size_t pos;
+
+		/* Leave room for the header, and fill it in afterwards */
+		sf_reserve(SAVEFILE_HEAD_SIZE);
+		buffer_pos += SAVEFILE_HEAD_SIZE;
+		start = buffer_pos;
 		buffer_check = 0;
 
 		savers[i].save();
+		len = buffer_pos - start;
 
 		/* 16-byte block name */
+		savefile_head = buffer + head;
 		pos = my_strcpy((char *)savefile_head,
 				savers[i].name,
-				sizeof savefile_head);
+				SAVEFILE_HEAD_SIZE);
 		while (pos < 16)
 			savefile_head[pos++] = 0;
 
@@ -352,43 +546,30 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
 		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
+		SAVE_U32B(len);
 		SAVE_U32B(buffer_check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		if (! file_write(file, (char *)savefile_head,
-				SAVEFILE_HEAD_SIZE)) {
-			success = false;
-		}
-		if (! file_write(file, (char *)buffer, buffer_pos)) {
-			success = false;
-		}
-
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4) {
-			if (! file_write(file, "xxx", 4 - (buffer_pos % 4))) {
-				success = false;
-			}
+		while (len % 4) {
+			sf_put('x');
+			len++;
 		}
 	}
 
-	mem_free(buffer);
-
-	return success;
+	last_image_size = buffer_pos;
 }
 
 /**
- * Attempt to save the player in a savefile
+ * Write a savefile image to the .new file, then move it into place
  */
-bool savefile_save(const char *path)
+static bool write_image(const char *path, const uint8_t *image, uint32_t len)
 {
 	ang_file *file;
 	char new_savefile[1024];
 	char old_savefile[1024];
-
-	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
-	(void) save_charoutput();
+	bool saved;
 
 	/* New savefile */
 	safe_setuid_grab();
@@ -401,18 +582,13 @@ bool savefile_save(const char *path)
 	safe_setuid_drop();
 
 	if (file) {
-		if (file_write(file, (char *) &savefile_magic, 4)
-			&& file_write(file, (char *) &savefile_name, 4)) {
-			character_saved = try_save(file);
-		} else {
-			character_saved = false;
-		}
+		saved = file_write(file, (const char *) image, len);
 		file_close(file);
 	} else {
-		character_saved = false;
+		saved = false;
 	}
 
-	if (character_saved) {
+	if (saved) {
 		bool err = false;
 
 		safe_setuid_grab();
@@ -446,6 +622,94 @@ bool savefile_save(const char *path)
 	return false;
 }
 
+#ifdef SAVE_IN_BACKGROUND
+static void *save_job_run(void *unused)
+{
+	save_job.result = write_image(save_job.path, save_job.image,
+		save_job.len);
+	return NULL;
+}
+#endif
+
+/**
+ * Wait for an autosave being written in the background, if there is one,
+ * and return whether it was written; true if there was nothing to wait for
+ */
+bool savefile_save_wait(void)
+{
+#ifdef SAVE_IN_BACKGROUND
+	if (save_job.running) {
+		pthread_join(save_job.thread, NULL);
+		save_job.running = false;
+		string_free(save_job.path);
+		mem_free(save_job.image);
+		character_saved = save_job.result;
+		return save_job.result;
+	}
+#endif
+	return true;
+}
+
+/**
+ * Attempt to save the player in a savefile
+ */
+bool savefile_save(const char *path)
+{
+	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
+	(void) save_charoutput();
+
+#ifdef SAVE_IN_BACKGROUND
+	/* Don't race an autosave to the same file */
+	if (save_job.running && streq(save_job.path, path)) {
+		(void) savefile_save_wait();
+	}
+#endif
+
+	save_image();
+	character_saved = write_image(path, buffer, buffer_pos);
+	mem_free(buffer);
+	buffer = NULL;
+
+	return character_saved;
+}
+
+/**
+ * Save the player in a savefile, writing the file out in the background
+ * where possible.  The state of the game is all captured before this
+ * returns, so play can carry on; savefile_save_wait() gives the outcome.
+ */
+bool savefile_save_background(const char *path)
+{
+#ifdef SAVE_IN_BACKGROUND
+	(void) save_charoutput();
+
+	/* One at a time, and report any earlier failure now */
+	if (!savefile_save_wait()) {
+		msg("Autosave failed!");
+	}
+
+	save_image();
+	save_job.path = string_make(path);
+	save_job.image = buffer;
+	save_job.len = buffer_pos;
+	buffer = NULL;
+	character_saved = false;
+	if (pthread_create(&save_job.thread, NULL, save_job_run, NULL) == 0) {
+		save_job.running = true;
+		return true;
+	}
+
+	/* No thread, so write it here */
+	character_saved = write_image(save_job.path, save_job.image,
+		save_job.len);
+	string_free(save_job.path);
+	mem_free(save_job.image);
+	return character_saved;
+#else
+	return savefile_save(path);
+#endif
+}
+
 
 
 /**
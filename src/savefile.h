@@ -37,6 +37,18 @@ extern bool character_saved;
  */
 bool savefile_save(const char *path);
 
+/**
+ * Save to the given location, writing the file out in the background if
+ * possible.  Returns false if the save has already failed.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Wait for any save being written in the background.  Returns false if it
+ * failed.
+ */
+bool savefile_save_wait(void);
+
 /**
  * Load the savefile given.  Returns true on succcess, false otherwise.
  */
@@ -70,6 +82,10 @@ void wr_u32b(uint32_t v);
 void wr_s32b(int32_t v);
 void wr_string(const char *str);
 void pad_bytes(int n);
+uint32_t wr_tell(void);
+uint8_t *wr_copy_from(uint32_t pos, uint32_t *len);
+void wr_u32b_at(uint32_t pos, uint32_t v);
+void wr_bytes(const uint8_t *data, uint32_t len);
 
 /* Reading bits */
 void rd_byte(uint8_t *ip);
@@ -79,6 +95,11 @@ void rd_u32b(uint32_t *ip);
 void rd_s32b(int32_t *ip);
 void rd_string(char *str, int max);
 void strip_bytes(int n);
+uint8_t *rd_bytes(uint32_t len);
+void rd_redirect(const uint8_t *data, uint32_t len);
+void rd_restore(void);
+void wr_redirect(void);
+uint8_t *wr_restore(uint32_t *len);
 
 
 
@@ -99,6 +120,7 @@ int rd_gear(void);
 int rd_stores(void);
 int rd_dungeon(void);
 int rd_chunks(void);
+int rd_chunks_2(void);
 int rd_objects(void);
 int rd_monsters(void);
 int rd_monster_groups(void);
@@ -106,6 +128,9 @@ int rd_history(void);
 int rd_traps(void);
 int rd_null(void);
 
+struct chunk;
+bool chunk_decode(struct chunk *c);
+
 /* save.c */
 void wr_description(void);
 void wr_randomizer(void);
@@ -131,6 +156,7 @@ void wr_monster_groups(void);
 void wr_ghost(void);
 void wr_history(void);
 void wr_traps(void);
+void chunk_encode(struct chunk *c);
 
 
 #endif /* INCLUDED_SAVEFILE_H */
@@ -169,7 +169,7 @@ int stats_db_bind_rv(sqlite3_stmt *sql_stmt, int col, random_value rv) {
 		strnfmt(sql_buf, 256, "%d", rv.base);
 	}
 	return sqlite3_bind_text(sql_stmt, col, sql_buf, strlen(sql_buf),
-		SQLITE_STATIC);
+		SQLITE_TRANSIENT);
 }
 
 /**
@@ -679,14 +679,9 @@ int price_item(struct store *store, const struct object *obj,
  */
 static int mass_roll(int times, int max)
 {
-	int i, t = 0;
-
 	assert(max > 1);
 
-	for (i = 0; i < times; i++)
-		t += randint0(max);
-
-	return (t);
+	return (int)rng_sum_div(&rng_default, max, times);
 }
 
 
@@ -0,0 +1,160 @@
+/* cave/flow
+ *
+ * Tests for the flow fields towards pursued monsters in cave-flow.c
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+
+#define FLOW_HGT 11
+#define FLOW_WID 21
+#define WALL_X 10
+#define GAP_Y 9
+
+int setup_tests(void **state) {
+	struct chunk *c;
+	struct loc grid;
+
+	set_file_paths();
+	init_angband();
+
+	/* Open ground split by a wall, with one gap at the bottom */
+	c = cave_new(FLOW_HGT, FLOW_WID);
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			square_set_feat(c, grid, square_in_bounds_fully(c, grid) ?
+				FEAT_FLOOR : FEAT_PERM);
+		}
+	}
+	for (grid.y = 1; grid.y < GAP_Y; grid.y++) {
+		grid.x = WALL_X;
+		square_set_feat(c, grid, FEAT_GRANITE);
+	}
+	*state = c;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(state);
+	cleanup_angband();
+	return 0;
+}
+
+static struct monster target_at(int midx, struct loc grid) {
+	struct monster mon;
+
+	memset(&mon, 0, sizeof(mon));
+	mon.midx = midx;
+	mon.grid = grid;
+	return mon;
+}
+
+static int steps_at(struct chunk *c, const uint16_t *dist, struct loc grid) {
+	return dist[grid_to_i(grid, c->width)];
+}
+
+/* Following the field goes round the wall, one step nearer each time */
+static int test_around_wall(void *state) {
+	struct chunk *c = state;
+	struct monster target = target_at(1, loc(15, 2));
+	const uint16_t *dist = cave_monster_flow(c, &target);
+	struct loc grid = loc(5, 2);
+	int steps = steps_at(c, dist, grid);
+
+	eq(steps_at(c, dist, target.grid), 1);
+	eq(steps_at(c, dist, loc(WALL_X, 2)), 0);
+	require(steps > distance(grid, target.grid) + 1);
+
+	while (!loc_eq(grid, target.grid)) {
+		struct loc best = grid;
+		int d;
+
+		for (d = 0; d < 8; d++) {
+			struct loc next = loc_sum(grid, ddgrid_ddd[d]);
+			int s = steps_at(c, dist, next);
+
+			if (s && s < steps_at(c, dist, best)) best = next;
+		}
+		eq(steps_at(c, dist, best), steps_at(c, dist, grid) - 1);
+		grid = best;
+		steps--;
+	}
+	eq(steps, 1);
+	ok;
+}
+
+/* One field serves a target until it has moved far enough */
+static int test_shared(void *state) {
+	struct chunk *c = state;
+	struct monster target = target_at(2, loc(3, 3));
+	const uint16_t *dist = cave_monster_flow(c, &target);
+
+	require(cave_monster_flow(c, &target) == dist);
+
+	/* A short move keeps the old field */
+	target.grid = loc(4, 4);
+	require(cave_monster_flow(c, &target) == dist);
+	eq(steps_at(c, dist, loc(3, 3)), 1);
+
+	/* A longer one fills it again */
+	target.grid = loc(7, 4);
+	require(cave_monster_flow(c, &target) == dist);
+	eq(steps_at(c, dist, loc(7, 4)), 1);
+	eq(steps_at(c, dist, loc(3, 3)), 5);
+	ok;
+}
+
+/* Closing the gap refills the field, leaving the far side out of reach */
+static int test_terrain(void *state) {
+	struct chunk *c = state;
+	struct monster target = target_at(1, loc(15, 2));
+	const uint16_t *dist = cave_monster_flow(c, &target);
+
+	require(steps_at(c, dist, loc(5, 2)) > 0);
+	square_set_feat(c, loc(WALL_X, GAP_Y), FEAT_GRANITE);
+	dist = cave_monster_flow(c, &target);
+	eq(steps_at(c, dist, loc(5, 2)), 0);
+	eq(steps_at(c, dist, loc(12, 5)), 4);
+	square_set_feat(c, loc(WALL_X, GAP_Y), FEAT_FLOOR);
+	ok;
+}
+
+/* With every field taken, the least recently used one goes */
+static int test_reuse(void *state) {
+	struct chunk *c = state;
+	struct monster targets[MON_FLOW_MAX + 1];
+	const uint16_t *first;
+	int i;
+
+	for (i = 0; i < MON_FLOW_MAX; i++) {
+		turn = 100 + i;
+		targets[i] = target_at(10 + i, loc(1 + i, 1));
+		(void) cave_monster_flow(c, &targets[i]);
+	}
+	turn = 100 + MON_FLOW_MAX;
+	first = cave_monster_flow(c, &targets[0]);
+
+	/* The second target's field was used longest ago */
+	turn = 200;
+	targets[MON_FLOW_MAX] = target_at(30, loc(15, 5));
+	require(cave_monster_flow(c, &targets[MON_FLOW_MAX]) != first);
+	for (i = 0; i < MON_FLOW_MAX; i++) {
+		require(c->mon_flows[i].midx != targets[1].midx);
+	}
+	require(cave_monster_flow(c, &targets[0]) == first);
+	ok;
+}
+
+const char *suite_name = "cave/flow";
+struct test tests[] = {
+	{ "around_wall", test_around_wall },
+	{ "shared", test_shared },
+	{ "terrain", test_terrain },
+	{ "reuse", test_reuse },
+	{ NULL, NULL }
+};
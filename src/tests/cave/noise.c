@@ -0,0 +1,268 @@
+/* cave/noise
+ *
+ * Tests for the noise field upkeep in cave-noise.c, checked against (and,
+ * with -v, timed against) the full rebuild it replaced
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "player-birth.h"
+#include "player-timed.h"
+#include "z-queue.h"
+#include <time.h>
+
+#define WALK_STEPS 400
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	player_make_simple(NULL, NULL, "Tester");
+	player->depth = 30;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The old make_noise(): clear the whole level, then flood it all
+ */
+static void full_rebuild(struct chunk *c, struct loc origin, int increment,
+		uint16_t **grids)
+{
+	struct loc next = origin;
+	int y, x, d;
+	int noise = 0;
+	struct queue *queue = q_new(c->height * c->width);
+
+	for (y = 1; y < c->height - 1; y++) {
+		for (x = 1; x < c->width - 1; x++) {
+			grids[y][x] = 0;
+		}
+	}
+
+	grids[next.y][next.x] = noise;
+	q_push_int(queue, grid_to_i(next, c->width));
+	noise += increment;
+
+	while (q_len(queue) > 0) {
+		i_to_grid(q_pop_int(queue), c->width, &next);
+		if (grids[next.y][next.x] == noise) {
+			q_push_int(queue, grid_to_i(next, c->width));
+			noise += increment;
+			continue;
+		}
+		for (d = 0; d < 8; d++) {
+			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+
+			if (!square_in_bounds(c, grid)) continue;
+			if (square_isnoflow(c, grid)) continue;
+			if (grids[grid.y][grid.x] != 0) continue;
+			if (loc_eq(origin, grid)) continue;
+			grids[grid.y][grid.x] = noise;
+			q_push_int(queue, grid_to_i(grid, c->width));
+		}
+	}
+
+	q_free(queue);
+}
+
+static uint16_t **grids_new(struct chunk *c)
+{
+	uint16_t **grids = mem_zalloc(c->height * sizeof(uint16_t*));
+	int y;
+
+	for (y = 0; y < c->height; y++) {
+		grids[y] = mem_zalloc(c->width * sizeof(uint16_t));
+	}
+	return grids;
+}
+
+static void grids_free(struct chunk *c, uint16_t **grids)
+{
+	int y;
+
+	for (y = 0; y < c->height; y++) {
+		mem_free(grids[y]);
+	}
+	mem_free(grids);
+}
+
+/**
+ * Within its limit the field must match a full rebuild; beyond it, silence
+ */
+static bool field_matches(struct chunk *c, uint16_t **grids)
+{
+	int y, x;
+
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			int want = grids[y][x];
+
+			if (want > c->noise_field.limit) want = 0;
+			if (c->noise.grids[y][x] != want) return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Step the player to a random neighbouring grid that carries sound
+ */
+static void random_step(struct chunk *c, struct player *p)
+{
+	int tries;
+
+	for (tries = 0; tries < 20; tries++) {
+		struct loc grid = loc_sum(p->grid, ddgrid_ddd[randint0(8)]);
+
+		if (!square_in_bounds_fully(c, grid)) continue;
+		if (square_isnoflow(c, grid)) continue;
+		p->grid = grid;
+		return;
+	}
+}
+
+static struct chunk *make_level(const char *profile)
+{
+	struct dun_data dun_body;
+	struct chunk *c = NULL;
+	const char *error = NULL;
+	int tries;
+
+	memset(&dun_body, 0, sizeof(dun_body));
+	dun = &dun_body;
+	for (tries = 0; !c && tries < 20; tries++) {
+		if (streq(profile, "cavern")) {
+			c = cavern_gen(player, 0, 0, &error);
+		} else {
+			c = labyrinth_gen(player, 0, 0, &error);
+		}
+	}
+	dun = NULL;
+	return c;
+}
+
+static void free_level(struct chunk *c)
+{
+	wipe_mon_list(c, player);
+	cave_free(c);
+}
+
+/**
+ * Walk the player about a level, opening and closing the way now and then,
+ * checking the field after every turn
+ */
+static int walk_level(const char *profile)
+{
+	struct chunk *c = make_level(profile);
+	uint16_t **grids;
+	int i;
+
+	require(c);
+	grids = grids_new(c);
+
+	for (i = 0; i < WALK_STEPS; i++) {
+		int increment = (i % 50 < 10) ? 4 : 1;
+
+		player->timed[TMD_COVERTRACKS] = (increment == 4);
+
+		/* Block or unblock a grid near the player */
+		if (i % 7 == 0) {
+			struct loc grid = loc_sum(player->grid,
+				loc(randint0(9) - 4, randint0(9) - 4));
+
+			if (square_in_bounds_fully(c, grid) &&
+				!loc_eq(grid, player->grid)) {
+				square_set_feat(c, grid, square_isnoflow(c, grid) ?
+					FEAT_FLOOR : FEAT_RUBBLE);
+			}
+		}
+
+		/* Stand still some turns */
+		if (i % 3) random_step(c, player);
+
+		cave_update_noise(c, player);
+		full_rebuild(c, player->grid, increment, grids);
+		require(field_matches(c, grids));
+	}
+
+	player->timed[TMD_COVERTRACKS] = 0;
+	grids_free(c, grids);
+	free_level(c);
+	ok;
+}
+
+static int test_cavern(void *state) {
+	return walk_level("cavern");
+}
+
+static int test_labyrinth(void *state) {
+	return walk_level("labyrinth");
+}
+
+/**
+ * Time a walk about each profile using the full rebuild and then the field
+ * upkeep; the comparison is only shown when running verbosely
+ */
+static int test_benchmark(void *state) {
+	const char *profiles[] = { "cavern", "labyrinth" };
+	size_t j;
+
+	for (j = 0; j < N_ELEMENTS(profiles); j++) {
+		struct chunk *c = make_level(profiles[j]);
+		struct loc *path;
+		uint16_t **grids;
+		clock_t t0, t1, t2;
+		int i;
+
+		require(c);
+		grids = grids_new(c);
+
+		/* Both runs follow the same path */
+		path = mem_zalloc(WALK_STEPS * 10 * sizeof(*path));
+		for (i = 0; i < WALK_STEPS * 10; i++) {
+			if (i % 3) random_step(c, player);
+			path[i] = player->grid;
+		}
+
+		t0 = clock();
+		for (i = 0; i < WALK_STEPS * 10; i++) {
+			full_rebuild(c, path[i], 1, grids);
+		}
+		t1 = clock();
+		for (i = 0; i < WALK_STEPS * 10; i++) {
+			player->grid = path[i];
+			cave_update_noise(c, player);
+		}
+		t2 = clock();
+		mem_free(path);
+		require(field_matches(c, grids));
+
+		if (verbose) {
+			printf("\n    %s %dx%d: full rebuild %.3fs, field %.3fs  ",
+				profiles[j], c->width, c->height,
+				(double)(t1 - t0) / CLOCKS_PER_SEC,
+				(double)(t2 - t1) / CLOCKS_PER_SEC);
+		}
+
+		grids_free(c, grids);
+		free_level(c);
+	}
+	ok;
+}
+
+const char *suite_name = "cave/noise";
+struct test tests[] = {
+	{ "cavern", test_cavern },
+	{ "labyrinth", test_labyrinth },
+	{ "benchmark", test_benchmark },
+	{ NULL, NULL }
+};
@@ -1,3 +1,5 @@
 TESTPROGS += \
 	cave/find \
+	cave/flow \
+	cave/noise \
 	cave/scatter
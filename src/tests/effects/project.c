@@ -0,0 +1,278 @@
+/*
+ * effects/project
+ * Test the grids project() collects for balls and arcs, and (with -v) time
+ * large ones in open caverns.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-event.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "player-birth.h"
+#include "project.h"
+#include "source.h"
+#include <time.h>
+
+#define BENCH_CASTS 200
+
+/* The last blast project() reported */
+static struct loc *seen_grid;
+static int *seen_dist;
+static int seen_num;
+
+static void record_blast(game_event_type type, game_event_data *data,
+		void *user)
+{
+	int n = data->explosion.num_grids;
+
+	mem_free(seen_grid);
+	mem_free(seen_dist);
+	seen_grid = mem_zalloc(n * sizeof(*seen_grid));
+	seen_dist = mem_zalloc(n * sizeof(*seen_dist));
+	memcpy(seen_grid, data->explosion.blast_grid, n * sizeof(*seen_grid));
+	memcpy(seen_dist, data->explosion.distance_to_grid,
+		n * sizeof(*seen_dist));
+	seen_num = n;
+}
+
+static struct chunk *create_open_cave(int height, int width) {
+	struct chunk *c = cave_new(height, width);
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < height; grid.y++) {
+		for (grid.x = 0; grid.x < width; grid.x++) {
+			square_set_feat(c, grid, square_in_bounds_fully(c, grid) ?
+				FEAT_FLOOR : FEAT_PERM);
+		}
+	}
+	return c;
+}
+
+/**
+ * Make a level current, with an empty map of it for the player
+ */
+static void use_level(struct chunk *c, struct player *p) {
+	int i;
+
+	cave = c;
+	if (p->cave) cave_free(p->cave);
+	p->cave = cave_new(c->height, c->width);
+	p->cave->objects = mem_realloc(p->cave->objects, (c->obj_max + 1) *
+		sizeof(struct object*));
+	p->cave->obj_max = c->obj_max;
+	for (i = 0; i <= p->cave->obj_max; ++i) {
+		p->cave->objects[i] = NULL;
+	}
+	p->cave->depth = c->depth;
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	player->depth = 30;
+	use_level(create_open_cave(z_info->dungeon_hgt, z_info->dungeon_wid),
+		player);
+	player->grid = loc(10, 10);
+	event_add_handler(EVENT_EXPLOSION, record_blast, NULL);
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(seen_grid);
+	mem_free(seen_dist);
+	cleanup_angband();
+	return 0;
+}
+
+static int blast_index(struct loc grid)
+{
+	int i;
+
+	for (i = 0; i < seen_num; i++) {
+		if (loc_eq(seen_grid[i], grid)) return i;
+	}
+	return -1;
+}
+
+/**
+ * The blast must be nearest first, carry true distances and leave no marks
+ */
+static bool blast_well_formed(struct loc centre)
+{
+	int i;
+
+	for (i = 0; i < seen_num; i++) {
+		if (seen_dist[i] != distance(centre, seen_grid[i])) return false;
+		if (i && seen_dist[i] < seen_dist[i - 1]) return false;
+		if (square_isproject(cave, seen_grid[i])) return false;
+	}
+	return true;
+}
+
+/* A big ball in the open takes every grid in its radius, past 256 of them */
+static int test_open_ball(void *state) {
+	struct loc centre = loc(60, 30);
+	int rad = 15, count = 0;
+	struct loc grid;
+
+	project(source_player(), rad, centre, 10, PROJ_FIRE,
+		PROJECT_JUMP | PROJECT_KILL, 0, 0, NULL);
+	for (grid.y = centre.y - rad; grid.y <= centre.y + rad; grid.y++) {
+		for (grid.x = centre.x - rad; grid.x <= centre.x + rad; grid.x++) {
+			if (distance(centre, grid) <= rad) count++;
+		}
+	}
+	eq(seen_num, count);
+	require(seen_num > 256);
+	require(loc_eq(seen_grid[0], centre));
+	require(blast_well_formed(centre));
+	ok;
+}
+
+/* Among pillars, a ball takes exactly the grids in view of its centre */
+static int test_pillars(void *state) {
+	struct loc centre = loc(100, 33);
+	int rad = 12, count = 0;
+	struct loc grid;
+
+	for (grid.y = centre.y - rad; grid.y <= centre.y + rad; grid.y += 3) {
+		for (grid.x = centre.x - rad; grid.x <= centre.x + rad; grid.x += 4) {
+			if (!loc_eq(grid, centre)) {
+				square_set_feat(cave, grid, FEAT_GRANITE);
+			}
+		}
+	}
+
+	project(source_player(), rad, centre, 10, PROJ_FIRE,
+		PROJECT_JUMP | PROJECT_KILL, 0, 0, NULL);
+	require(blast_well_formed(centre));
+	for (grid.y = centre.y - rad; grid.y <= centre.y + rad; grid.y++) {
+		for (grid.x = centre.x - rad; grid.x <= centre.x + rad; grid.x++) {
+			bool want = distance(centre, grid) <= rad &&
+				square_isprojectable(cave, grid) && los(cave, centre, grid);
+
+			require(want == (blast_index(grid) >= 0));
+			if (want) count++;
+		}
+	}
+	eq(seen_num, count);
+	ok;
+}
+
+/* An arc fans out from the caster towards its target and not behind */
+static int test_arc(void *state) {
+	struct loc target = loc(40, 10);
+	int i;
+
+	project(source_player(), 20, target, 10, PROJ_FIRE,
+		PROJECT_ARC | PROJECT_KILL, 60, 20, NULL);
+	require(blast_well_formed(player->grid));
+	require(blast_index(loc(30, 10)) >= 0);
+	require(blast_index(loc(25, 14)) >= 0);
+	require(blast_index(target) < 0);
+	require(blast_index(loc(5, 10)) < 0);
+	require(blast_index(loc(10, 25)) < 0);
+	for (i = 0; i < seen_num; i++) {
+		require(seen_dist[i] <= 20);
+	}
+	ok;
+}
+
+static struct chunk *make_cavern(void)
+{
+	struct dun_data dun_body;
+	struct chunk *c = NULL;
+	const char *error = NULL;
+	int tries;
+
+	memset(&dun_body, 0, sizeof(dun_body));
+	dun = &dun_body;
+	for (tries = 0; !c && tries < 20; tries++) {
+		c = cavern_gen(player, 0, 0, &error);
+	}
+	dun = NULL;
+	return c;
+}
+
+/**
+ * Time a run of maximum radius balls and breaths about an open arena and
+ * a generated cavern; the timings are only shown when running verbosely
+ */
+static int test_benchmark(void *state) {
+	struct chunk *arena = cave;
+	struct chunk *cavern = make_cavern();
+	struct chunk *levels[2];
+	struct loc spots[2];
+	const char *names[] = { "arena", "cavern" };
+	int flg = PROJECT_KILL | PROJECT_ITEM | PROJECT_GRID;
+	struct loc home = player->grid;
+	size_t j;
+
+	require(cavern);
+	levels[0] = arena;
+	spots[0] = loc(arena->width / 2, arena->height / 2);
+	levels[1] = cavern;
+	spots[1] = player->grid;
+	for (j = 0; j < N_ELEMENTS(levels); j++) {
+		clock_t t0, t1, t2;
+		int balls = 0, breaths = 0, num_breaths = 0;
+		int i;
+
+		use_level(levels[j], player);
+		player->grid = spots[j];
+
+		t0 = clock();
+		for (i = 0; i < BENCH_CASTS; i++) {
+			project(source_player(), 20, player->grid, 100, PROJ_FIRE,
+				flg | PROJECT_JUMP, 0, 0, NULL);
+			balls += seen_num;
+		}
+		t1 = clock();
+		for (i = 0; i < BENCH_CASTS; i++) {
+			struct loc target = loc_sum(player->grid,
+				loc(ddx_ddd[i % 8] * 10, ddy_ddd[i % 8] * 10));
+
+			if (!square_in_bounds_fully(cave, target)) continue;
+			project(source_player(), 20, target, 100, PROJ_FIRE,
+				flg | PROJECT_ARC, 90, 20, NULL);
+			breaths += seen_num;
+			num_breaths++;
+		}
+		t2 = clock();
+		require(blast_well_formed(player->grid));
+
+		if (verbose) {
+			printf("\n    %s: %d balls %.3fs (%d grids each), "
+				"%d breaths %.3fs (%d grids each)  ", names[j],
+				BENCH_CASTS, (double)(t1 - t0) / CLOCKS_PER_SEC,
+				balls / BENCH_CASTS, num_breaths,
+				(double)(t2 - t1) / CLOCKS_PER_SEC,
+				breaths / MAX(num_breaths, 1));
+		}
+	}
+
+	wipe_mon_list(cavern, player);
+	cave_free(cavern);
+	use_level(arena, player);
+	player->grid = home;
+	ok;
+}
+
+const char *suite_name = "effects/project";
+struct test tests[] = {
+	{ "open_ball", test_open_ball },
+	{ "pillars", test_pillars },
+	{ "arc", test_arc },
+	{ "benchmark", test_benchmark },
+	{ NULL, NULL }
+};
@@ -0,0 +1,258 @@
+/* game/save
+ *
+ * Tests for writing stored chunks to the savefile, and reading them back
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "player-birth.h"
+#include "savefile.h"
+#include "z-file.h"
+
+#define SAVE_NAME "TestSave"
+#define SAVE_CHUNKS 5
+
+int setup_tests(void **state) {
+	int i;
+
+	set_file_paths();
+	init_angband();
+#ifdef UNIX
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, "Tester")) return 1;
+	prepare_next_level(player);
+	on_new_level();
+
+	/* Some stored levels to write out */
+	for (i = 0; i < SAVE_CHUNKS; i++) {
+		struct chunk *c = chunk_write(cave);
+		c->name = string_make(format("Test %d", i));
+		chunk_list_add(c);
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete(SAVE_NAME);
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	return 0;
+}
+
+static void reset_before_load(void) {
+	play_again = true;
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	chunk_list_max = 0;
+	init_angband();
+	play_again = false;
+}
+
+/* Read the whole savefile; the caller frees it */
+static char *read_save(size_t *len) {
+	ang_file *f = file_open(SAVE_NAME, MODE_READ, FTYPE_SAVE);
+	size_t size = 0, alloc = 4096;
+	char *data = mem_alloc(alloc);
+	int n;
+
+	if (!f) return NULL;
+	while ((n = file_read(f, data + size, alloc - size)) > 0) {
+		size += n;
+		if (size == alloc) {
+			alloc *= 2;
+			data = mem_realloc(data, alloc);
+		}
+	}
+	file_close(f);
+	*len = size;
+	return data;
+}
+
+static void dirty_all(void) {
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++) {
+		chunk_dirty(chunk_list[i]);
+	}
+}
+
+/* Copying chunks forward writes the same savefile as encoding them again */
+static int test_copy_forward(void *state) {
+	char *fresh, *copied;
+	size_t fresh_len, copied_len;
+	int i;
+
+	require(savefile_save(SAVE_NAME));
+	fresh = read_save(&fresh_len);
+	notnull(fresh);
+	for (i = 0; i < chunk_list_max; i++) {
+		notnull(chunk_list[i]->save_data);
+	}
+
+	require(savefile_save(SAVE_NAME));
+	copied = read_save(&copied_len);
+	notnull(copied);
+	eq(copied_len, fresh_len);
+	require(!memcmp(fresh, copied, fresh_len));
+	mem_free(copied);
+
+	/* Change one stored level */
+	square_set_feat(chunk_list[2], loc(1, 1), FEAT_RUBBLE);
+	chunk_dirty(chunk_list[2]);
+	require(savefile_save(SAVE_NAME));
+	copied = read_save(&copied_len);
+	require(copied_len != fresh_len || memcmp(fresh, copied, fresh_len));
+	mem_free(fresh);
+
+	/* Which matches encoding everything afresh */
+	dirty_all();
+	require(savefile_save(SAVE_NAME));
+	fresh = read_save(&fresh_len);
+	eq(copied_len, fresh_len);
+	require(!memcmp(fresh, copied, fresh_len));
+	mem_free(fresh);
+	mem_free(copied);
+	ok;
+}
+
+/* A level taken off the list forgets how it was saved */
+static int test_remove(void *state) {
+	struct chunk *c = chunk_find_name("Test 4");
+
+	notnull(c);
+	require(savefile_save(SAVE_NAME));
+	notnull(c->save_data);
+	require(chunk_list_remove("Test 4"));
+	null(c->save_data);
+	chunk_list_add(c);
+	null(c->save_data);
+	ok;
+}
+
+/* An autosave in the background writes the same file as a plain save */
+static int test_background(void *state) {
+	char *plain, *background;
+	size_t plain_len, background_len;
+
+	require(savefile_save(SAVE_NAME));
+	plain = read_save(&plain_len);
+	notnull(plain);
+	file_delete(SAVE_NAME);
+
+	require(savefile_save_background(SAVE_NAME));
+	require(savefile_save_wait());
+	require(character_saved);
+	background = read_save(&background_len);
+	notnull(background);
+	eq(background_len, plain_len);
+	require(!memcmp(plain, background, plain_len));
+	mem_free(background);
+
+	/* A plain save waits for the background one to the same file */
+	require(savefile_save_background(SAVE_NAME));
+	require(savefile_save(SAVE_NAME));
+	background = read_save(&background_len);
+	eq(background_len, plain_len);
+	require(!memcmp(plain, background, plain_len));
+	require(savefile_save_wait());
+	mem_free(background);
+	mem_free(plain);
+	ok;
+}
+
+/* A stored level packs down and comes back as it was */
+static int test_freeze(void *state) {
+	struct chunk *c = chunk_find_name("Test 3");
+	struct monster_race *race = lookup_monster("Grip, Farmer Maggot's Dog");
+	struct monster_group_info info = { 0, 0 };
+	struct monster *mon;
+	struct loc grid;
+	size_t full;
+
+	notnull(c);
+	notnull(race);
+	require(race->cur_num == 0);
+	require(cave_find(c, &grid, square_isempty));
+	require(place_new_monster(c, grid, race, false, false, info,
+		ORIGIN_DROP));
+	eq(race->cur_num, 1);
+	chunk_dirty(c);
+	full = chunk_memory(c);
+
+	chunk_freeze(c);
+	require(c->encoded);
+	require(chunk_peek_name("Test 3") == c);
+	eq(race->cur_num, 1);
+	eq(c->full_size, full);
+	require(chunk_memory(c) < full / 4);
+
+	/* Packed levels are saved as they are */
+	require(savefile_save(SAVE_NAME));
+	require(c->encoded);
+
+	require(chunk_find_name("Test 3") == c);
+	require(!c->encoded);
+	eq(race->cur_num, 1);
+	mon = square_monster(c, grid);
+	notnull(mon);
+	require(mon->race == race);
+	ok;
+}
+
+/* Stored levels stay encoded after loading until they are looked for */
+static int test_lazy(void *state) {
+	struct chunk *c;
+	uint32_t len;
+	int height = cave->height, width = cave->width;
+	int i;
+
+	require(savefile_save(SAVE_NAME));
+	len = chunk_find_name("Test 2")->save_len;
+
+	/* Read the stored levels back from the savefile */
+	reset_before_load();
+	require(savefile_load(SAVE_NAME, false));
+	eq(chunk_list_max, SAVE_CHUNKS);
+	for (i = 0; i < chunk_list_max; i++) {
+		require(chunk_list[i]->encoded);
+	}
+
+	/* Finding a level by depth or peeking at it leaves it alone */
+	c = chunk_peek_name("Test 2");
+	notnull(c);
+	require(c->encoded);
+	eq(c->save_len, len);
+
+	/* Finding it by name reads it */
+	require(chunk_find_name("Test 2") == c);
+	require(!c->encoded);
+	eq(c->height, height);
+	eq(c->width, width);
+	eq(c->save_len, len);
+	eq(square(c, loc(1, 1))->feat, FEAT_RUBBLE);
+	require(chunk_list[0]->encoded);
+
+	/* Saving copies both kinds forward unchanged */
+	require(savefile_save(SAVE_NAME));
+	eq(c->save_len, len);
+	require(chunk_list[0]->encoded);
+	ok;
+}
+
+const char *suite_name = "game/save";
+struct test tests[] = {
+	{ "copy_forward", test_copy_forward },
+	{ "remove", test_remove },
+	{ "background", test_background },
+	{ "freeze", test_freeze },
+	{ "lazy", test_lazy },
+	{ NULL, NULL }
+};
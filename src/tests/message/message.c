@@ -9,6 +9,7 @@
 #include "z-form.h"
 #include "z-util.h"
 #include "z-virt.h"
+#include <time.h>
 
 struct test_message_event_state {
 	char *lastmsg;
@@ -298,6 +299,100 @@ static int test_many_repeat(void *state)
 	ok;
 }
 
+static int test_long(void *state)
+{
+	char buf[1024];
+	char *big;
+	const char *txt;
+	uint16_t n;
+	int i;
+
+	messages_free();
+	messages_init();
+
+	/*
+	 * Long messages use up the text space before the ring fills, so the
+	 * oldest are forgotten sooner, but the newest are always intact.
+	 */
+	for (i = 0; i < (int)sizeof(buf) - 1; i++) {
+		buf[i] = 'a' + i % 26;
+	}
+	buf[sizeof(buf) - 1] = '\0';
+	for (i = 0; i < 2000; i++) {
+		buf[0] = 'a' + i % 26;
+		message_add(buf, MSG_GENERIC);
+		txt = message_str(0);
+		require(streq(txt, buf));
+	}
+	n = messages_num();
+	require(n > 1 && n < 2000);
+	for (i = 0; i < n; i++) {
+		txt = message_str(i);
+		eq(strlen(txt), sizeof(buf) - 1);
+	}
+
+	/* Short ones are still kept after that */
+	message_add("short", MSG_HIT);
+	txt = message_str(0);
+	require(streq(txt, "short"));
+	txt = message_str(1);
+	eq(strlen(txt), sizeof(buf) - 1);
+
+	/* Repeats of a message too long to keep whole still merge */
+	big = mem_alloc(200000);
+	memset(big, 'z', 199999);
+	big[199999] = '\0';
+	message_add(big, MSG_GENERIC);
+	message_add(big, MSG_GENERIC);
+	mem_free(big);
+	eq(message_count(0), 2);
+	txt = message_str(0);
+	require(strlen(txt) > 0 && strlen(txt) < 199999);
+	require(strlen(message_str(1)) != strlen(txt));
+
+	ok;
+}
+
+/**
+ * Time adding 100,000 messages and then paging through the whole history a
+ * screenful at a time, as the message history screen does; only reported
+ * when running verbosely
+ */
+static int test_benchmark(void *state)
+{
+	char buf[80];
+	clock_t t0, t1, t2;
+	size_t total = 0;
+	uint16_t n;
+	int i, j;
+
+	messages_free();
+	messages_init();
+
+	t0 = clock();
+	for (i = 0; i < 100000; i++) {
+		strnfmt(buf, sizeof(buf), "The cave orc hits you (%d).", i);
+		message_add(buf, MSG_GENERIC);
+	}
+	t1 = clock();
+	n = messages_num();
+	for (i = 0; i < n; i++) {
+		for (j = i; j < n && j < i + 20; j++) {
+			total += strlen(message_str(j)) + message_count(j);
+		}
+	}
+	t2 = clock();
+
+	require(total > 0);
+	require(streq(message_str(0), buf));
+	if (verbose) {
+		printf("\n    add 100000: %.3fs, scroll %d: %.3fs  ", (double)(t1 - t0)
+			/ CLOCKS_PER_SEC, (int)n, (double)(t2 - t1) / CLOCKS_PER_SEC);
+	}
+
+	ok;
+}
+
 static int test_color(void *state) {
 	uint8_t color;
 
@@ -663,6 +758,8 @@ struct test tests[] = {
 	{ "add", test_add },
 	{ "fill", test_fill },
 	{ "many_repeat", test_many_repeat },
+	{ "long", test_long },
+	{ "benchmark", test_benchmark },
 	{ "color", test_color },
 	{ "format", test_msg },
 	{ "sound", test_sound },
@@ -0,0 +1,120 @@
+/* monster/index
+ *
+ * Tests for the spatial monster index in mon-index.c
+ */
+
+#include "cave.h"
+#include "mon-index.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "player-birth.h"
+#include "test-utils.h"
+#include "unit-test.h"
+#include "unit-test-data.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	player_make_simple(NULL, NULL, "Tester");
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Every monster is visited once, and never closer than the bound claims */
+static int test_iterate(void *state) {
+	struct chunk *c = t_build_arena(40, 60);
+	struct loc centre = loc(30, 20);
+	struct mon_index_iter iter;
+	struct monster *mon;
+	int seen = 0, last_bound = 0;
+	int x, y;
+
+	for (y = 2; y < 38; y += 5) {
+		for (x = 2; x < 58; x += 7) {
+			t_add_monster(c, loc(x, y), "wolf");
+		}
+	}
+	require(mon_index_verify(c));
+
+	mon_index_iter_init(&iter, c, centre, 0xFFFFFFFF);
+	while ((mon = mon_index_iter_next(&iter))) {
+		int bound = mon_index_iter_bound(&iter);
+		require(bound >= last_bound);
+		require(bound <= distance(centre, mon->grid));
+		last_bound = bound;
+		seen++;
+	}
+	eq(seen, cave_monster_count(c));
+
+	wipe_mon_list(c, player);
+	require(mon_index_verify(c));
+	cave_free(c);
+	ok;
+}
+
+/* Only the requested factions are visited */
+static int test_factions(void *state) {
+	struct chunk *c = t_build_arena(20, 20);
+	struct mon_index_iter iter;
+	struct monster *mon;
+	uint32_t slots = 0;
+	int i, seen = 0;
+
+	t_add_monster(c, loc(3, 3), "wolf");
+	t_add_monster(c, loc(4, 3), "wild cat");
+	t_add_monster(c, loc(15, 15), "wolf");
+	t_add_monster(c, loc(12, 4), "wild cat");
+
+	for (i = 0; i < mon_index_num_factions(c); i++) {
+		if (mon_index_faction(c, i) == 'C') slots |= (1U << i);
+	}
+	require(slots);
+
+	mon_index_iter_init(&iter, c, loc(10, 10), slots);
+	while ((mon = mon_index_iter_next(&iter))) {
+		eq(mon->faction, 'C');
+		seen++;
+	}
+	eq(seen, 2);
+
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+/* Deleting and compacting monsters keeps the index in step */
+static int test_delete_compact(void *state) {
+	struct chunk *c = t_build_arena(30, 30);
+	int x;
+
+	for (x = 2; x < 28; x += 2) {
+		t_add_monster(c, loc(x, 5), "wolf");
+		t_add_monster(c, loc(x, 20), "wild cat");
+	}
+	require(mon_index_verify(c));
+
+	for (x = 2; x < 28; x += 6) {
+		delete_monster(c, loc(x, 5));
+		require(mon_index_verify(c));
+	}
+
+	compact_monsters(c, 0);
+	require(mon_index_verify(c));
+
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "monster/index";
+struct test tests[] = {
+	{ "iterate", test_iterate },
+	{ "factions", test_factions },
+	{ "delete_compact", test_delete_compact },
+	{ NULL, NULL }
+};
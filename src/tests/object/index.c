@@ -0,0 +1,136 @@
+/* object/index
+ *
+ * Tests for the spatial object index in obj-index.c
+ */
+
+#include "cave.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "obj-index.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-util.h"
+#include "player-birth.h"
+#include "test-utils.h"
+#include "unit-test.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	player_make_simple(NULL, NULL, "Tester");
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static struct object *add_object(struct chunk *c, struct loc grid)
+{
+	struct object *obj = object_new();
+
+	object_prep(obj, lookup_kind(TV_BOOTS, 1), 0, RANDOMISE);
+	obj->grid = grid;
+	square_insert_object(c, grid, obj);
+	list_object(c, obj);
+	return obj;
+}
+
+static void delete_objects(struct chunk *c, struct loc grid)
+{
+	struct object *obj;
+
+	while ((obj = square_object(c, grid))) {
+		square_delete_object(c, grid, obj, false, false);
+	}
+}
+
+/* Every pile is visited once, and never closer than the bound claims */
+static int test_iterate(void *state) {
+	struct chunk *c = t_build_arena(40, 60);
+	struct loc centre = loc(30, 20);
+	struct obj_index_iter iter;
+	struct loc grid;
+	int piles = 0, seen = 0, last_bound = 0;
+	int x, y;
+
+	for (y = 2; y < 38; y += 5) {
+		for (x = 2; x < 58; x += 7) {
+			add_object(c, loc(x, y));
+			if (x % 3 == 0) add_object(c, loc(x, y));
+			piles++;
+		}
+	}
+	require(obj_index_verify(c));
+
+	obj_index_iter_init(&iter, c, centre);
+	while (obj_index_iter_next(&iter, &grid)) {
+		int bound = obj_index_iter_bound(&iter);
+		require(square_object(c, grid));
+		require(bound >= last_bound);
+		require(bound <= distance(centre, grid));
+		last_bound = bound;
+		seen++;
+	}
+	eq(seen, piles);
+
+	/* Row order scan, emptying the level as it goes */
+	grid = loc(0, 0);
+	seen = 0;
+	while (obj_index_find_pile(c, &grid)) {
+		delete_objects(c, grid);
+		require(obj_index_verify(c));
+		seen++;
+	}
+	eq(seen, piles);
+
+	cave_free(c);
+	ok;
+}
+
+/* A monster that takes items goes for the nearest one it can see */
+static int test_nearest(void *state) {
+	struct chunk *c = t_build_arena(30, 60);
+	struct monster *mon = t_add_monster(c, loc(10, 10), "filthy street urchin");
+	struct object *far, *near, *hidden;
+	int y;
+
+	/* A wall between the monster and the nearest object */
+	for (y = 1; y < 29; y++) {
+		square_set_feat(c, loc(7, y), FEAT_GRANITE);
+	}
+
+	null(monster_nearest_takeable_item(c, mon));
+	far = add_object(c, loc(40, 25));
+	ptreq(monster_nearest_takeable_item(c, mon), far);
+	near = add_object(c, loc(18, 12));
+	hidden = add_object(c, loc(5, 10));
+	ptreq(monster_nearest_takeable_item(c, mon), near);
+	require(obj_index_verify(c));
+
+	/* Knock the wall down */
+	for (y = 1; y < 29; y++) {
+		square_set_feat(c, loc(7, y), FEAT_FLOOR);
+	}
+	ptreq(monster_nearest_takeable_item(c, mon), hidden);
+
+	/* Gone */
+	delete_objects(c, loc(5, 10));
+	delete_objects(c, loc(18, 12));
+	ptreq(monster_nearest_takeable_item(c, mon), far);
+	require(obj_index_verify(c));
+
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "object/index";
+struct test tests[] = {
+	{ "iterate", test_iterate },
+	{ "nearest", test_nearest },
+	{ NULL, NULL }
+};
@@ -0,0 +1,127 @@
+/* object/lookup
+ *
+ * Tests for the hashed lookups of kinds, egos, monsters and terrain
+ */
+
+#include "cave.h"
+#include "init.h"
+#include "mon-util.h"
+#include "obj-desc.h"
+#include "obj-util.h"
+#include "test-utils.h"
+#include "unit-test.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Every kind is found by tval and sval, and by its name */
+static int test_kinds(void *state) {
+	char name[1024], upper[1024];
+	int i, j;
+
+	for (i = 0; i < z_info->k_max; i++) {
+		struct object_kind *kind = &k_info[i];
+		struct object_kind *first = NULL;
+
+		if (!kind->name) continue;
+		for (j = 0; j < z_info->k_max && !first; j++) {
+			if (k_info[j].tval == kind->tval && k_info[j].sval == kind->sval)
+				first = &k_info[j];
+		}
+		ptreq(lookup_kind(kind->tval, kind->sval), first);
+
+		obj_desc_name_format(name, sizeof(name), 0, kind->name, 0, false);
+		my_strcpy(upper, name, sizeof(upper));
+		for (j = 0; upper[j]; j++) upper[j] = toupper((unsigned char) upper[j]);
+		first = NULL;
+		for (j = 0; j < z_info->k_max && !first; j++) {
+			char cmp[1024];
+			if (!k_info[j].name || k_info[j].tval != kind->tval) continue;
+			obj_desc_name_format(cmp, sizeof(cmp), 0, k_info[j].name, 0,
+				false);
+			if (!my_stricmp(cmp, name)) first = &k_info[j];
+		}
+		require(first);
+		eq(lookup_sval(kind->tval, name), first->sval);
+		eq(lookup_sval(kind->tval, upper), first->sval);
+	}
+	eq(lookup_sval(TV_FOOD, "No Such Food"), -1);
+	eq(lookup_sval(TV_FOOD, "12"), 12);
+	ok;
+}
+
+/* Every ego is found for each kind it can go on */
+static int test_egos(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->e_max; i++) {
+		struct ego_item *ego = &e_info[i];
+		struct poss_item *poss;
+
+		if (!ego->name) continue;
+		for (poss = ego->poss_items; poss; poss = poss->next) {
+			struct object_kind *kind = &k_info[poss->kidx];
+			struct ego_item *found =
+				lookup_ego_item(ego->name, kind->tval, kind->sval);
+			require(found);
+			require(streq(found->name, ego->name));
+			require(found <= ego);
+		}
+	}
+	null(lookup_ego_item("of No Such Ego", TV_SWORD, 1));
+	ok;
+}
+
+/* Monsters are found by exact name ignoring case, then by substring */
+static int test_monsters(void *state) {
+	char upper[256];
+	int i, j;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+
+		if (!race->name) continue;
+		ptreq(lookup_monster(race->name), race);
+		my_strcpy(upper, race->name, sizeof(upper));
+		for (j = 0; upper[j]; j++) upper[j] = toupper((unsigned char) upper[j]);
+		ptreq(lookup_monster(upper), race);
+	}
+
+	/* Fuzzy matches take the first race containing the name */
+	for (i = 0; i < z_info->r_max; i++) {
+		if (r_info[i].name && my_stristr(r_info[i].name, "urchin")) break;
+	}
+	require(i < z_info->r_max);
+	ptreq(lookup_monster("URCHIN"), &r_info[i]);
+	null(lookup_monster("no such monster anywhere"));
+	ok;
+}
+
+/* Every terrain is found by name */
+static int test_terrain(void *state) {
+	int i;
+
+	for (i = 0; i < FEAT_MAX; i++) {
+		if (!f_info[i].name) continue;
+		eq(lookup_feat(f_info[i].name), i);
+	}
+	ok;
+}
+
+const char *suite_name = "object/lookup";
+struct test tests[] = {
+	{ "kinds", test_kinds },
+	{ "egos", test_egos },
+	{ "monsters", test_monsters },
+	{ "terrain", test_terrain },
+	{ NULL, NULL }
+};
@@ -0,0 +1,109 @@
+/* object/pool */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "object.h"
+#include "obj-pile.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Objects come back zeroed, and a freed one is the next handed out */
+static int test_reuse(void *state) {
+	const struct object_pool_counts *counts = object_pool_counts();
+	uint64_t made = counts->made, freed = counts->freed;
+	uint32_t live = counts->live;
+	struct object *obj = object_new();
+	struct object *again;
+
+	eq(counts->made, made + 1);
+	eq(counts->live, live + 1);
+	require(counts->peak >= counts->live);
+
+	obj->number = 5;
+	obj->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
+	object_free(obj);
+	eq(counts->freed, freed + 1);
+	eq(counts->live, live);
+
+	again = object_new();
+	ptreq(again, obj);
+	eq(again->number, 0);
+	null(again->brands);
+	object_free(again);
+	ok;
+}
+
+/* Slabs are only added when every object already made is out */
+static int test_slabs(void *state) {
+	const struct object_pool_counts *counts = object_pool_counts();
+	uint32_t slabs = counts->slabs;
+	struct object *pile = NULL;
+	int n = 0, i;
+
+	while (counts->slabs == slabs && n < 10000) {
+		struct object *obj = object_new();
+
+		obj->next = pile;
+		pile = obj;
+		n++;
+	}
+	eq(counts->slabs, slabs + 1);
+	object_pile_free(NULL, NULL, pile);
+
+	pile = NULL;
+	for (i = 0; i < n; i++) {
+		struct object *obj = object_new();
+
+		obj->next = pile;
+		pile = obj;
+	}
+	eq(counts->slabs, slabs + 1);
+	object_pile_free(NULL, NULL, pile);
+	ok;
+}
+
+/* Freeing a chunk gives back its floor piles and orphans all at once */
+static int test_chunk(void *state) {
+	const struct object_pool_counts *counts = object_pool_counts();
+	uint32_t live = counts->live;
+	uint64_t freed = counts->freed;
+	struct chunk *c = cave_new(5, 5);
+	struct object *pile = NULL, *orphan, *obj;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		obj = object_new();
+		obj->grid = loc(2, 2);
+		pile_insert(&pile, obj);
+		list_object(c, obj);
+	}
+	square_set_obj(c, loc(2, 2), pile);
+	orphan = object_new();
+	list_object(c, orphan);
+	eq(counts->live, live + 4);
+
+	cave_free(c);
+	eq(counts->live, live);
+	eq(counts->freed, freed + 4);
+	ok;
+}
+
+const char *suite_name = "object/pool";
+struct test tests[] = {
+	{ "reuse", test_reuse },
+	{ "slabs", test_slabs },
+	{ "chunk", test_chunk },
+	{ NULL, NULL }
+};
@@ -1,7 +1,10 @@
 TESTPROGS += \
 	object/alloc \
 	object/attack \
+	object/index \
 	object/info \
+	object/lookup \
 	object/pile \
+	object/pool \
 	object/slays \
 	object/util
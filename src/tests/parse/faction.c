@@ -0,0 +1,78 @@
+/* parse/faction */
+/* Exercise parsing used for faction.txt. */
+
+#include "unit-test.h"
+#include "datafile.h"
+#include "init.h"
+#include "monster.h"
+#include "mon-move.h"
+#include "player.h"
+
+int setup_tests(void **state) {
+	*state = faction_parser.init();
+	return !*state;
+}
+
+int teardown_tests(void *state) {
+	faction_parser.cleanup();
+	return 0;
+}
+
+static int test_missing_record_header(void *state) {
+	struct parser *p = (struct parser*) state;
+	enum parser_error r = parser_parse(p, "enemy:f");
+
+	eq(r, PARSE_ERROR_MISSING_RECORD_HEADER);
+	ok;
+}
+
+static int test_faction_bad0(void *state) {
+	struct parser *p = (struct parser*) state;
+	enum parser_error r = parser_parse(p, "faction:@");
+
+	eq(r, PARSE_ERROR_INVALID_VALUE);
+	ok;
+}
+
+static int test_enemy0(void *state) {
+	struct parser *p = (struct parser*) state;
+	enum parser_error r = parser_parse(p, "faction:C");
+
+	eq(r, PARSE_ERROR_NONE);
+	r = parser_parse(p, "enemy:f");
+	eq(r, PARSE_ERROR_NONE);
+	r = parser_parse(p, "enemy:@");
+	eq(r, PARSE_ERROR_INVALID_VALUE);
+	ok;
+}
+
+static int test_complete0(void *state) {
+	struct parser *p = (struct parser*) state;
+
+	eq(faction_parser.finish(p), 0);
+
+	/* Hostility goes both ways */
+	require(factions_hostile('C', 'f'));
+	require(factions_hostile('f', 'C'));
+	require(!factions_hostile('C', 'C'));
+	require(!factions_hostile('C', 'A'));
+
+	/* The player's allies fight everything but each other */
+	require(factions_hostile('@', 'C'));
+	require(factions_hostile('A', '@'));
+	require(!factions_hostile('@', '@'));
+	ok;
+}
+
+const char *suite_name = "parse/faction";
+/*
+ * test_missing_record_header() has to be first and test_complete0() has to
+ * be last.
+ */
+struct test tests[] = {
+	{ "missing_record_header", test_missing_record_header },
+	{ "faction_bad0", test_faction_bad0 },
+	{ "enemy0", test_enemy0 },
+	{ "complete0", test_complete0 },
+	{ NULL, NULL }
+};
@@ -0,0 +1,178 @@
+/* parse/gamedata
+ *
+ * Parse all of the game data files, from the text and from snapshots, and
+ * time both
+ */
+
+#include "unit-test.h"
+#include "datafile.h"
+#include "init.h"
+#include "monster.h"
+#include "obj-util.h"
+#include "object.h"
+#include "test-utils.h"
+#include <time.h>
+#include <unistd.h>
+
+#define PARSE_RUNS 5
+
+/* The snapshots are made in a cache directory of their own */
+static char cache_dir[1024];
+
+/* Count the snapshots in the cache directory */
+static int count_snapshots(void) {
+	char name[1024];
+	ang_dir *dir = my_dopen(cache_dir);
+	int n = 0;
+
+	if (!dir) return 0;
+	while (my_dread(dir, name, sizeof(name))) {
+		if (suffix(name, ".snap")) n++;
+	}
+	my_dclose(dir);
+	return n;
+}
+
+/* Remove the snapshots and the directory holding them */
+static void remove_cache_dir(void) {
+	char name[1024], path[1024];
+	ang_dir *dir = my_dopen(cache_dir);
+
+	if (dir) {
+		while (my_dread(dir, name, sizeof(name))) {
+			path_build(path, sizeof(path), cache_dir, name);
+			file_delete(path);
+		}
+		my_dclose(dir);
+	}
+	rmdir(cache_dir);
+}
+
+int setup_tests(void **state) {
+	char tmp[1024];
+	const char *base = getenv("TMPDIR");
+
+	path_build(tmp, sizeof(tmp), base && *base ? base : "/tmp",
+		"angband-test-XXXXXX");
+	if (!mkdtemp(tmp)) return 1;
+	my_strcpy(cache_dir, tmp, sizeof(cache_dir));
+
+	set_file_paths();
+	string_free(ANGBAND_DIR_CACHE);
+	ANGBAND_DIR_CACHE = string_make(cache_dir);
+	play_again = true;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	play_again = false;
+	parse_snapshots = false;
+	init_angband();
+	cleanup_angband();
+	remove_cache_dir();
+	return 0;
+}
+
+/* Hash of the names and some numbers from the main tables */
+static uint32_t summarise(void) {
+	uint32_t sum = 5381;
+	int i;
+
+	for (i = 0; i < z_info->k_max; i++) {
+		if (!k_info[i].name) continue;
+		sum = sum * 33 + djb2_hash(k_info[i].name);
+		sum = sum * 33 + k_info[i].level + k_info[i].cost;
+	}
+	for (i = 0; i < z_info->r_max; i++) {
+		if (!r_info[i].name) continue;
+		sum = sum * 33 + djb2_hash(r_info[i].name);
+		sum = sum * 33 + r_info[i].avg_hp + r_info[i].level;
+	}
+	for (i = 0; i < z_info->a_max; i++) {
+		if (!a_info[i].name) continue;
+		sum = sum * 33 + djb2_hash(a_info[i].name);
+	}
+	for (i = 0; i < z_info->e_max; i++) {
+		if (!e_info[i].name) continue;
+		sum = sum * 33 + djb2_hash(e_info[i].name);
+	}
+
+	return sum;
+}
+
+/*
+ * Startup gives the same tables whether it reads the text or snapshots, and
+ * the second startup really does use the snapshots the first one made
+ */
+static int test_snapshots(void *state) {
+	const struct parse_snapshot_counts *counts = parse_snapshot_counts();
+	uint32_t text, snapshot, made, replayed;
+	int files;
+
+	parse_snapshots = false;
+	init_angband();
+	text = summarise();
+	cleanup_angband();
+	eq(count_snapshots(), 0);
+
+	/* Once to make the snapshots */
+	parse_snapshots = true;
+	made = counts->made;
+	replayed = counts->replayed;
+	init_angband();
+	eq(summarise(), text);
+	cleanup_angband();
+	files = count_snapshots();
+	require(files > 0);
+	eq(counts->made - made, (uint32_t)files);
+	eq(counts->replayed, replayed);
+
+	/* Once to use them */
+	made = counts->made;
+	init_angband();
+	snapshot = summarise();
+	cleanup_angband();
+	eq(counts->made, made);
+	eq(counts->replayed - replayed, (uint32_t)files);
+
+	eq(snapshot, text);
+	ok;
+}
+
+/*
+ * Time starting up from the text and from snapshots; the timings are only
+ * shown when running verbosely
+ */
+static int test_benchmark(void *state) {
+	clock_t t0, t1, t2;
+	int i;
+
+	parse_snapshots = false;
+	t0 = clock();
+	for (i = 0; i < PARSE_RUNS; i++) {
+		init_angband();
+		cleanup_angband();
+	}
+	t1 = clock();
+	parse_snapshots = true;
+	for (i = 0; i < PARSE_RUNS; i++) {
+		init_angband();
+		cleanup_angband();
+	}
+	t2 = clock();
+
+	if (verbose) {
+		printf("\n    text %.1fms, snapshots %.1fms per startup  ",
+			1000.0 * (t1 - t0) / CLOCKS_PER_SEC / PARSE_RUNS,
+			1000.0 * (t2 - t1) / CLOCKS_PER_SEC / PARSE_RUNS);
+	}
+	ok;
+}
+
+const char *suite_name = "parse/gamedata";
+struct test tests[] = {
+	{ "snapshots", test_snapshots },
+	{ "benchmark", test_benchmark },
+	{ NULL, NULL }
+};
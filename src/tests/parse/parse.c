@@ -516,6 +516,152 @@ static int test_char1(void *state) {
 	ok;
 }
 
+static enum parser_error helper_dump(struct parser *p) {
+	char *out = parser_priv(p);
+	char buf[256];
+	struct random r;
+
+	if (parser_hasval(p, "i")) {
+		strnfmt(buf, sizeof(buf), "i%d", parser_getint(p, "i"));
+		my_strcat(out, buf, 1024);
+	}
+	if (parser_hasval(p, "s")) {
+		strnfmt(buf, sizeof(buf), "s%s", parser_getsym(p, "s"));
+		my_strcat(out, buf, 1024);
+	}
+	if (parser_hasval(p, "r")) {
+		r = parser_getrand(p, "r");
+		strnfmt(buf, sizeof(buf), "r%d+%dd%dM%d", r.base, r.dice, r.sides,
+			r.m_bonus);
+		my_strcat(out, buf, 1024);
+	}
+	if (parser_hasval(p, "t")) {
+		strnfmt(buf, sizeof(buf), "t%s", parser_getstr(p, "t"));
+		my_strcat(out, buf, 1024);
+	}
+	if (parser_hasval(p, "c")) {
+		strnfmt(buf, sizeof(buf), "c%d", (int)parser_getchar(p, "c"));
+		my_strcat(out, buf, 1024);
+	}
+	if (parser_hasval(p, "u")) {
+		strnfmt(buf, sizeof(buf), "u%u", parser_getuint(p, "u"));
+		my_strcat(out, buf, 1024);
+	}
+	my_strcat(out, ";", 1024);
+	return streq(buf, "i-1") ? PARSE_ERROR_INVALID_VALUE : PARSE_ERROR_NONE;
+}
+
+static struct parser *replay_parser(char *out) {
+	struct parser *p = parser_new();
+
+	parser_reg(p, "a int i ?sym s", helper_dump);
+	parser_reg(p, "b rand r str t", helper_dump);
+	parser_reg(p, "c char c uint u", helper_dump);
+	parser_setpriv(p, out);
+	out[0] = '\0';
+	return p;
+}
+
+static int test_replay(void *state) {
+	const char *lines[] = {
+		"a:3", "# comment", "a:-7:foo", "", "b:2d6M1:some: text",
+		"c:x:12", "a:-1"
+	};
+	char text[1024], replayed[1024];
+	struct parser *p = replay_parser(text), *q = replay_parser(replayed);
+	struct parser_state st;
+	const char *data;
+	size_t len, i;
+	unsigned int nlines;
+
+	eq(parser_signature(p), parser_signature(q));
+	parser_record_start(p);
+	for (i = 0; i < N_ELEMENTS(lines) - 1; i++) {
+		eq(parser_parse(p, lines[i]), PARSE_ERROR_NONE);
+	}
+	data = parser_recorded(p, &len, &nlines);
+	eq(nlines, N_ELEMENTS(lines) - 1);
+
+	/* The same hooks see the same values, and the line count carries on */
+	eq(parser_replay(q, data, len, nlines), PARSE_ERROR_NONE);
+	require(streq(text, replayed));
+	require(streq(text, "i3;i-7sfoo;r0+2d6M1tsome: text;c120u12;"));
+	eq(parser_parse(q, lines[N_ELEMENTS(lines) - 1]),
+		PARSE_ERROR_INVALID_VALUE);
+	parser_getstate(q, &st);
+	eq(st.line, N_ELEMENTS(lines));
+
+	/* Lines that fail are not recorded, but still count */
+	eq(parser_parse(p, lines[N_ELEMENTS(lines) - 1]),
+		PARSE_ERROR_INVALID_VALUE);
+	parser_record_stop(p);
+	parser_record_start(p);
+	eq(parser_parse(p, "a:5"), PARSE_ERROR_NONE);
+	eq(parser_parse(p, "a:-1"), PARSE_ERROR_INVALID_VALUE);
+	eq(parser_parse(p, "a:6"), PARSE_ERROR_NONE);
+	data = parser_recorded(p, &len, &nlines);
+	eq(nlines, 3);
+	parser_destroy(q);
+	q = replay_parser(replayed);
+	eq(parser_parse(q, "a:1"), PARSE_ERROR_NONE);
+	eq(parser_replay(q, data, len, nlines), PARSE_ERROR_NONE);
+	require(streq(replayed, "i1;i5;i6;"));
+
+	/* Different hooks, different signature */
+	parser_reg(q, "d int i", helper_dump);
+	require(parser_signature(p) != parser_signature(q));
+
+	parser_destroy(p);
+	parser_destroy(q);
+	ok;
+}
+
+static enum parser_error helper_names(struct parser *p) {
+	char name[8];
+	int *sum = parser_priv(p);
+	int i;
+
+	/* The same buffer asks for different fields */
+	for (i = 0; i < 3; i++) {
+		strnfmt(name, sizeof(name), "n%d", i);
+		if (parser_hasval(p, name))
+			*sum = *sum * 10 + parser_getint(p, name);
+	}
+	return PARSE_ERROR_NONE;
+}
+
+static int test_names(void *state) {
+	int sum = 0;
+	errr r = parser_reg(state, "test-names int n0 int n1 ?int n2",
+		helper_names);
+	eq(r, 0);
+	parser_setpriv(state, &sum);
+	eq(parser_parse(state, "test-names:1:2:3"), PARSE_ERROR_NONE);
+	eq(sum, 123);
+	sum = 0;
+	eq(parser_parse(state, "test-names:4:5"), PARSE_ERROR_NONE);
+	eq(sum, 45);
+	ok;
+}
+
+static enum parser_error helper_supersede(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = parser_hasval(p, "b") ? 2 : 1;
+	return PARSE_ERROR_NONE;
+}
+
+static int test_supersede(void *state) {
+	int which = 0;
+
+	/* The latest hook for a directive is the one that runs */
+	eq(parser_reg(state, "test-dup int a", helper_supersede), 0);
+	eq(parser_reg(state, "test-dup sym b", helper_supersede), 0);
+	parser_setpriv(state, &which);
+	eq(parser_parse(state, "test-dup:x"), PARSE_ERROR_NONE);
+	eq(which, 2);
+	ok;
+}
+
 const char *suite_name = "parse/parser";
 struct test tests[] = {
 	{ "priv", test_priv },
@@ -560,5 +706,8 @@ struct test tests[] = {
 
 	{ "baddir", test_baddir },
 
+	{ "names", test_names },
+	{ "supersede", test_supersede },
+	{ "replay", test_replay },
 	{ NULL, NULL }
 };
@@ -6,8 +6,10 @@ TESTPROGS += parse/a-info \
 	parse/curse \
 	parse/c-info \
 	parse/e-info \
+	parse/faction \
 	parse/f-info \
 	parse/flavor \
+	parse/gamedata \
 	parse/graphics \
 	parse/h-info \
 	parse/hints \
@@ -9,6 +9,7 @@
 #include "h-basic.h"
 #include "cave.h"
 #include "config.h"
+#include "datafile.h"
 #include "init.h"
 #include "mon-make.h"
 #include "mon-util.h"
@@ -42,7 +43,8 @@ errr init_sound_win(struct sound_hooks *hooks, int argc, char **argv)
  * or similar.
  */
 void set_file_paths(void) {
-	char configpath[512], libpath[512], datapath[512];
+	char configpath[512], libpath[512], datapath[512], cachepath[1024];
+	const char *base;
 
 	/*
 	 * Allow TEST_DEFAULT_PATH to set all the paths for init_file_paths()
@@ -73,6 +75,18 @@ void set_file_paths(void) {
 		my_strcat(datapath, PATH_SEP, sizeof(datapath));
 
 	init_file_paths(configpath, libpath, datapath);
+
+	/*
+	 * L: Tests share snapshots of the data files, so that each starts up
+	 * quicker, but keep them in the temporary directory rather than the
+	 * user directory
+	 */
+	base = getenv("TMPDIR");
+	path_build(cachepath, sizeof(cachepath), base && *base ? base : "/tmp",
+		"angband-test-cache");
+	string_free(ANGBAND_DIR_CACHE);
+	ANGBAND_DIR_CACHE = string_make(cachepath);
+	parse_snapshots = true;
 }
 
 /*
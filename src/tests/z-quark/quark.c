@@ -1,7 +1,9 @@
 /* z-quark/quark.c */
 
 #include "unit-test.h"
+#include "z-form.h"
 #include "z-quark.h"
+#include "z-util.h"
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +48,52 @@ static int test_dedup(void *state) {
 	ok;
 }
 
+static int test_find(void *state) {
+	quark_t q1 = quark_add("2-foo");
+
+	require(quark_find("2-foo") == q1);
+	require(quark_find("2-bar") == 0);
+
+	/* Looking doesn't add */
+	require(quark_find("2-bar") == 0);
+	require(quark_add("2-bar") != 0);
+	require(quark_find("2-bar") == quark_add("2-bar"));
+
+	ok;
+}
+
+static int test_many(void *state) {
+	char buf[32];
+	quark_t first = quark_add("3-0");
+	int i;
+
+	/* Quarks are numbered in the order they are first added */
+	for (i = 1; i < 50000; i++) {
+		strnfmt(buf, sizeof(buf), "3-%d", i);
+		require(quark_find(buf) == 0);
+		eq(quark_add(buf), first + i);
+	}
+
+	/* Every one is still found, and adding again changes nothing */
+	for (i = 0; i < 50000; i++) {
+		strnfmt(buf, sizeof(buf), "3-%d", i);
+		eq(quark_find(buf), first + i);
+		eq(quark_add(buf), first + i);
+		require(streq(quark_str(first + i), buf));
+	}
+
+	/* Earlier quarks survive the index growing */
+	require(quark_find("0-foo") != 0);
+	require(streq(quark_str(quark_find("1-foo")), "1-foo"));
+
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "find", test_find },
+	{ "many", test_many },
 	{ NULL, NULL }
 };
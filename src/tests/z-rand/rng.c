@@ -0,0 +1,103 @@
+/* z-rand/rng */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+static bool same_state(const struct rng *a, const struct rng *b)
+{
+	return a->quick == b->quick && a->value == b->value &&
+		a->state_i == b->state_i &&
+		!memcmp(a->state, b->state, sizeof(a->state));
+}
+
+/* Contexts seeded alike give the same stream, and leave the game's alone */
+static int test_streams(void *state)
+{
+	struct rng a, b, c;
+	struct rng saved = rng_default;
+	int i, same = 0;
+
+	rng_seed(&a, 1234);
+	rng_seed(&b, 1234);
+	rng_seed(&c, 4321);
+	for (i = 0; i < 1000; i++) {
+		uint32_t va = rng_div(&a, 1000), vc = rng_div(&c, 1000);
+
+		eq(va, rng_div(&b, 1000));
+		require(va < 1000);
+		if (va == vc) same++;
+	}
+	require(same < 50);
+	require(same_state(&saved, &rng_default));
+
+	rng_seed_quick(&a, 99);
+	rng_seed_quick(&b, 99);
+	for (i = 0; i < 1000; i++) {
+		eq(rng_range(&a, -5, 5), rng_range(&b, -5, 5));
+		eq(rng_normal(&a, 50, 10), rng_normal(&b, 50, 10));
+	}
+	ok;
+}
+
+/* The global functions draw from the default context */
+static int test_default(void *state)
+{
+	struct rng copy;
+	int i;
+
+	Rand_state_init(5678);
+	Rand_quick = false;
+	copy = rng_default;
+	for (i = 0; i < 100; i++) {
+		eq(randint0(77), rng_int0(&copy, 77));
+		eq(damroll(3, 6), rng_damroll(&copy, 3, 6));
+		eq(m_bonus(10, 40), rng_m_bonus(&copy, 10, 40));
+	}
+	require(same_state(&copy, &rng_default));
+	ok;
+}
+
+/* Bulk draws match single ones, and leave the same state behind */
+static int test_fill(void *state)
+{
+	struct rng a, b;
+	uint32_t buf[200];
+	int i, pass, sum;
+
+	for (pass = 0; pass < 2; pass++) {
+		if (pass) {
+			rng_seed_quick(&a, 42);
+		} else {
+			rng_seed(&a, 42);
+		}
+		b = a;
+
+		rng_fill_div(&a, 13, buf, N_ELEMENTS(buf));
+		for (i = 0; i < (int)N_ELEMENTS(buf); i++) {
+			eq(buf[i], rng_div(&b, 13));
+		}
+		require(same_state(&a, &b));
+
+		sum = 0;
+		for (i = 0; i < 150; i++) {
+			sum += rng_int1(&b, 8);
+		}
+		eq(rng_damroll(&a, 150, 8), sum);
+		require(same_state(&a, &b));
+	}
+
+	eq(rng_damroll(&a, 0, 8), 0);
+	eq(rng_damroll(&a, 3, 0), 0);
+	ok;
+}
+
+const char *suite_name = "z-rand/rng";
+struct test tests[] = {
+	{ "streams", test_streams },
+	{ "default", test_default },
+	{ "fill", test_fill },
+	{ NULL, NULL }
+};
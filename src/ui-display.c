@@ -2571,7 +2571,7 @@ static void new_level_display_update(game_event_type type,
 
 	/* If autosave is pending, do it now. */
 	if (player->upkeep->autosave) {
-		save_game();
+		autosave_game();
 		player->upkeep->autosave = false;
 	}
 
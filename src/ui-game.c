@@ -311,6 +311,7 @@ struct cmd_info cmd_debug_query[] =
 	{ "Square flag", { 'q' }, CMD_WIZ_QUERY_SQUARE_FLAG, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Noise and scent", { '_' }, CMD_WIZ_PEEK_NOISE_SCENT, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Keystroke log", { 'L' }, CMD_WIZ_DISPLAY_KEYLOG, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Stored level memory", { 'K' }, CMD_NULL, wiz_stored_level_memory, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 };
 
 struct cmd_info cmd_debug_misc[] =
@@ -998,11 +999,12 @@ void save_game(void)
 }
 
 /**
- * Save the game.
+ * Save the game, either writing the file out straight away or leaving it to
+ * be written in the background.
  *
- * \return whether the save was successful.
+ * \return whether the save was successful, or has not failed yet.
  */
-bool save_game_checked(void)
+static bool save_game_aux(bool background)
 {
 	char path[1024];
 	bool result;
@@ -1029,7 +1031,8 @@ bool save_game_checked(void)
 	signals_ignore_tstp();
 
 	/* Save the player */
-	if (savefile_save(savefile)) {
+	if (background ? savefile_save_background(savefile) :
+			savefile_save(savefile)) {
 		prt("Saving game... done.", 0, 0);
 		result = true;
 	} else {
@@ -1066,6 +1069,25 @@ bool save_game_checked(void)
 	return result;
 }
 
+/**
+ * Save the game.
+ *
+ * \return whether the save was successful.
+ */
+bool save_game_checked(void)
+{
+	return save_game_aux(false);
+}
+
+/**
+ * Save the game without waiting for the file to be written, as for the
+ * autosave on changing level.
+ */
+void autosave_game(void)
+{
+	(void) save_game_aux(true);
+}
+
 
 /**
  * Close up the current game (player may or may not be dead).
@@ -43,6 +43,7 @@
 #include "player-history.h"
 #include "player-util.h"
 #include "project.h"
+#include "savefile.h"
 #include "store.h"
 #include "target.h"
 #include "trap.h"
@@ -1501,6 +1502,7 @@ static struct object *find_artifact(struct artifact *artifact)
 		struct chunk *c = chunk_list[i];
 		int j;
 		if (strstr(c->name, "known")) continue;
+		if (!chunk_decode(c)) continue;
 
 		/* Ground objects */
 		for (y = 1; y < c->height; y++) {
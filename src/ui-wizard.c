@@ -18,8 +18,10 @@
  */
 
 #include "angband.h"
+#include "cave.h"
 #include "cmds.h"
 #include "game-input.h"
+#include "generate.h"
 #include "grafmode.h"
 #include "init.h"
 #include "obj-desc.h"
@@ -30,6 +32,7 @@
 #include "project.h"
 #include "ui-input.h"
 #include "ui-menu.h"
+#include "ui-output.h"
 #include "ui-prefs.h"
 #include "ui-wizard.h"
 
@@ -388,6 +391,47 @@ void wiz_confirm_quit_no_save(void)
 }
 
 
+/**
+ * L: Show how much memory each stored level holds, and what packing the
+ * packed ones saved.
+ */
+void wiz_stored_level_memory(void)
+{
+	textblock *tb = textblock_new();
+	region local_area = { 0, 0, 0, 0 };
+	size_t total = 0, unpacked = 0;
+	int i, packed = 0;
+
+	textblock_append(tb, "%-30s %10s %10s\n", "Level", "Bytes", "Unpacked");
+	for (i = 0; i < chunk_list_max; i++) {
+		const struct chunk *c = chunk_list[i];
+		size_t size = chunk_memory(c);
+
+		total += size;
+		if (c->encoded && c->full_size) {
+			textblock_append(tb, "%-30s %10lu %10lu\n", c->name,
+				(unsigned long) size, (unsigned long) c->full_size);
+			unpacked += c->full_size;
+		} else {
+			textblock_append(tb, "%-30s %10lu %10s\n", c->name,
+				(unsigned long) size, c->encoded ? "?" : "-");
+			unpacked += size;
+		}
+		if (c->encoded) packed++;
+	}
+	textblock_append(tb, "\n%d of %d stored levels packed, holding %lu bytes",
+		packed, chunk_list_max, (unsigned long) total);
+	if (unpacked > total) {
+		textblock_append(tb, " (%lu saved)",
+			(unsigned long) (unpacked - total));
+	}
+	textblock_append(tb, "\n");
+
+	textui_textblock_show(tb, local_area, "Stored level memory");
+	textblock_free(tb);
+}
+
+
 /**
  * Shim for ui-game.c to call wiz_create_item(true).
  */
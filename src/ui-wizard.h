@@ -15,6 +15,7 @@ void wiz_create_nonartifact(void);
 void wiz_learn_all_object_kinds(void);
 void wiz_phase_door(void);
 void wiz_proj_demo(void);
+void wiz_stored_level_memory(void);
 void wiz_teleport(void);
 
 #endif /* INCLUDED_UI_WIZARD_H */
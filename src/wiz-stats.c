@@ -33,6 +33,7 @@
 #include "mon-make.h"
 #include "mon-predicate.h"
 #include "monster.h"
+#include "obj-index.h"
 #include "obj-init.h"
 #include "obj-pile.h"
 #include "obj-randart.h"
@@ -1405,20 +1406,18 @@ static void post_process_stats(void)
  */
 static void scan_for_objects(void)
 { 
-	int y, x;
+	struct loc grid = loc(0, 0);
 
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			struct object *obj;
+	/* L: the object index skips the empty parts of the level */
+	while (obj_index_find_pile(cave, &grid)) {
+		struct object *obj;
 
-			while ((obj = square_object(cave, grid))) {
-				/* Get data on the object */
-				get_obj_data(obj, y, x, false, false);
+		while ((obj = square_object(cave, grid))) {
+			/* Get data on the object */
+			get_obj_data(obj, grid.y, grid.x, false, false);
 
-				/* Delete the object */
-				square_delete_object(cave, grid, obj, false, false);
-			}
+			/* Delete the object */
+			square_delete_object(cave, grid, obj, false, false);
 		}
 	}
 }
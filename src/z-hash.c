@@ -0,0 +1,135 @@
+/**
+ * \file z-hash.c
+ * \brief Open-addressing indices from hashed keys to array positions
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#include "z-hash.h"
+#include "z-virt.h"
+
+#define HASH_INDEX_INIT	64
+
+/**
+ * Put a value in the first empty slot of its probe sequence
+ */
+static void hash_index_place(struct hash_index *h, uint32_t hash, int value)
+{
+	size_t mask = h->size - 1;
+	size_t i = hash & mask;
+
+	while (h->values[i] >= 0) {
+		i = (i + 1) & mask;
+	}
+	h->hashes[i] = hash;
+	h->values[i] = value;
+}
+
+/**
+ * Resize an index and re-insert everything in it
+ */
+static void hash_index_resize(struct hash_index *h, size_t size)
+{
+	uint32_t *hashes = h->hashes;
+	int *values = h->values;
+	size_t old = h->size, i;
+
+	h->size = size;
+	h->hashes = mem_zalloc(size * sizeof(uint32_t));
+	h->values = mem_alloc(size * sizeof(int));
+	for (i = 0; i < size; i++) {
+		h->values[i] = -1;
+	}
+	for (i = 0; i < old; i++) {
+		if (values[i] >= 0) {
+			hash_index_place(h, hashes[i], values[i]);
+		}
+	}
+	mem_free(hashes);
+	mem_free(values);
+}
+
+/**
+ * Free the contents of an index, leaving it empty
+ */
+void hash_index_free(struct hash_index *h)
+{
+	mem_free(h->hashes);
+	mem_free(h->values);
+	memset(h, 0, sizeof(*h));
+}
+
+/**
+ * Add an array position to an index under the given key hash
+ */
+void hash_index_add(struct hash_index *h, uint32_t hash, int value)
+{
+	assert(value >= 0);
+
+	/* Keep the index no more than half full */
+	if (2 * (h->count + 1) > h->size) {
+		hash_index_resize(h, h->size ? 2 * h->size : HASH_INDEX_INIT);
+	}
+	hash_index_place(h, hash, value);
+	h->count++;
+}
+
+/**
+ * Get the next array position stored under a key hash, or -1 if there are
+ * no more.  probe should start at zero, and is advanced past each position
+ * returned.  Positions are not returned in any particular order.
+ */
+int hash_index_next(const struct hash_index *h, uint32_t hash, size_t *probe)
+{
+	size_t mask = h->size - 1;
+
+	if (!h->size) return -1;
+	while (*probe < h->size) {
+		size_t i = (hash + *probe) & mask;
+
+		(*probe)++;
+		if (h->values[i] < 0) break;
+		if (h->hashes[i] == hash) return h->values[i];
+	}
+
+	return -1;
+}
+
+/**
+ * Scramble an integer key, so that all its bits reach the low ones the
+ * index uses to pick a slot
+ */
+uint32_t hash_u32(uint32_t n)
+{
+	n ^= n >> 16;
+	n *= 0x7feb352dU;
+	n ^= n >> 15;
+	n *= 0x846ca68bU;
+	n ^= n >> 16;
+	return n;
+}
+
+/**
+ * Hash a string ignoring case, consistently with my_stricmp()
+ */
+uint32_t hash_nocase(const char *str)
+{
+	uint32_t hash = 5381;
+
+	while (*str) {
+		hash = ((hash << 5) + hash) + toupper((unsigned char) *str);
+		str++;
+	}
+
+	return hash_u32(hash);
+}
@@ -0,0 +1,43 @@
+/**
+ * \file z-hash.h
+ * \brief Open-addressing indices from hashed keys to array positions
+ *
+ * Copyright (c) 2026 Lowband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_HASH_H
+#define INCLUDED_Z_HASH_H
+
+#include "h-basic.h"
+
+/**
+ * Maps key hashes to positions in some array.  The index only stores the
+ * hashes, so several keys may share one; callers check each position they
+ * get back against the key they were looking for.
+ */
+struct hash_index {
+	uint32_t *hashes;	/**< Key hash per slot */
+	int *values;		/**< Array position per slot, or -1 if empty */
+	size_t size;		/**< Number of slots, zero or a power of two */
+	size_t count;		/**< Number of slots in use */
+};
+
+void hash_index_free(struct hash_index *h);
+void hash_index_add(struct hash_index *h, uint32_t hash, int value);
+int hash_index_next(const struct hash_index *h, uint32_t hash, size_t *probe);
+
+uint32_t hash_u32(uint32_t n);
+uint32_t hash_nocase(const char *str);
+
+#endif /* INCLUDED_Z_HASH_H */
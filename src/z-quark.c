@@ -17,6 +17,7 @@
  *    and not for profit purposes provided that this copyright and statement
  *    are included in all such copies.  Other copyrights may also apply.
  */
+#include "z-hash.h"
 #include "z-util.h"
 #include "z-virt.h"
 #include "z-quark.h"
@@ -26,17 +27,34 @@ static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Index of the quarks by the djb2_hash() of their strings
+ */
+static struct hash_index quark_index;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+quark_t quark_find(const char *str)
 {
-	quark_t q;
+	uint32_t hash = djb2_hash(str);
+	size_t probe = 0;
+	int q;
 
-	for (q = 1; q < nr_quarks; q++) {
+	while ((q = hash_index_next(&quark_index, hash, &probe)) >= 0) {
 		if (streq(quarks[q], str))
 			return q;
 	}
 
+	return 0;
+}
+
+quark_t quark_add(const char *str)
+{
+	quark_t q = quark_find(str);
+
+	if (q)
+		return q;
+
 	if (nr_quarks == alloc_quarks) {
 		alloc_quarks *= 2;
 		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
@@ -44,6 +62,7 @@ quark_t quark_add(const char *str)
 
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	hash_index_add(&quark_index, djb2_hash(str), q);
 
 	return q;
 }
@@ -69,6 +88,7 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	hash_index_free(&quark_index);
 }
 
 struct init_module z_quark_module = {
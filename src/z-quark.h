@@ -34,6 +34,11 @@ typedef size_t quark_t;
  */
 quark_t quark_add(const char *str);
 
+/**
+ * Return the quark for the string 'str' if there is one, or 0; never adds
+ */
+quark_t quark_find(const char *str);
+
 /**
  * Return the string corresponding to the quark
  */
@@ -36,6 +36,11 @@
  * "Rand_value = seed". After that it will be automatically used instead of
  * the "complex" RNG. When you are done, you can de-activate it via
  * "Rand_quick = false". You can also choose a new seed.
+ *
+ * L: All of that state lives in a struct rng.  The game's own state is
+ * rng_default, which the Rand_*() functions and the randint*() family use;
+ * the rng_*() functions take the context to draw from explicitly, so a
+ * seeded stream can be kept apart from the game's without touching it.
  */
 
 /* begin WELL RNG
@@ -53,29 +58,22 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-uint32_t state_i = 0;
-uint32_t STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
-uint32_t z0, z1, z2;
-
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static uint32_t WELLRNG1024a (void){
-	z0      = VRm1;
-	z1      = Identity(V0) ^ MAT0POS (8, VM1);
-	z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
-	newV1   = z1 ^ z2; 
-	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+#define V0    r->state[r->state_i]
+#define VM1   r->state[(r->state_i + M1) & 0x0000001fU]
+#define VM2   r->state[(r->state_i + M2) & 0x0000001fU]
+#define VM3   r->state[(r->state_i + M3) & 0x0000001fU]
+#define VRm1  r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV0 r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV1 r->state[r->state_i]
+
+static uint32_t WELLRNG1024a (struct rng *r){
+	r->z0      = VRm1;
+	r->z1      = Identity(V0) ^ MAT0POS (8, VM1);
+	r->z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
+	newV1      = r->z1 ^ r->z2;
+	newV0      = MAT0NEG (-11,r->z0) ^ MAT0NEG(-7,r->z1) ^ MAT0NEG(-13,r->z2);
+	r->state_i = (r->state_i + 31) & 0x0000001fU;
+	return r->state[r->state_i];
 }
 /* end WELL RNG */
 
@@ -86,45 +84,64 @@ static uint32_t WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
+ * The context used by the game, which starts out on the simple RNG
  */
-bool Rand_quick = true;
+struct rng rng_default = { .quick = true };
 
 /**
- * The current "seed" of the simple RNG.
+ * Initialize the complex RNG of a context using a new seed.
  */
-uint32_t Rand_value;
-
-static bool rand_fixed = false;
-static uint32_t rand_fixval = 0;
-
-/**
- * Initialize the complex RNG using a new seed.
- */
-void Rand_state_init(uint32_t seed)
+void rng_state_init(struct rng *r, uint32_t seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	r->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		r->state[i] = LCRNG(r->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (r->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		r->state[j] += r->state[r->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		r->state_i = j;
 	}
 }
 
+/**
+ * Set up a fresh context using the complex RNG
+ */
+void rng_seed(struct rng *r, uint32_t seed)
+{
+	memset(r, 0, sizeof(*r));
+	rng_state_init(r, seed);
+}
+
+/**
+ * Set up a fresh context using the simple RNG
+ */
+void rng_seed_quick(struct rng *r, uint32_t seed)
+{
+	memset(r, 0, sizeof(*r));
+	r->quick = true;
+	r->value = seed;
+}
+
+/**
+ * Initialize the complex RNG of the default context using a new seed.
+ */
+void Rand_state_init(uint32_t seed)
+{
+	rng_state_init(&rng_default, seed);
+}
+
 /**
  * Initialise the RNG
  */
@@ -165,9 +182,9 @@ void Rand_init(void)
  * This method has no bias, and is much less affected by patterns in the "low"
  * bits of the underlying RNG's. However, it is potentially non-terminating.
  */
-uint32_t Rand_div(uint32_t m)
+uint32_t rng_div(struct rng *r, uint32_t m)
 {
-	uint32_t n, r = 0;
+	uint32_t n, v = 0;
 
 	/* Division by zero will result if m is larger than 0x10000000 */
 	assert(m <= 0x10000000);
@@ -175,41 +192,109 @@ uint32_t Rand_div(uint32_t m)
 	/* Hack -- simple case */
 	if (m <= 1) return (0);
 
-	if (rand_fixed)
-		return (rand_fixval * 1000 * (m - 1)) / (100 * 1000);
+	if (r->fixed)
+		return (r->fixval * 1000 * (m - 1)) / (100 * 1000);
 
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
+	if (r->quick) {
 		/* Use a simple RNG */
 		/* Wait for it */
 		while (1) {
 			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
+			v = (r->value = LCRNG(r->value));
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	} else {
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			v = WELLRNG1024a(r);
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	}
 
 	/* Use the value */
-	return (r);
+	return (v);
+}
+
+uint32_t Rand_div(uint32_t m)
+{
+	return rng_div(&rng_default, m);
+}
+
+/**
+ * Draw many values from 0 to m - 1 at once.
+ *
+ * The values, and the state left behind, are exactly those of n calls to
+ * rng_div(); the checks and the partition size are just worked out once
+ * rather than for every value.
+ */
+void rng_fill_div(struct rng *r, uint32_t m, uint32_t *out, int n)
+{
+	uint32_t part, v;
+	int i;
+
+	assert(m <= 0x10000000);
+
+	if (m <= 1 || r->fixed) {
+		uint32_t fix = (m <= 1) ? 0 : rng_div(r, m);
+		for (i = 0; i < n; i++)
+			out[i] = fix;
+		return;
+	}
+
+	part = 0x10000000 / m;
+
+	if (r->quick) {
+		uint32_t value = r->value;
+		for (i = 0; i < n; i++) {
+			do {
+				value = LCRNG(value);
+				v = ((value >> 4) & 0x0FFFFFFF) / part;
+			} while (v >= m);
+			out[i] = v;
+		}
+		r->value = value;
+	} else {
+		for (i = 0; i < n; i++) {
+			do {
+				v = ((WELLRNG1024a(r) >> 4) & 0x0FFFFFFF) / part;
+			} while (v >= m);
+			out[i] = v;
+		}
+	}
+}
+
+/**
+ * Sum many values from 0 to m - 1, drawn as by rng_fill_div()
+ */
+uint32_t rng_sum_div(struct rng *r, uint32_t m, int n)
+{
+	uint32_t buf[64];
+	uint32_t sum = 0;
+
+	while (n > 0) {
+		int i, k = MIN(n, (int)N_ELEMENTS(buf));
+
+		rng_fill_div(r, m, buf, k);
+		for (i = 0; i < k; i++)
+			sum += buf[i];
+		n -= k;
+	}
+
+	return sum;
 }
 
 
@@ -284,7 +369,7 @@ static int16_t Rand_normal_table[RANDNOR_NUM] = {
  *
  * Note that the binary search takes up to 16 quick iterations.
  */
-int16_t Rand_normal(int mean, int stand)
+int16_t rng_normal(struct rng *r, int mean, int stand)
 {
 	int16_t tmp, offset;
 
@@ -295,7 +380,7 @@ int16_t Rand_normal(int mean, int stand)
 	if (stand < 1) return (mean);
 
 	/* Roll for probability */
-	tmp = (int16_t)randint0(32768);
+	tmp = (int16_t)rng_int0(r, 32768);
 
 	/* Binary Search */
 	while (low < high) {
@@ -313,12 +398,17 @@ int16_t Rand_normal(int mean, int stand)
 	offset = (int16_t)((long)stand * (long)low / RANDNOR_STD);
 
 	/* One half should be negative */
-	if (one_in_(2)) return (mean - offset);
+	if (rng_one_in(r, 2)) return (mean - offset);
 
 	/* One half should be positive */
 	return (mean + offset);
 }
 
+int16_t Rand_normal(int mean, int stand)
+{
+	return rng_normal(&rng_default, mean, stand);
+}
+
 
 /**
  * Choose an integer from a distribution where we know the mean and approximate
@@ -332,9 +422,10 @@ int16_t Rand_normal(int mean, int stand)
  * The function chooses an integer from a normal distribution, and then scales
  * it to fit the target distribution.
  */
-int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+int rng_sample(struct rng *r, int mean, int upper, int lower, int stand_u,
+		int stand_l)
 {
-	int pick = Rand_normal(0, 1000);
+	int pick = rng_normal(r, 0, 1000);
 
 	/* Scale to fit */
 	if (pick > 0) {
@@ -350,19 +441,24 @@ int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
 	return mean + pick;
 }
 
+int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+{
+	return rng_sample(&rng_default, mean, upper, lower, stand_u, stand_l);
+}
+
 /**
  * Generates damage for "2d6" style dice rolls
  */
-int damroll(int num, int sides)
+int rng_damroll(struct rng *r, int num, int sides)
 {
-	int i;
-	int sum = 0;
+	if (sides <= 0 || num <= 0) return 0;
 
-	if (sides <= 0) return 0;
+	return (int)rng_sum_div(r, sides, num) + num;
+}
 
-	for (i = 0; i < num; i++)
-		sum += randint1(sides);
-	return sum;
+int damroll(int num, int sides)
+{
+	return rng_damroll(&rng_default, num, sides);
 }
 
 
@@ -370,12 +466,12 @@ int damroll(int num, int sides)
 /**
  * Calculation helper function for damroll
  */
-int damcalc(int num, int sides, aspect dam_aspect)
+int rng_damcalc(struct rng *r, int num, int sides, aspect dam_aspect)
 {
 	switch (dam_aspect) {
 		case MAXIMISE:
 		case EXTREMIFY: return num * sides;
-		case RANDOMISE: return damroll(num, sides);
+		case RANDOMISE: return rng_damroll(r, num, sides);
 		case MINIMISE: return num;
 		case AVERAGE: return num * (sides + 1) / 2;
 	}
@@ -384,6 +480,11 @@ int damcalc(int num, int sides, aspect dam_aspect)
 	return 0;
 }
 
+int damcalc(int num, int sides, aspect dam_aspect)
+{
+	return rng_damcalc(&rng_default, num, sides, dam_aspect);
+}
+
 
 /**
  * Generates a random signed long integer X where `A` <= X <= `B`.
@@ -391,12 +492,17 @@ int damcalc(int num, int sides, aspect dam_aspect)
  *
  * Note that "rand_range(0, N-1)" == "randint0(N)".
  */
-int rand_range(int A, int B)
+int rng_range(struct rng *r, int A, int B)
 {
 	if (A == B) return A;
 	assert(A < B);
 
-	return A + (int32_t)Rand_div(1 + B - A);
+	return A + (int32_t)rng_div(r, 1 + B - A);
+}
+
+int rand_range(int A, int B)
+{
+	return rng_range(&rng_default, A, B);
 }
 
 
@@ -404,11 +510,11 @@ int rand_range(int A, int B)
  * Perform division, possibly rounding up or down depending on the size of the
  * remainder and chance.
  */
-static int simulate_division(int dividend, int divisor)
+static int simulate_division(struct rng *r, int dividend, int divisor)
 {
 	int quotient  = dividend / divisor;
 	int remainder = dividend % divisor;
-	if (randint0(divisor) < remainder) quotient++;
+	if (rng_int0(r, divisor) < remainder) quotient++;
 	return quotient;
 }
 
@@ -452,7 +558,7 @@ static int simulate_division(int dividend, int divisor)
  * 120    0.03  0.11  0.31  0.46  1.31  2.48  4.60  7.78 11.67 25.53 45.72
  * 128    0.02  0.01  0.13  0.33  0.83  1.41  3.24  6.17  9.57 14.22 64.07
  */
-int16_t m_bonus(int max, int level)
+int16_t rng_m_bonus(struct rng *r, int max, int level)
 {
 	int bonus, stand, value;
 
@@ -460,13 +566,13 @@ int16_t m_bonus(int max, int level)
 	if (level >= MAX_RAND_DEPTH) level = MAX_RAND_DEPTH - 1;
 
 	/* The bonus approaches max as level approaches MAX_RAND_DEPTH */
-	bonus = simulate_division(max * level, MAX_RAND_DEPTH);
+	bonus = simulate_division(r, max * level, MAX_RAND_DEPTH);
 
 	/* The standard deviation is 1/4 of the max */
-	stand = simulate_division(max, 4);
+	stand = simulate_division(r, max, 4);
 
 	/* Choose a value */
-	value = Rand_normal(bonus, stand);
+	value = rng_normal(r, bonus, stand);
 
 	/* Return, enforcing the min and max values */
 	if (value < 0)
@@ -477,16 +583,22 @@ int16_t m_bonus(int max, int level)
 		return value;
 }
 
+int16_t m_bonus(int max, int level)
+{
+	return rng_m_bonus(&rng_default, max, level);
+}
+
 
 /**
  * Calculation helper function for m_bonus
  */
-int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
+int16_t rng_m_bonus_calc(struct rng *r, int max, int level,
+		aspect bonus_aspect)
 {
 	switch (bonus_aspect) {
 		case EXTREMIFY:
 		case MAXIMISE:  return max;
-		case RANDOMISE: return m_bonus(max, level);
+		case RANDOMISE: return rng_m_bonus(r, max, level);
 		case MINIMISE:  return 0;
 		case AVERAGE:   return max * level / MAX_RAND_DEPTH;
 	}
@@ -495,24 +607,34 @@ int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
 	return 0;
 }
 
+int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
+{
+	return rng_m_bonus_calc(&rng_default, max, level, bonus_aspect);
+}
+
 
 /**
  * Calculation helper function for random_value structs
  */
-int randcalc(random_value v, int level, aspect rand_aspect)
+int rng_randcalc(struct rng *r, random_value v, int level, aspect rand_aspect)
 {
 	if (rand_aspect == EXTREMIFY) {
-		int min = randcalc(v, level, MINIMISE);
-		int max = randcalc(v, level, MAXIMISE);
+		int min = rng_randcalc(r, v, level, MINIMISE);
+		int max = rng_randcalc(r, v, level, MAXIMISE);
 		return abs(min) > abs(max) ? min : max;
 
 	} else {
-		int dmg   = damcalc(v.dice, v.sides, rand_aspect);
-		int bonus = m_bonus_calc(v.m_bonus, level, rand_aspect);
+		int dmg   = rng_damcalc(r, v.dice, v.sides, rand_aspect);
+		int bonus = rng_m_bonus_calc(r, v.m_bonus, level, rand_aspect);
 		return v.base + dmg + bonus;
 	}
 }
 
+int randcalc(random_value v, int level, aspect rand_aspect)
+{
+	return rng_randcalc(&rng_default, v, level, rand_aspect);
+}
+
 
 /**
  * Test to see if a value is within a random_value's range
@@ -540,10 +662,15 @@ bool randcalc_varies(random_value v)
  *
  * \param c The random_chance to roll on
  */
-bool random_chance_check(random_chance c)
+bool rng_chance_check(struct rng *r, random_chance c)
 {
 	/* Calculated so that high rolls pass the check */
-	return randint0(c.denominator) >= c.denominator - c.numerator;
+	return rng_int0(r, c.denominator) >= c.denominator - c.numerator;
+}
+
+bool random_chance_check(random_chance c)
+{
+	return rng_chance_check(&rng_default, c);
 }
 
 /**
@@ -568,8 +695,8 @@ int random_chance_scaled(random_chance c, int scale)
  */
 void rand_fix(uint32_t val)
 {
-	rand_fixed = true;
-	rand_fixval = val;
+	rng_default.fixed = true;
+	rng_default.fixval = val;
 }
 
 /**
@@ -69,6 +69,28 @@ typedef enum {
 } aspect;
 
 
+/**
+ * L: A random number generator context.  Everything that draws random numbers
+ * for the game uses the default context, rng_default, through the Rand_*()
+ * functions and the macros below.  Code which needs its own reproducible
+ * stream, or which runs alongside the game, can keep a context of its own and
+ * use the rng_*() functions on it instead.
+ */
+struct rng {
+	bool quick;					/**< Use the simple RNG, not the complex one */
+	uint32_t value;				/**< State of the simple RNG */
+	uint32_t state_i;			/**< Index into the complex RNG's state */
+	uint32_t state[RAND_DEG];	/**< State of the complex RNG */
+	uint32_t z0, z1, z2;		/**< Last complex RNG intermediates */
+	bool fixed;					/**< Return rand_fix() values instead */
+	uint32_t fixval;			/**< Percentage given to rand_fix() */
+};
+
+/**
+ * The context used by the game
+ */
+extern struct rng rng_default;
+
 /**
  * Generates a random signed long integer X where "0 <= X < M" holds.
  *
@@ -98,24 +120,63 @@ typedef enum {
 #define one_in_(x) (!randint0(x))
 
 /**
- * Whether we are currently using the "quick" method or not.
+ * As randint0(), randint1() and one_in_(), but drawing from the context `R`
+ */
+#define rng_int0(R, M) ((int32_t) rng_div(R, M))
+#define rng_int1(R, M) ((int32_t) rng_div(R, M) + 1)
+#define rng_one_in(R, x) (!rng_div(R, x))
+
+/**
+ * Whether the default context is currently using the "quick" method or not.
+ */
+#define Rand_quick (rng_default.quick)
+
+/**
+ * The state used by the default context's "quick" RNG.
  */
-extern bool Rand_quick;
+#define Rand_value (rng_default.value)
+
+
+/**
+ * Set up a context with the complex RNG seeded from `seed`.
+ */
+void rng_seed(struct rng *r, uint32_t seed);
+
+/**
+ * Set up a context with the simple RNG seeded from `seed`.
+ */
+void rng_seed_quick(struct rng *r, uint32_t seed);
+
+/**
+ * Reseed the complex RNG of a context, keeping its state index.
+ */
+void rng_state_init(struct rng *r, uint32_t seed);
 
 /**
- * The state used by the "quick" RNG.
+ * Context versions of the functions below; see those for details.
  */
-extern uint32_t Rand_value;
+uint32_t rng_div(struct rng *r, uint32_t m);
+int16_t rng_normal(struct rng *r, int mean, int stand);
+int rng_sample(struct rng *r, int mean, int upper, int lower, int stand_u,
+		int stand_l);
+int rng_damroll(struct rng *r, int num, int sides);
+int rng_damcalc(struct rng *r, int num, int sides, aspect dam_aspect);
+int rng_range(struct rng *r, int A, int B);
+int16_t rng_m_bonus(struct rng *r, int max, int level);
+int16_t rng_m_bonus_calc(struct rng *r, int max, int level,
+		aspect bonus_aspect);
+int rng_randcalc(struct rng *r, random_value v, int level, aspect rand_aspect);
+bool rng_chance_check(struct rng *r, random_chance c);
 
 /**
- * The state used by the "complex" RNG.
+ * Fill `out` with `n` values, each drawn as rng_div(r, m) would draw them.
  */
-extern uint32_t state_i;
-extern uint32_t STATE[RAND_DEG];
-extern uint32_t z0;
-extern uint32_t z1;
-extern uint32_t z2;
+void rng_fill_div(struct rng *r, uint32_t m, uint32_t *out, int n);
 
+/**
+ * Sum `n` values, each drawn as rng_div(r, m) would draw them.
+ */
+uint32_t rng_sum_div(struct rng *r, uint32_t m, int n);
 
 /**
  * Initialise the RNG state with the given seed.